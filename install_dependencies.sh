@@ -31,7 +31,7 @@ sudo apt install -y libglm-dev libassimp-dev
 
 # Install development tools
 echo "Installing development tools..."
-sudo apt install -y gdb valgrind
+sudo apt install -y gdb valgrind libbenchmark-dev
 
 echo "Dependencies installation complete!"
 echo "You can now run ./build.sh to build the project"
\ No newline at end of file
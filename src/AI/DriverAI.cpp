@@ -0,0 +1,208 @@
+#include "DriverAI.h"
+#include "../Math/FastMath.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+DriverAI::Parameters::Parameters()
+    : lookaheadDistance(6.0f)
+    , lookaheadTime(0.5f)
+    , brakingLead(0.3f)
+    , speedGain(0.5f)
+    , pace(1.0f)
+    , avoidanceRange(25.0f)
+    , pathWidth(2.5f)
+    , avoidanceWidth(4.5f)
+    , followGap(6.0f)
+    , maxNeighbours(4) {
+}
+
+DriverAI::DriverAI()
+    : lastCarCount(0)
+    , ticks(0)
+    , totalTickMs(0.0)
+    , lastTickMs(0.0f)
+    , maxTickMs(0.0f) {
+}
+
+void DriverAI::update(const RacingLine& line, const std::vector<std::unique_ptr<Car>>& cars,
+                      const std::vector<RaceProgress>& progress, const Car* humanCar) {
+    if (line.empty()) return;
+
+    auto start = std::chrono::steady_clock::now();
+
+    gather(cars, progress, humanCar);
+    sortByDistance();
+    findBlockers(line.getTrackLength());
+    drive(line, 0, (int)positions.size());
+    apply(cars);
+
+    float tickMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    ticks++;
+    totalTickMs += tickMs;
+    lastTickMs = tickMs;
+    maxTickMs = std::max(maxTickMs, tickMs);
+}
+
+void DriverAI::reset() {
+    order.clear();
+    lastCarCount = 0;
+    ticks = 0;
+    totalTickMs = 0.0;
+    lastTickMs = 0.0f;
+    maxTickMs = 0.0f;
+}
+
+DriverAI::Stats DriverAI::getStats() const {
+    Stats stats;
+    stats.cars = lastCarCount;
+    stats.ticks = ticks;
+    stats.lastTickMs = lastTickMs;
+    stats.averageTickMs = ticks > 0 ? (float)(totalTickMs / ticks) : 0.0f;
+    stats.maxTickMs = maxTickMs;
+    return stats;
+}
+
+void DriverAI::gather(const std::vector<std::unique_ptr<Car>>& cars, const std::vector<RaceProgress>& progress,
+                      const Car* humanCar) {
+    size_t count = std::min(cars.size(), progress.size());
+    positions.resize(count);
+    forwards.resize(count);
+    rights.resize(count);
+    speeds.resize(count);
+    distances.resize(count);
+    maxSteerAngles.resize(count);
+    wheelbases.resize(count);
+    driven.resize(count);
+    blockers.resize(count);
+    blockerGaps.resize(count);
+    throttles.resize(count);
+    steers.resize(count);
+    brakes.resize(count);
+
+    lastCarCount = 0;
+    for (size_t i = 0; i < count; i++) {
+        const Car& car = *cars[i];
+        positions[i] = car.getPosition();
+        forwards[i] = car.getForward();
+        rights[i] = car.getRight();
+        speeds[i] = car.getVelocity().dot(forwards[i]);
+        distances[i] = progress[i].getDistanceAlongTrack();
+        maxSteerAngles[i] = car.getMaxSteerAngle() * 3.14159265f / 180.0f;
+        wheelbases[i] = car.getWheelbase();
+        driven[i] = &car != humanCar;
+        if (driven[i]) lastCarCount++;
+    }
+
+    // Cars were added or removed; the old order no longer applies
+    if (order.size() != count) {
+        order.resize(count);
+        for (size_t i = 0; i < count; i++) {
+            order[i] = (int)i;
+        }
+    }
+}
+
+void DriverAI::sortByDistance() {
+    for (size_t i = 1; i < order.size(); i++) {
+        int car = order[i];
+        size_t j = i;
+        while (j > 0 && distances[order[j - 1]] > distances[car]) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = car;
+    }
+}
+
+void DriverAI::findBlockers(float trackLength) {
+    int count = (int)order.size();
+    int neighbours = std::min(parameters.maxNeighbours, count - 1);
+
+    // Only the next few cars up the road can be in the way; wrap past the
+    // start line so the last car in the lap sees the first
+    for (int k = 0; k < count; k++) {
+        int car = order[k];
+        blockers[car] = -1;
+        blockerGaps[car] = 0.0f;
+        if (!driven[car]) continue;
+
+        for (int n = 1; n <= neighbours; n++) {
+            int other = order[(k + n) % count];
+            float gap = distances[other] - distances[car];
+            if (gap < 0.0f) gap += trackLength;
+            if (gap > parameters.avoidanceRange) break;
+
+            Vector3 offset = positions[other] - positions[car];
+            float ahead = offset.dot(forwards[car]);
+            float lateral = offset.dot(rights[car]);
+            if (ahead > 0.0f && std::fabs(lateral) < parameters.pathWidth) {
+                blockers[car] = other;
+                blockerGaps[car] = ahead;
+                break;
+            }
+        }
+    }
+}
+
+void DriverAI::drive(const RacingLine& line, int first, int count) {
+    for (int i = first; i < first + count; i++) {
+        if (!driven[i]) continue;
+
+        float speed = std::max(speeds[i], 0.0f);
+        RacingLine::Sample aim = line.sample(distances[i] + parameters.lookaheadDistance + speed * parameters.lookaheadTime);
+        Vector3 target = aim.position;
+        float targetSpeed = line.getTargetSpeed(distances[i] + speed * parameters.brakingLead) * parameters.pace;
+
+        int blocker = blockers[i];
+        if (blocker >= 0) {
+            // Pass on the side the line is already heading for, far enough
+            // out to clear the car in front but not off the road
+            float targetLateral = (target - positions[i]).dot(rights[i]);
+            float blockerLateral = (positions[blocker] - positions[i]).dot(rights[i]);
+            float shift;
+            if (targetLateral >= blockerLateral) {
+                shift = std::max(0.0f, blockerLateral + parameters.avoidanceWidth - targetLateral);
+            } else {
+                shift = std::min(0.0f, blockerLateral - parameters.avoidanceWidth - targetLateral);
+            }
+            float across = rights[i].dot(aim.normal) >= 0.0f ? 1.0f : -1.0f;
+            float offset = std::max(-aim.room, std::min(aim.room, aim.offset + shift * across));
+            target += aim.normal * (offset - aim.offset);
+
+            // Too close to get round yet: drop back to its speed
+            float room = blockerGaps[i] - parameters.followGap;
+            if (room < 0.0f) {
+                targetSpeed = std::min(targetSpeed, std::max(0.0f, speeds[blocker] + room));
+            }
+        }
+
+        // Pure pursuit: the arc through the target sets the steer angle
+        Vector3 toTarget = target - positions[i];
+        float ahead = toTarget.dot(forwards[i]);
+        float lateral = toTarget.dot(rights[i]);
+        float steerAngle;
+        if (ahead > 0.0f) {
+            float curvature = 2.0f * lateral / (ahead * ahead + lateral * lateral);
+            steerAngle = FastMath::atan(wheelbases[i] * curvature);
+        } else {
+            steerAngle = lateral >= 0.0f ? maxSteerAngles[i] : -maxSteerAngles[i];
+        }
+        steers[i] = std::max(-1.0f, std::min(1.0f, steerAngle / maxSteerAngles[i]));
+
+        float error = targetSpeed - speeds[i];
+        throttles[i] = std::max(0.0f, std::min(1.0f, error * parameters.speedGain));
+        brakes[i] = std::max(0.0f, std::min(1.0f, -error * parameters.speedGain));
+    }
+}
+
+void DriverAI::apply(const std::vector<std::unique_ptr<Car>>& cars) const {
+    for (size_t i = 0; i < driven.size(); i++) {
+        if (!driven[i]) continue;
+
+        Car& car = *cars[i];
+        car.setThrottle(throttles[i]);
+        car.setSteer(steers[i]);
+        car.setBrake(brakes[i]);
+    }
+}
@@ -0,0 +1,99 @@
+#pragma once
+#include "../Math/Vector3.h"
+#include "../Physics/Car.h"
+#include "../World/RaceProgress.h"
+#include "../World/RacingLine.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Drives every AI car in racing mode as one batch per tick.
+// Car state is gathered into flat per-car arrays, neighbours come from a
+// sweep over cars sorted by track distance, and each car's inputs are then
+// computed independently of the others (no shared writes, so the batch can
+// be split across threads as it stands). Results go back through the same
+// setThrottle/setSteer/setBrake calls the player's input uses.
+//
+// Steering is pure pursuit of a point on the racing line a speed-scaled
+// distance ahead; throttle and brake chase the line's target speed, read
+// slightly ahead to cover the car's response.
+class DriverAI {
+public:
+    struct Parameters {
+        float lookaheadDistance;  // Steering target distance at standstill
+        float lookaheadTime;      // Added lookahead per m/s of speed
+        float brakingLead;        // Seconds ahead to read the target speed
+        float speedGain;          // Throttle or brake per m/s of speed error
+        float pace;               // Fraction of the racing line's target speed
+        float avoidanceRange;     // How far ahead along the track to look for cars
+        float pathWidth;          // Lateral offset within which a car ahead is in the way
+        float avoidanceWidth;     // Lateral gap to keep when passing
+        float followGap;          // Distance kept behind a car that can't be passed
+        int maxNeighbours;        // Cars checked ahead of each car
+
+        Parameters();
+    };
+
+    struct Stats {
+        int cars;             // Driven last tick
+        int ticks;
+        float lastTickMs;
+        float averageTickMs;
+        float maxTickMs;
+    };
+
+private:
+    Parameters parameters;
+
+    // Per-car batch state, indexed like the car list
+    std::vector<Vector3> positions;
+    std::vector<Vector3> forwards;
+    std::vector<Vector3> rights;
+    std::vector<float> speeds;        // Along the car's heading
+    std::vector<float> distances;     // Along the track, from the start line
+    std::vector<float> maxSteerAngles;
+    std::vector<float> wheelbases;
+    std::vector<uint8_t> driven;
+
+    // Nearest car in the way, from the proximity sweep
+    std::vector<int> blockers;
+    std::vector<float> blockerGaps;
+
+    // Outputs
+    std::vector<float> throttles;
+    std::vector<float> steers;
+    std::vector<float> brakes;
+
+    // Cars by track distance. Seeded with last tick's order, which barely
+    // changes, so the insertion sort is effectively linear.
+    std::vector<int> order;
+
+    int lastCarCount;
+    int ticks;
+    double totalTickMs;
+    float lastTickMs;
+    float maxTickMs;
+
+public:
+    DriverAI();
+
+    void setParameters(const Parameters& newParameters) { parameters = newParameters; }
+    const Parameters& getParameters() const { return parameters; }
+    void setPace(float pace) { parameters.pace = pace; }
+
+    // Drives every car except 'humanCar', which is still avoided.
+    // 'progress' is indexed like 'cars'.
+    void update(const RacingLine& line, const std::vector<std::unique_ptr<Car>>& cars,
+                const std::vector<RaceProgress>& progress, const Car* humanCar);
+    void reset();
+
+    Stats getStats() const;
+
+private:
+    void gather(const std::vector<std::unique_ptr<Car>>& cars, const std::vector<RaceProgress>& progress,
+                const Car* humanCar);
+    void sortByDistance();
+    void findBlockers(float trackLength);
+    void drive(const RacingLine& line, int first, int count);
+    void apply(const std::vector<std::unique_ptr<Car>>& cars) const;
+};
@@ -149,6 +149,13 @@ void Camera::rotate(float yawDelta, float pitchDelta) {
     updateVectors();
 }
 
+void Camera::shiftOrigin(const Vector3& shift) {
+    // Orientation is unchanged, so the basis vectors stay as they are
+    position -= shift;
+    target -= shift;
+    followTarget -= shift;
+}
+
 void Camera::lookAt(const Vector3& targetPos) {
     target = targetPos;
     updateVectors();
@@ -304,7 +311,8 @@ Vector3 Camera::screenToWorld(const Vector3& screenPos, float screenWidth, float
     Vector3 eyeCoords = projInverse * clipCoords;
     
     // Convert to world coordinates
-    Matrix4 viewInverse = getViewMatrix().inverse();
+    // The view is rotation plus translation, so its inverse is cheap
+    Matrix4 viewInverse = getViewMatrix().inverseRigid();
     return viewInverse * eyeCoords;
 }
 
@@ -88,6 +88,7 @@ public:
     void moveUp(float distance);
     void rotate(float yawDelta, float pitchDelta);
     void lookAt(const Vector3& target);
+    void shiftOrigin(const Vector3& shift);  // Floating origin: moves by -shift
     
     // Third person specific
     void updateThirdPerson(const Vector3& targetPosition, const Vector3& targetForward, float deltaTime);
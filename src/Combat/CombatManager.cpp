@@ -8,6 +8,9 @@
 CombatManager::CombatManager()
     : respawnTime(3.0f)
     , friendlyFire(false)
+    , teamMode(TeamMode::TwoTeams)
+    , teamCount(2)
+    , nextTeam(0)
     , maxPlayers(8)
     , matchDuration(600.0f)  // 10 minutes
     , currentMatchTime(0.0f)
@@ -21,10 +24,10 @@ CombatManager::CombatManager()
     addSpawnPoint(Vector3(-20, 0, -20));
     
     // Setup power-up spawn points
-    powerUps.push_back({Vector3(10, 1, 10), PowerUp::Health, true, 0});
-    powerUps.push_back({Vector3(-10, 1, 10), PowerUp::Shield, true, 0});
-    powerUps.push_back({Vector3(10, 1, -10), PowerUp::Damage, true, 0});
-    powerUps.push_back({Vector3(-10, 1, -10), PowerUp::Speed, true, 0});
+    powerUps.push_back({Vector3(10, 1, 10), PowerUp::Health, true, TimerWheel::InvalidTimer});
+    powerUps.push_back({Vector3(-10, 1, 10), PowerUp::Shield, true, TimerWheel::InvalidTimer});
+    powerUps.push_back({Vector3(10, 1, -10), PowerUp::Damage, true, TimerWheel::InvalidTimer});
+    powerUps.push_back({Vector3(-10, 1, -10), PowerUp::Speed, true, TimerWheel::InvalidTimer});
 }
 
 CombatManager::~CombatManager() {
@@ -34,12 +37,18 @@ CombatManager::~CombatManager() {
 Player* CombatManager::addPlayer(const std::string& name) {
     if (players.size() >= maxPlayers) return nullptr;
     
-    int playerId = players.size();
+    int playerId = static_cast<int>(players.nextHandle());
     Vector3 spawnPoint = getRandomSpawnPoint();
     
     auto player = std::make_unique<Player>(playerId, name, spawnPoint);
     Player* playerPtr = player.get();
-    players.push_back(std::move(player));
+    playerPtr->setTimerWheel(&timers);
+    players.insert(std::move(player));
+    
+    // Round-robin team assignment
+    assignTeam(playerPtr, nextTeam);
+    nextTeam = (nextTeam + 1) % teamCount;
+    buildProximityScan();
     
     // Initialize stats for this player
     playerStats[playerId] = CombatStats();
@@ -50,24 +59,30 @@ Player* CombatManager::addPlayer(const std::string& name) {
 }
 
 void CombatManager::removePlayer(int playerId) {
-    auto it = std::find_if(players.begin(), players.end(),
-        [playerId](const std::unique_ptr<Player>& p) {
-            return p->getPlayerId() == playerId;
-        });
+    Player* player = getPlayer(playerId);
+    if (!player) return;
     
-    if (it != players.end()) {
-        std::cout << "Player " << (*it)->getPlayerName() << " left the game!" << std::endl;
-        players.erase(it);
+    std::cout << "Player " << player->getPlayerName() << " left the game!" << std::endl;
+    
+    auto timer = respawnTimers.find(playerId);
+    if (timer != respawnTimers.end()) {
+        timers.cancel(timer->second);
+        respawnTimers.erase(timer);
     }
+    playerStats.erase(playerId);
+    
+    players.remove(static_cast<PlayerMap::Handle>(playerId));
+    buildProximityScan();
 }
 
 Player* CombatManager::getPlayer(int playerId) {
-    for (auto& player : players) {
-        if (player->getPlayerId() == playerId) {
-            return player.get();
-        }
-    }
-    return nullptr;
+    auto* player = players.get(static_cast<PlayerMap::Handle>(playerId));
+    return player ? player->get() : nullptr;
+}
+
+const Player* CombatManager::getPlayer(int playerId) const {
+    auto* player = players.get(static_cast<PlayerMap::Handle>(playerId));
+    return player ? player->get() : nullptr;
 }
 
 std::vector<Player*> CombatManager::getAllPlayers() {
@@ -91,29 +106,48 @@ std::vector<Player*> CombatManager::getAlivePlayers() {
 void CombatManager::update(float deltaTime) {
     currentMatchTime += deltaTime;
     
+    // Fire due respawns, power-ups, buff expiries and cooldowns
+    updateTimers(deltaTime);
+    
+    // Resolve projectile targets before projectiles move
+    updateProjectiles(deltaTime);
+    
     // Update all players
     for (auto& player : players) {
         player->update(deltaTime);
         
-        // Check for respawn
+        // Each dead player gets its own respawn timer
         if (!player->isAlive() && player->getCombatState() == Player::CombatState::Dead) {
-            // Simple auto-respawn after delay (could track individual timers)
-            static float respawnTimer = 0;
-            respawnTimer += deltaTime;
-            if (respawnTimer >= respawnTime) {
-                respawnPlayer(player.get());
-                respawnTimer = 0;
-            }
+            scheduleRespawn(player.get());
         }
     }
     
+    // Snapshot positions and teams once for this tick's proximity scans
+    buildProximityScan();
+    collectExplosions();
+    
     updateCombat(deltaTime);
-    updateProjectiles(deltaTime);
-    updatePowerUps(deltaTime);
     checkCollisions();
+    resolveDamage();
     processEvents();
 }
 
+void CombatManager::shiftOrigin(const Vector3& shift) {
+    // The proximity scan is rebuilt from the players every tick
+    for (auto& player : players) {
+        player->shiftOrigin(shift);
+    }
+    for (Vector3& point : spawnPoints) {
+        point -= shift;
+    }
+    for (PowerUp& powerUp : powerUps) {
+        powerUp.position -= shift;
+    }
+    for (CombatEvent& event : eventQueue) {
+        event.position -= shift;
+    }
+}
+
 void CombatManager::updateCombat(float deltaTime) {
     // Handle ongoing combat mechanics
     for (auto& player : players) {
@@ -132,18 +166,48 @@ void CombatManager::updateCombat(float deltaTime) {
 }
 
 void CombatManager::updateProjectiles(float deltaTime) {
-    // Projectiles are updated within each player
+    // Projectiles are moved within each player; here homing targets are
+    // resolved from their handles, so a removed target is simply lost
+    for (auto& player : players) {
+        for (auto& projectile : player->getProjectiles()) {
+            if (!projectile->isHomingProjectile()) continue;
+            
+            Player* target = getPlayer(projectile->getHomingTargetId());
+            if (target && target->isAlive()) {
+                projectile->setHomingTargetPosition(target->getPosition());
+            } else {
+                projectile->clearHomingTarget();
+            }
+        }
+    }
 }
 
-void CombatManager::updatePowerUps(float deltaTime) {
-    for (auto& powerUp : powerUps) {
-        if (!powerUp.active) {
-            powerUp.respawnTimer -= deltaTime;
-            if (powerUp.respawnTimer <= 0) {
+void CombatManager::updateTimers(float deltaTime) {
+    firedTimers.clear();
+    timers.advance(deltaTime, firedTimers);
+    
+    for (const auto& timer : firedTimers) {
+        switch (static_cast<CombatTimer>(timer.kind)) {
+            case CombatTimer::PlayerRespawn:
+                respawnTimers.erase(timer.target);
+                respawnPlayer(getPlayer(timer.target));
+                break;
+                
+            case CombatTimer::PowerUpRespawn: {
+                PowerUp& powerUp = powerUps[timer.target];
                 powerUp.active = true;
+                powerUp.respawnTimer = TimerWheel::InvalidTimer;
                 std::cout << "Power-up respawned at position (" 
                          << powerUp.position.x << ", " << powerUp.position.z << ")" << std::endl;
+                break;
             }
+                
+            default:
+                // Buff expiries and cooldowns belong to the player
+                if (Player* player = getPlayer(timer.target)) {
+                    player->onTimerExpired(static_cast<CombatTimer>(timer.kind), timer.id);
+                }
+                break;
         }
     }
 }
@@ -170,22 +234,19 @@ void CombatManager::checkMeleeCollisions() {
         if (!attacker->isAlive()) continue;
         if (attacker->getCombatState() != Player::CombatState::Attacking) continue;
         
-        // Check if any enemy is in melee range
-        for (auto& target : players) {
-            if (target.get() == attacker.get()) continue;
-            if (!target->isAlive()) continue;
-            if (!friendlyFire && target->getPlayerId() % 2 == attacker->getPlayerId() % 2) continue;  // Simple team check
+        // Hostile, living players in melee range; allies never reach the cone test
+        int hitCount = scanPlayersInRadius(attacker->getPosition(), 3.0f, attacker->getHostileMask());  // Fist range
+        for (int i = 0; i < hitCount; i++) {
+            Player* target = scan.players[scan.results[i]];
+            if (target == attacker.get()) continue;
             
-            float distance = calculateDistance(attacker->getPosition(), target->getPosition());
-            if (distance <= 3.0f) {  // Fist range
-                // Check if facing the target
-                Vector3 toTarget = (target->getPosition() - attacker->getPosition()).normalized();
-                float dot = attacker->getLookDirection().dot(toTarget);
-                
-                if (dot > 0.7f) {  // ~45 degree cone
-                    handlePlayerDamage(target.get(), 15.0f, attacker.get());
-                    recordProjectileHit(attacker->getPlayerId());
-                }
+            // Check if facing the target
+            Vector3 toTarget = (target->getPosition() - attacker->getPosition()).normalizedFast();
+            float dot = attacker->getLookDirection().dot(toTarget);
+            
+            if (dot > 0.7f) {  // ~45 degree cone
+                handlePlayerDamage(target, 15.0f, attacker.get());
+                recordProjectileHit(attacker->getPlayerId());
             }
         }
     }
@@ -255,32 +316,122 @@ void CombatManager::handleLaserAttack(Player* attacker, const Vector3& direction
 }
 
 void CombatManager::handleAreaAttack(Player* attacker, const Vector3& center, float radius, float damage) {
-    std::vector<Player*> targets = findPlayersInRadius(center, radius);
+    if (!attacker) return;
     
-    for (auto& target : targets) {
+    int hitCount = scanPlayersInRadius(center, radius, attacker->getHostileMask());
+    for (int i = 0; i < hitCount; i++) {
+        Player* target = scan.players[scan.results[i]];
         if (target == attacker) continue;
-        if (!friendlyFire && target->getPlayerId() % 2 == attacker->getPlayerId() % 2) continue;
         
         handlePlayerDamage(target, damage, attacker);
     }
 }
 
 void CombatManager::handlePlayerDamage(Player* victim, float damage, Player* attacker) {
-    if (!victim) return;
+    if (!victim || damage <= 0) return;
+    
+    damageBatch.hits.push_back({ victim->getPlayerId(), attacker ? attacker->getPlayerId() : -1, damage });
+}
+
+void CombatManager::collectExplosions() {
+    for (auto& player : players) {
+        auto& explosions = player->getPendingExplosions();
+        for (const auto& explosion : explosions) {
+            handleAreaAttack(player.get(), explosion.position, explosion.radius, explosion.damage);
+        }
+        explosions.clear();
+    }
+}
+
+void CombatManager::resolveDamage() {
+    DamageBatch& batch = damageBatch;
+    if (batch.hits.empty()) return;
     
-    victim->takeDamage(damage, attacker);
+    const int playerCount = static_cast<int>(players.size());
     
-    if (attacker) {
-        recordDamage(attacker->getPlayerId(), victim->getPlayerId(), damage);
+    // Counting sort by victim; hits on players who left this tick are dropped
+    batch.offsets.assign(playerCount + 1, 0);
+    batch.victimIndices.resize(batch.hits.size());
+    for (size_t i = 0; i < batch.hits.size(); i++) {
+        int index = players.indexOf(static_cast<PlayerMap::Handle>(batch.hits[i].victimId));
+        batch.victimIndices[i] = index;
+        if (index >= 0) {
+            batch.offsets[index + 1]++;
+        }
+    }
+    for (int i = 0; i < playerCount; i++) {
+        batch.offsets[i + 1] += batch.offsets[i];
     }
     
-    CombatEvent event;
-    event.type = CombatEvent::PlayerDamaged;
-    event.playerId = attacker ? attacker->getPlayerId() : -1;
-    event.targetId = victim->getPlayerId();
-    event.value = damage;
-    event.position = victim->getPosition();
-    pushEvent(event);
+    batch.sorted.resize(batch.offsets[playerCount]);
+    for (size_t i = 0; i < batch.hits.size(); i++) {
+        int index = batch.victimIndices[i];
+        if (index >= 0) {
+            // Stable, so each victim's hits keep the order they landed in
+            batch.sorted[batch.offsets[index]++] = batch.hits[i];
+        }
+    }
+    // Scatter advanced each offset to its bucket end; shift back to starts
+    for (int i = playerCount; i > 0; i--) {
+        batch.offsets[i] = batch.offsets[i - 1];
+    }
+    batch.offsets[0] = 0;
+    
+    batch.damageDealt.assign(playerCount, 0.0f);
+    eventQueue.reserve(eventQueue.size() + batch.sorted.size());
+    
+    for (int victimIndex = 0; victimIndex < playerCount; victimIndex++) {
+        int begin = batch.offsets[victimIndex];
+        int end = batch.offsets[victimIndex + 1];
+        if (begin == end) continue;
+        
+        Player* victim = players[victimIndex].get();
+        if (!victim->isAlive()) continue;
+        
+        // Shield and defense are linear up to depletion, so the summed hit
+        // resolves the same as applying each one; the last hit takes credit
+        float total = 0.0f;
+        for (int i = begin; i < end; i++) {
+            const DamageHit& hit = batch.sorted[i];
+            total += hit.damage;
+            
+            int attackerIndex = players.indexOf(static_cast<PlayerMap::Handle>(hit.attackerId));
+            if (attackerIndex >= 0) {
+                batch.damageDealt[attackerIndex] += hit.damage;
+            }
+        }
+        int lastAttackerId = batch.sorted[end - 1].attackerId;
+        Player* lastAttacker = getPlayer(lastAttackerId);
+        
+        victim->takeDamage(total, lastAttacker);
+        playerStats[victim->getPlayerId()].damageTaken += total;
+        
+        CombatEvent event;
+        event.type = CombatEvent::PlayerDamaged;
+        event.playerId = lastAttacker ? lastAttackerId : -1;
+        event.targetId = victim->getPlayerId();
+        event.value = total;
+        event.position = victim->getPosition();
+        eventQueue.push_back(event);
+        
+        if (!victim->isAlive()) {
+            if (lastAttacker) {
+                recordKill(lastAttackerId, victim->getPlayerId());
+            }
+            event.type = CombatEvent::PlayerKilled;
+            event.value = 0.0f;
+            eventQueue.push_back(event);
+        }
+    }
+    
+    // One stats lookup per attacker rather than per hit
+    for (int i = 0; i < playerCount; i++) {
+        if (batch.damageDealt[i] > 0.0f) {
+            playerStats[players[i]->getPlayerId()].damageDealt += batch.damageDealt[i];
+        }
+    }
+    
+    batch.hits.clear();
 }
 
 void CombatManager::handlePlayerDeath(Player* victim, Player* killer) {
@@ -303,6 +454,12 @@ void CombatManager::handlePlayerDeath(Player* victim, Player* killer) {
 void CombatManager::respawnPlayer(Player* player) {
     if (!player) return;
     
+    auto timer = respawnTimers.find(player->getPlayerId());
+    if (timer != respawnTimers.end()) {
+        timers.cancel(timer->second);
+        respawnTimers.erase(timer);
+    }
+    
     Vector3 spawnPoint = getBestSpawnPoint(player);
     player->respawn(spawnPoint);
     
@@ -313,6 +470,15 @@ void CombatManager::respawnPlayer(Player* player) {
     pushEvent(event);
 }
 
+void CombatManager::scheduleRespawn(Player* player) {
+    if (!player) return;
+    
+    TimerWheel::TimerId& timer = respawnTimers[player->getPlayerId()];
+    if (!timers.isPending(timer)) {
+        timer = timers.schedule(respawnTime, static_cast<uint8_t>(CombatTimer::PlayerRespawn), player->getPlayerId());
+    }
+}
+
 bool CombatManager::validateTeleportTarget(Player* player, const Vector3& target) {
     // Check if target is within bounds
     // Check for obstacles
@@ -341,18 +507,64 @@ void CombatManager::collectPowerUp(Player* player, PowerUp& powerUp) {
             break;
             
         case PowerUp::Damage:
-            player->applyBuff("Damage Boost", 30.0f, 10.0f, "strength");
+            player->applyBuff(Player::BuffType::DamageBoost, 30.0f, 10.0f, Player::StatType::Strength);
             std::cout << player->getPlayerName() << " collected damage power-up!" << std::endl;
             break;
             
         case PowerUp::Speed:
-            player->applyBuff("Speed Boost", 30.0f, 10.0f, "agility");
+            player->applyBuff(Player::BuffType::SpeedBoost, 30.0f, 10.0f, Player::StatType::Agility);
             std::cout << player->getPlayerName() << " collected speed power-up!" << std::endl;
             break;
     }
     
     powerUp.active = false;
-    powerUp.respawnTimer = 30.0f;  // 30 seconds respawn
+    powerUp.respawnTimer = timers.schedule(30.0f, static_cast<uint8_t>(CombatTimer::PowerUpRespawn),
+                                           static_cast<int>(&powerUp - powerUps.data()));  // 30 seconds respawn
+}
+
+void CombatManager::setFriendlyFire(bool enabled) {
+    friendlyFire = enabled;
+    
+    // Hostility masks depend on friendly fire
+    for (auto& player : players) {
+        assignTeam(player.get(), player->getTeamId());
+    }
+    buildProximityScan();
+}
+
+void CombatManager::setTeamMode(TeamMode mode, int teams) {
+    teamMode = mode;
+    switch (mode) {
+        case TeamMode::FreeForAll:
+            teamCount = 1;
+            break;
+        case TeamMode::TwoTeams:
+            teamCount = 2;
+            break;
+        case TeamMode::MultiTeam:
+            teamCount = std::clamp(teams, 2, MaxTeams);
+            break;
+    }
+    
+    // Redistribute existing players round-robin
+    nextTeam = 0;
+    for (auto& player : players) {
+        assignTeam(player.get(), nextTeam);
+        nextTeam = (nextTeam + 1) % teamCount;
+    }
+    buildProximityScan();
+}
+
+void CombatManager::assignTeam(Player* player, int team) {
+    if (!player) return;
+    
+    team = std::clamp(team, 0, teamCount - 1);
+    uint32_t allTeams = teamCount >= MaxTeams ? 0xFFFFFFFFu : (1u << teamCount) - 1;
+    uint32_t teamBit = 1u << team;
+    
+    // Free-for-all: one shared team that is hostile to itself
+    uint32_t hostile = (teamMode == TeamMode::FreeForAll || friendlyFire) ? allTeams : (allTeams & ~teamBit);
+    player->setTeam(team, teamBit, hostile);
 }
 
 void CombatManager::startMatch() {
@@ -485,34 +697,73 @@ bool CombatManager::isInRange(const Vector3& pos1, const Vector3& pos2, float ra
 Player* CombatManager::findNearestEnemy(Player* player, float maxRange) {
     if (!player) return nullptr;
     
-    Player* nearest = nullptr;
-    float minDistance = maxRange > 0 ? maxRange : std::numeric_limits<float>::max();
+    Vector3 origin = player->getPosition();
+    uint32_t hostileMask = player->getHostileMask();
+    float minDistanceSq = maxRange > 0 ? maxRange * maxRange : std::numeric_limits<float>::max();
+    int nearest = -1;
     
-    for (auto& other : players) {
-        if (other.get() == player || !other->isAlive()) continue;
-        if (!friendlyFire && other->getPlayerId() % 2 == player->getPlayerId() % 2) continue;
+    // Allies and the dead are rejected by the mask before any distance math
+    for (size_t i = 0; i < scan.players.size(); i++) {
+        if ((scan.teamMasks[i] & hostileMask) == 0 || scan.players[i] == player) continue;
         
-        float distance = calculateDistance(player->getPosition(), other->getPosition());
-        if (distance < minDistance) {
-            minDistance = distance;
-            nearest = other.get();
+        float dx = scan.x[i] - origin.x;
+        float dy = scan.y[i] - origin.y;
+        float dz = scan.z[i] - origin.z;
+        float distanceSq = dx * dx + dy * dy + dz * dz;
+        if (distanceSq < minDistanceSq) {
+            minDistanceSq = distanceSq;
+            nearest = static_cast<int>(i);
         }
     }
     
-    return nearest;
+    return nearest >= 0 ? scan.players[nearest] : nullptr;
 }
 
 std::vector<Player*> CombatManager::findPlayersInRadius(const Vector3& center, float radius) {
     std::vector<Player*> result;
     
-    for (auto& player : players) {
-        if (!player->isAlive()) continue;
-        
-        float distance = calculateDistance(center, player->getPosition());
-        if (distance <= radius) {
-            result.push_back(player.get());
-        }
+    int hitCount = scanPlayersInRadius(center, radius, 0xFFFFFFFFu);
+    for (int i = 0; i < hitCount; i++) {
+        result.push_back(scan.players[scan.results[i]]);
     }
     
     return result;
+}
+
+void CombatManager::buildProximityScan() {
+    size_t count = players.size();
+    scan.x.resize(count);
+    scan.y.resize(count);
+    scan.z.resize(count);
+    scan.teamMasks.resize(count);
+    scan.players.resize(count);
+    scan.results.resize(count);
+    
+    for (size_t i = 0; i < count; i++) {
+        Player* player = players[i].get();
+        Vector3 position = player->getPosition();
+        scan.x[i] = position.x;
+        scan.y[i] = position.y;
+        scan.z[i] = position.z;
+        scan.teamMasks[i] = player->isAlive() ? player->getTeamMask() : 0u;
+        scan.players[i] = player;
+    }
+}
+
+int CombatManager::scanPlayersInRadius(const Vector3& center, float radius, uint32_t hostileMask) {
+    float radiusSq = radius * radius;
+    int count = 0;
+    
+    // Branch-free filter + compaction so the loop vectorizes
+    size_t n = scan.players.size();
+    for (size_t i = 0; i < n; i++) {
+        float dx = scan.x[i] - center.x;
+        float dy = scan.y[i] - center.y;
+        float dz = scan.z[i] - center.z;
+        bool hit = ((scan.teamMasks[i] & hostileMask) != 0) & (dx * dx + dy * dy + dz * dz <= radiusSq);
+        scan.results[count] = static_cast<int>(i);
+        count += hit;
+    }
+    
+    return count;
 }
\ No newline at end of file
@@ -1,6 +1,9 @@
 #pragma once
 #include "../Math/Vector3.h"
 #include "Player.h"  // Include Player to access AttackType enum
+#include "CombatTimers.h"
+#include "../Utils/TimerWheel.h"
+#include "../Utils/SlotMap.h"
 #include <vector>
 #include <memory>
 #include <unordered_map>
@@ -29,6 +32,15 @@ public:
         Vector3 position;
     };
     
+    // Team layouts. Teams are bits in a 32-bit mask, so at most 32 teams;
+    // in free-for-all everyone shares one bit and is hostile to it.
+    enum class TeamMode {
+        FreeForAll,
+        TwoTeams,
+        MultiTeam
+    };
+    static constexpr int MaxTeams = 32;
+    
     struct CombatStats {
         int kills;
         int deaths;
@@ -43,14 +55,26 @@ public:
                        damageTaken(0), highestCombo(0), projectilesHit(0), projectilesFired(0) {}
     };
     
+    // Player IDs are generational slot map handles: stable, never reused
+    // while a stale copy could still resolve, and O(1) to look up
+    using PlayerMap = SlotMap<std::unique_ptr<Player>>;
+    
 private:
-    std::vector<std::unique_ptr<Player>> players;
+    PlayerMap players;
     std::unordered_map<int, CombatStats> playerStats;
     std::vector<CombatEvent> eventQueue;
     
+    // Scheduled timers (respawns, power-ups, player buffs and cooldowns)
+    TimerWheel timers;
+    std::vector<TimerWheel::FiredTimer> firedTimers;
+    std::unordered_map<int, TimerWheel::TimerId> respawnTimers;
+    
     // Combat settings
     float respawnTime;
     bool friendlyFire;
+    TeamMode teamMode;
+    int teamCount;
+    int nextTeam;
     int maxPlayers;
     float matchDuration;
     float currentMatchTime;
@@ -64,10 +88,38 @@ private:
         Vector3 position;
         enum Type { Health, Shield, Damage, Speed } type;
         bool active;
-        float respawnTimer;
+        TimerWheel::TimerId respawnTimer;
     };
     std::vector<PowerUp> powerUps;
     
+    // Per-tick structure-of-arrays snapshot of players for proximity scans.
+    // Dead players get a zero team mask, so one AND rejects both allies and
+    // the dead before any distance math.
+    struct ProximityScan {
+        std::vector<float> x, y, z;
+        std::vector<uint32_t> teamMasks;
+        std::vector<Player*> players;
+        std::vector<int> results;
+    };
+    ProximityScan scan;
+    
+    // Damage queued during the tick and resolved in one pass per victim.
+    // Hits are counting-sorted by the victim's dense index, so resolution is
+    // linear in hits + players however many blasts overlap.
+    struct DamageHit {
+        int victimId;
+        int attackerId;
+        float damage;
+    };
+    struct DamageBatch {
+        std::vector<DamageHit> hits;
+        std::vector<DamageHit> sorted;
+        std::vector<int> victimIndices;
+        std::vector<int> offsets;
+        std::vector<float> damageDealt;  // Per attacker dense index
+    };
+    DamageBatch damageBatch;
+    
 public:
     CombatManager();
     ~CombatManager();
@@ -76,15 +128,20 @@ public:
     Player* addPlayer(const std::string& name);
     void removePlayer(int playerId);
     Player* getPlayer(int playerId);
+    const Player* getPlayer(int playerId) const;
     std::vector<Player*> getAllPlayers();
     std::vector<Player*> getAlivePlayers();
     
     // Update
     void update(float deltaTime);
     void updateCombat(float deltaTime);
+    // Floating origin: moves players, their projectiles, spawn points,
+    // power-ups and queued events by -shift
+    void shiftOrigin(const Vector3& shift);
     void updateProjectiles(float deltaTime);
-    void updatePowerUps(float deltaTime);
+    void updateTimers(float deltaTime);
     void checkCollisions();
+    void resolveDamage();
     void processEvents();
     
     // Combat actions
@@ -92,9 +149,10 @@ public:
     void handleFistAttack(Player* attacker);
     void handleLaserAttack(Player* attacker, const Vector3& direction);
     void handleAreaAttack(Player* attacker, const Vector3& center, float radius, float damage);
-    void handlePlayerDamage(Player* victim, float damage, Player* attacker = nullptr);
+    void handlePlayerDamage(Player* victim, float damage, Player* attacker = nullptr);  // Queued until resolveDamage()
     void handlePlayerDeath(Player* victim, Player* killer = nullptr);
     void respawnPlayer(Player* player);
+    void scheduleRespawn(Player* player);
     
     // Teleportation
     bool validateTeleportTarget(Player* player, const Vector3& target);
@@ -125,7 +183,13 @@ public:
     
     // Settings
     void setRespawnTime(float time) { respawnTime = time; }
-    void setFriendlyFire(bool enabled) { friendlyFire = enabled; }
+    int getPendingTimerCount() const { return timers.getPendingCount(); }
+    size_t getPendingDamageCount() const { return damageBatch.hits.size(); }
+    void setFriendlyFire(bool enabled);
+    void setTeamMode(TeamMode mode, int teams = 2);
+    void assignTeam(Player* player, int team);
+    TeamMode getTeamMode() const { return teamMode; }
+    int getTeamCount() const { return teamCount; }
     void setMaxPlayers(int max) { maxPlayers = max; }
     void setMatchDuration(float duration) { matchDuration = duration; }
     
@@ -141,4 +205,7 @@ private:
     bool isInRange(const Vector3& pos1, const Vector3& pos2, float range);
     Player* findNearestEnemy(Player* player, float maxRange = -1.0f);
     std::vector<Player*> findPlayersInRadius(const Vector3& center, float radius);
+    void buildProximityScan();
+    void collectExplosions();
+    int scanPlayersInRadius(const Vector3& center, float radius, uint32_t hostileMask);
 };
\ No newline at end of file
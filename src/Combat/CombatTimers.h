@@ -0,0 +1,13 @@
+#pragma once
+#include <cstdint>
+
+// Timer kinds scheduled on the combat TimerWheel.
+// The wheel's target field holds the player ID, or the power-up index for
+// PowerUpRespawn.
+enum class CombatTimer : uint8_t {
+    PlayerRespawn,
+    PowerUpRespawn,
+    BuffExpiry,
+    ShieldCooldown,
+    TeleportCooldown
+};
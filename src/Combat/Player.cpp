@@ -1,34 +1,95 @@
 #include "Player.h"
 #include "Projectile.h"
 #include "Shield.h"
+#include "../Math/SimMath.h"
+#include "../Math/Quantize.h"
+#include "../World/WorldOrigin.h"
 #include <algorithm>
 #include <iostream>
 #include <cmath>
+#include <cstring>
+
+namespace {
+    // Snapshot fields are copied in native byte order
+    template <typename T>
+    void appendValue(std::vector<uint8_t>& buffer, const T& value) {
+        size_t offset = buffer.size();
+        buffer.resize(offset + sizeof(T));
+        std::memcpy(buffer.data() + offset, &value, sizeof(T));
+    }
+
+    template <typename T>
+    T readValue(const std::vector<uint8_t>& buffer, size_t& offset) {
+        T value;
+        std::memcpy(&value, buffer.data() + offset, sizeof(T));
+        offset += sizeof(T);
+        return value;
+    }
+
+    // 53 bytes: world position (doubles, players have no world bounds to
+    // quantize across), velocity and look direction as halves,
+    // smallest-three rotation, health, stamina, shield strength and state
+    const size_t SerializedStateSize = 3 * sizeof(double) + 2 * sizeof(Quantize::HalfVector3)
+                                     + sizeof(Quantize::PackedQuaternion) + 3 * sizeof(float) + sizeof(uint8_t);
+}
 
 // Stats implementation
 Player::Stats::Stats() 
-    : strength(10.0f)
-    , defense(10.0f)
-    , stamina(10.0f)
-    , agility(10.0f)
-    , maxHealth(100.0f)
+    : maxHealth(100.0f)
     , currentHealth(100.0f)
     , maxStamina(100.0f)
     , currentStamina(100.0f)
     , healthRegen(1.0f)
     , staminaRegen(5.0f)
+    , strength(10.0f)
+    , defense(10.0f)
+    , stamina(10.0f)
+    , agility(10.0f)
+    , dirty(true)
     , level(1)
     , experience(0)
     , experienceToNextLevel(100)
     , statPoints(0) {
+    for (int i = 0; i < StatCount; i++) {
+        baseStats[i] = 10.0f;
+        statModifiers[i] = 0.0f;
+    }
     recalculateDerivedStats();
 }
 
 void Player::Stats::recalculateDerivedStats() {
+    strength = getStat(StatType::Strength);
+    defense = getStat(StatType::Defense);
+    stamina = getStat(StatType::Stamina);
+    agility = getStat(StatType::Agility);
+    
     maxHealth = 100.0f + (defense * 10.0f);
     maxStamina = 100.0f + (stamina * 5.0f);
     healthRegen = 1.0f + (defense * 0.2f);
     staminaRegen = 5.0f + (stamina * 0.5f) + (agility * 0.3f);
+    
+    dirty = false;
+}
+
+void Player::Stats::refreshDerivedStats() {
+    if (dirty) {
+        recalculateDerivedStats();
+    }
+}
+
+void Player::Stats::addBaseStat(StatType stat, float amount) {
+    baseStats[static_cast<int>(stat)] += amount;
+    dirty = true;
+}
+
+void Player::Stats::addModifier(StatType stat, float amount) {
+    statModifiers[static_cast<int>(stat)] += amount;
+    dirty = true;
+}
+
+float Player::Stats::getStat(StatType stat) const {
+    int index = static_cast<int>(stat);
+    return baseStats[index] + statModifiers[index];
 }
 
 void Player::Stats::levelUp() {
@@ -41,32 +102,19 @@ void Player::Stats::levelUp() {
     currentStamina = maxStamina;
 }
 
-void Player::Stats::applyStatPoint(const std::string& statName) {
-    if (statPoints <= 0) return;
+void Player::Stats::applyStatPoint(StatType stat) {
+    if (statPoints <= 0 || stat >= StatType::Count) return;
     
-    if (statName == "strength") {
-        strength += 1.0f;
-        statPoints--;
-    } else if (statName == "defense") {
-        defense += 1.0f;
-        statPoints--;
-    } else if (statName == "stamina") {
-        stamina += 1.0f;
-        statPoints--;
-    } else if (statName == "agility") {
-        agility += 1.0f;
-        statPoints--;
-    }
+    addBaseStat(stat, 1.0f);
+    statPoints--;
     
+    // Stat menu reads the result immediately
     recalculateDerivedStats();
 }
 
 // Player implementation
 Player::Player(int id, const std::string& name, const Vector3& startPos)
-    : playerId(id)
-    , playerName(name)
-    , isLocalPlayer(false)
-    , position(startPos)
+    : position(startPos)
     , velocity(Vector3::zero())
     , rotation(Quaternion::identity())
     , lookDirection(Vector3::forward())
@@ -78,10 +126,21 @@ Player::Player(int id, const std::string& name, const Vector3& startPos)
     , stateTimer(0.0f)
     , lastAttackTime(0.0f)
     , lastDamageTime(0.0f)
-    , teleportCooldown(0.0f)
-    , teleportRange(20.0f)
-    , isTeleporting(false)
     , teleportProgress(0.0f)
+    , comboTimer(0.0f)
+    , damageFlashTimer(0.0f)
+    , healFlashTimer(0.0f)
+    , teamMask(1u)
+    , hostileMask(0xFFFFFFFFu)
+    , isTeleporting(false)
+    , isShielding(false)
+    , playerId(id)
+    , teamId(0)
+    , playerName(name)
+    , isLocalPlayer(false)
+    , timerWheel(nullptr)
+    , teleportCooldownTimer(TimerWheel::InvalidTimer)
+    , teleportRange(20.0f)
     , fistDamage(15.0f)
     , fistRange(3.0f)
     , fistCooldown(0.5f)
@@ -92,28 +151,45 @@ Player::Player(int id, const std::string& name, const Vector3& startPos)
     , shieldStrength(50.0f)
     , shieldMaxStrength(50.0f)
     , shieldRegenRate(5.0f)
-    , shieldCooldown(0.0f)
-    , isShielding(false)
+    , shieldCooldownTimer(TimerWheel::InvalidTimer)
     , color(Vector3(0.2f, 0.5f, 1.0f))
-    , damageFlashTimer(0.0f)
-    , healFlashTimer(0.0f)
-    , comboTimer(0.0f)
-    , comboMultiplier(1) {
+    , comboMultiplier(1)
+    , activeBuffCount(0) {
     
     // Create shield component
     shield = std::make_unique<Shield>(this, shieldMaxStrength);
 }
 
 Player::~Player() {
+    // Don't leave timers firing for a player that no longer exists
+    if (timerWheel && !ownTimerWheel) {
+        for (int i = 0; i < activeBuffCount; i++) {
+            timerWheel->cancel(activeBuffs[i].expiryTimer);
+        }
+        timerWheel->cancel(teleportCooldownTimer);
+        timerWheel->cancel(shieldCooldownTimer);
+    }
+    
     activeProjectiles.clear();
 }
 
 void Player::update(float deltaTime) {
+    // Apply buff/stat changes made since last tick in one recalculation
+    stats.refreshDerivedStats();
+    
+    // A player not attached to a shared wheel drives its own timers
+    if (ownTimerWheel) {
+        firedTimers.clear();
+        ownTimerWheel->advance(deltaTime, firedTimers);
+        for (const auto& timer : firedTimers) {
+            onTimerExpired(static_cast<CombatTimer>(timer.kind), timer.id);
+        }
+    }
+    
     updateCombat(deltaTime);
     // Movement is now updated externally with camera info
     updateStats(deltaTime);
     updateProjectiles(deltaTime);
-    updateBuffs(deltaTime);
     updateVisualEffects(deltaTime);
     updateCooldowns(deltaTime);
     checkComboTimeout(deltaTime);
@@ -174,8 +250,7 @@ void Player::updateMovement(float deltaTime, const Vector3& inputDirection, cons
         teleportProgress = std::min(1.0f, teleportProgress);
         
         // Interpolate position
-        Vector3 startPos = position;
-        position = startPos + (teleportTarget - startPos) * teleportProgress;
+        position = Vector3::lerpUnclamped(position, teleportTarget, teleportProgress);
     } else if (currentState != CombatState::Stunned && currentState != CombatState::Dead) {
         // Calculate movement direction relative to camera
         Vector3 forward = cameraForward;
@@ -193,18 +268,18 @@ void Player::updateMovement(float deltaTime, const Vector3& inputDirection, cons
             moveDirection = moveDirection.normalized();
             
             // Smooth rotation toward movement direction
-            lookDirection = lookDirection + (moveDirection - lookDirection) * rotationSpeed * deltaTime;
+            lookDirection = Vector3::lerpUnclamped(lookDirection, moveDirection, rotationSpeed * deltaTime);
             lookDirection = lookDirection.normalized();
             
             // Update rotation quaternion to face movement direction
-            float angle = std::atan2(lookDirection.x, lookDirection.z);
+            float angle = SimMath::atan2(lookDirection.x, lookDirection.z);
             rotation = Quaternion::fromAxisAngle(Vector3::up(), angle);
         }
         
         // Apply movement with speed modifier based on agility
         float speedModifier = 1.0f + (stats.agility * 0.02f);  // 2% speed per agility point
         velocity = moveDirection * moveSpeed * speedModifier;
-        position = position + velocity * deltaTime;
+        position = Vector3::madd(position, velocity, deltaTime);
     }
 }
 
@@ -229,6 +304,9 @@ void Player::updateProjectiles(float deltaTime) {
         (*it)->update(deltaTime);
         
         if (!(*it)->isActive()) {
+            if ((*it)->hasExploded()) {
+                pendingExplosions.push_back({ (*it)->getPosition(), (*it)->getAreaRadius(), (*it)->getAreaDamage() });
+            }
             it = activeProjectiles.erase(it);
         } else {
             ++it;
@@ -236,17 +314,61 @@ void Player::updateProjectiles(float deltaTime) {
     }
 }
 
-void Player::updateBuffs(float deltaTime) {
-    for (auto it = activeBuffs.begin(); it != activeBuffs.end();) {
-        it->duration -= deltaTime;
-        
-        if (it->duration <= 0) {
-            // Remove expired buff
-            it = activeBuffs.erase(it);
-            stats.recalculateDerivedStats();
-        } else {
-            ++it;
+void Player::setTimerWheel(TimerWheel* wheel) {
+    if (!wheel || wheel == timerWheel) return;
+    
+    // Move pending buff expiries and cooldowns onto the new wheel
+    TimerWheel* oldWheel = timerWheel;
+    auto migrate = [&](TimerWheel::TimerId& id, CombatTimer kind) {
+        // An ID from the old wheel means nothing on the new one
+        if (!oldWheel || !oldWheel->isPending(id)) {
+            id = TimerWheel::InvalidTimer;
+            return;
         }
+        float remaining = oldWheel->getRemaining(id);
+        oldWheel->cancel(id);
+        id = wheel->schedule(remaining, static_cast<uint8_t>(kind), playerId);
+    };
+    
+    for (int i = 0; i < activeBuffCount; i++) {
+        migrate(activeBuffs[i].expiryTimer, CombatTimer::BuffExpiry);
+    }
+    migrate(teleportCooldownTimer, CombatTimer::TeleportCooldown);
+    migrate(shieldCooldownTimer, CombatTimer::ShieldCooldown);
+    
+    timerWheel = wheel;
+    ownTimerWheel.reset();
+}
+
+void Player::onTimerExpired(CombatTimer kind, TimerWheel::TimerId id) {
+    switch (kind) {
+        case CombatTimer::BuffExpiry:
+            for (int i = 0; i < activeBuffCount; i++) {
+                if (activeBuffs[i].expiryTimer == id) {
+                    // Already fired, nothing left to cancel. Marks stats
+                    // dirty, recalculated next tick.
+                    activeBuffs[i].expiryTimer = TimerWheel::InvalidTimer;
+                    removeBuffAt(i);
+                    break;
+                }
+            }
+            break;
+            
+        // Cooldowns need no action beyond forgetting the fired ID
+        case CombatTimer::ShieldCooldown:
+            if (shieldCooldownTimer == id) {
+                shieldCooldownTimer = TimerWheel::InvalidTimer;
+            }
+            break;
+            
+        case CombatTimer::TeleportCooldown:
+            if (teleportCooldownTimer == id) {
+                teleportCooldownTimer = TimerWheel::InvalidTimer;
+            }
+            break;
+            
+        default:
+            break;
     }
 }
 
@@ -254,15 +376,13 @@ void Player::updateVisualEffects(float deltaTime) {
     if (damageFlashTimer > 0) {
         damageFlashTimer -= deltaTime;
         // Flash red when taking damage
-        color = Vector3(1.0f, 0.2f, 0.2f) * (damageFlashTimer / 0.3f) + 
-                Vector3(0.2f, 0.5f, 1.0f) * (1.0f - damageFlashTimer / 0.3f);
+        color = Vector3::lerpUnclamped(Vector3(0.2f, 0.5f, 1.0f), Vector3(1.0f, 0.2f, 0.2f), damageFlashTimer / 0.3f);
     }
     
     if (healFlashTimer > 0) {
         healFlashTimer -= deltaTime;
         // Flash green when healing
-        color = Vector3(0.2f, 1.0f, 0.2f) * (healFlashTimer / 0.3f) + 
-                Vector3(0.2f, 0.5f, 1.0f) * (1.0f - healFlashTimer / 0.3f);
+        color = Vector3::lerpUnclamped(Vector3(0.2f, 0.5f, 1.0f), Vector3(0.2f, 1.0f, 0.2f), healFlashTimer / 0.3f);
     }
 }
 
@@ -306,7 +426,7 @@ void Player::fireLaser(const Vector3& direction) {
         direction.normalized() * laserSpeed,
         calculateDamage(laserDamage),
         laserRange,
-        this
+        playerId
     );
     activeProjectiles.push_back(std::move(projectile));
     
@@ -314,7 +434,7 @@ void Player::fireLaser(const Vector3& direction) {
 }
 
 void Player::activateShield() {
-    if (isShielding || shieldCooldown > 0 || !hasStamina(20.0f)) return;
+    if (isShielding || isTimerPending(shieldCooldownTimer) || !hasStamina(20.0f)) return;
     
     isShielding = true;
     currentState = CombatState::Defending;
@@ -333,7 +453,10 @@ void Player::deactivateShield() {
     
     isShielding = false;
     currentState = CombatState::Idle;
-    shieldCooldown = 3.0f;  // 3 second cooldown
+    
+    // 3 second cooldown
+    getTimerWheel().cancel(shieldCooldownTimer);
+    shieldCooldownTimer = getTimerWheel().schedule(3.0f, static_cast<uint8_t>(CombatTimer::ShieldCooldown), playerId);
     
     if (shield) {
         shield->deactivate();
@@ -345,19 +468,16 @@ void Player::deactivateShield() {
 void Player::teleport(const Vector3& target) {
     if (!canTeleport() || !hasStamina(30.0f)) return;
     
-    Vector3 direction = target - position;
-    float distance = direction.magnitude();
-    
-    if (distance > teleportRange) {
-        // Limit to max range
-        direction = direction.normalized() * teleportRange;
-    }
-    
+    // Limit to max range
+    Vector3 direction = (target - position).clampedLength(teleportRange);
     teleportTarget = position + direction;
     currentState = CombatState::Teleporting;
     isTeleporting = true;
     teleportProgress = 0.0f;
-    teleportCooldown = 5.0f;  // 5 second cooldown
+    
+    // 5 second cooldown
+    getTimerWheel().cancel(teleportCooldownTimer);
+    teleportCooldownTimer = getTimerWheel().schedule(5.0f, static_cast<uint8_t>(CombatTimer::TeleportCooldown), playerId);
     
     consumeStamina(30.0f);
     
@@ -445,8 +565,10 @@ void Player::respawn(const Vector3& respawnPoint) {
     clearBuffs();
     
     // Reset cooldowns
-    teleportCooldown = 0;
-    shieldCooldown = 0;
+    getTimerWheel().cancel(teleportCooldownTimer);
+    getTimerWheel().cancel(shieldCooldownTimer);
+    teleportCooldownTimer = TimerWheel::InvalidTimer;
+    shieldCooldownTimer = TimerWheel::InvalidTimer;
     lastAttackTime = 0;
     
     std::cout << playerName << " respawns!" << std::endl;
@@ -471,85 +593,80 @@ void Player::levelUp() {
 }
 
 void Player::increaseStrength(float amount) {
-    stats.strength += amount;
+    stats.addBaseStat(StatType::Strength, amount);
     stats.recalculateDerivedStats();
 }
 
 void Player::increaseDefense(float amount) {
-    stats.defense += amount;
+    stats.addBaseStat(StatType::Defense, amount);
     stats.recalculateDerivedStats();
 }
 
 void Player::increaseStamina(float amount) {
-    stats.stamina += amount;
+    stats.addBaseStat(StatType::Stamina, amount);
     stats.recalculateDerivedStats();
 }
 
 void Player::increaseAgility(float amount) {
-    stats.agility += amount;
+    stats.addBaseStat(StatType::Agility, amount);
     stats.recalculateDerivedStats();
 }
 
 void Player::resetStats() {
+    for (int i = 0; i < activeBuffCount; i++) {
+        getTimerWheel().cancel(activeBuffs[i].expiryTimer);
+    }
+    activeBuffCount = 0;
     stats = Stats();
 }
 
-void Player::applyBuff(const std::string& buffName, float duration, float modifier, const std::string& stat) {
-    Buff buff = { buffName, duration, modifier, stat };
-    activeBuffs.push_back(buff);
+void Player::applyBuff(BuffType type, float duration, float modifier, StatType stat) {
+    if (stat >= StatType::Count) return;
+    
+    TimerWheel& timers = getTimerWheel();
     
-    // Apply buff effect
-    if (stat == "strength") {
-        stats.strength += modifier;
-    } else if (stat == "defense") {
-        stats.defense += modifier;
-    } else if (stat == "stamina") {
-        stats.stamina += modifier;
-    } else if (stat == "agility") {
-        stats.agility += modifier;
+    // When full, replace the buff closest to expiring
+    if (activeBuffCount >= MaxBuffs) {
+        int shortest = 0;
+        for (int i = 1; i < activeBuffCount; i++) {
+            if (timers.getRemaining(activeBuffs[i].expiryTimer) <
+                timers.getRemaining(activeBuffs[shortest].expiryTimer)) {
+                shortest = i;
+            }
+        }
+        removeBuffAt(shortest);
     }
     
-    stats.recalculateDerivedStats();
+    TimerWheel::TimerId expiry = timers.schedule(duration, static_cast<uint8_t>(CombatTimer::BuffExpiry), playerId);
+    activeBuffs[activeBuffCount++] = { type, stat, modifier, expiry };
+    stats.addModifier(stat, modifier);
 }
 
-void Player::removeBuff(const std::string& buffName) {
-    for (auto it = activeBuffs.begin(); it != activeBuffs.end();) {
-        if (it->name == buffName) {
-            // Remove buff effect
-            if (it->affectedStat == "strength") {
-                stats.strength -= it->statModifier;
-            } else if (it->affectedStat == "defense") {
-                stats.defense -= it->statModifier;
-            } else if (it->affectedStat == "stamina") {
-                stats.stamina -= it->statModifier;
-            } else if (it->affectedStat == "agility") {
-                stats.agility -= it->statModifier;
-            }
-            
-            it = activeBuffs.erase(it);
+void Player::removeBuff(BuffType type) {
+    for (int i = 0; i < activeBuffCount;) {
+        if (activeBuffs[i].type == type) {
+            removeBuffAt(i);
         } else {
-            ++it;
+            i++;
         }
     }
-    
-    stats.recalculateDerivedStats();
 }
 
 void Player::clearBuffs() {
-    for (const auto& buff : activeBuffs) {
-        if (buff.affectedStat == "strength") {
-            stats.strength -= buff.statModifier;
-        } else if (buff.affectedStat == "defense") {
-            stats.defense -= buff.statModifier;
-        } else if (buff.affectedStat == "stamina") {
-            stats.stamina -= buff.statModifier;
-        } else if (buff.affectedStat == "agility") {
-            stats.agility -= buff.statModifier;
-        }
+    for (int i = 0; i < activeBuffCount; i++) {
+        stats.addModifier(activeBuffs[i].affectedStat, -activeBuffs[i].statModifier);
+        getTimerWheel().cancel(activeBuffs[i].expiryTimer);
     }
     
-    activeBuffs.clear();
-    stats.recalculateDerivedStats();
+    activeBuffCount = 0;
+}
+
+void Player::removeBuffAt(int index) {
+    stats.addModifier(activeBuffs[index].affectedStat, -activeBuffs[index].statModifier);
+    getTimerWheel().cancel(activeBuffs[index].expiryTimer);
+    
+    // Swap-remove, buff order is not significant
+    activeBuffs[index] = activeBuffs[--activeBuffCount];
 }
 
 bool Player::canAttack() const {
@@ -560,14 +677,31 @@ bool Player::canAttack() const {
 
 bool Player::canTeleport() const {
     return currentState == CombatState::Idle &&
-           teleportCooldown <= 0 &&
+           !isTimerPending(teleportCooldownTimer) &&
            stats.currentHealth > 0;
 }
 
+void Player::setTeam(int team, uint32_t teamBits, uint32_t hostileBits) {
+    teamId = team;
+    teamMask = teamBits;
+    hostileMask = hostileBits;
+}
+
 void Player::setPosition(const Vector3& pos) {
     position = pos;
 }
 
+void Player::shiftOrigin(const Vector3& shift) {
+    position -= shift;
+    teleportTarget -= shift;
+    for (Explosion& explosion : pendingExplosions) {
+        explosion.position -= shift;
+    }
+    for (auto& projectile : activeProjectiles) {
+        projectile->shiftOrigin(shift);
+    }
+}
+
 void Player::setVelocity(const Vector3& vel) {
     velocity = vel;
 }
@@ -595,6 +729,42 @@ Vector3 Player::getBoundingBoxMax() const {
     return position + Vector3(0.5f, 2.0f, 0.5f);  // Player is ~2 units tall
 }
 
+void Player::serializeState(std::vector<uint8_t>& buffer, const WorldOrigin& origin) const {
+    buffer.reserve(buffer.size() + SerializedStateSize);
+    WorldPosition worldPosition = origin.toWorld(position);
+    appendValue(buffer, worldPosition.x);
+    appendValue(buffer, worldPosition.y);
+    appendValue(buffer, worldPosition.z);
+    appendValue(buffer, Quantize::HalfVector3::encode(velocity));
+    appendValue(buffer, Quantize::HalfVector3::encode(lookDirection));
+    appendValue(buffer, Quantize::PackedQuaternion::encode(rotation));
+    appendValue(buffer, stats.currentHealth);
+    appendValue(buffer, stats.currentStamina);
+    appendValue(buffer, shieldStrength);
+    appendValue(buffer, static_cast<uint8_t>(currentState));
+}
+
+void Player::deserializeState(const std::vector<uint8_t>& buffer, const WorldOrigin& origin) {
+    if (buffer.size() < SerializedStateSize) {
+        std::cout << "Player " << playerId << ": state snapshot too short (" << buffer.size() << " bytes)" << std::endl;
+        return;
+    }
+
+    size_t offset = 0;
+    WorldPosition worldPosition;
+    worldPosition.x = readValue<double>(buffer, offset);
+    worldPosition.y = readValue<double>(buffer, offset);
+    worldPosition.z = readValue<double>(buffer, offset);
+    position = origin.toLocal(worldPosition);
+    velocity = readValue<Quantize::HalfVector3>(buffer, offset).decode();
+    lookDirection = readValue<Quantize::HalfVector3>(buffer, offset).decode();
+    rotation = readValue<Quantize::PackedQuaternion>(buffer, offset).decode();
+    stats.currentHealth = readValue<float>(buffer, offset);
+    stats.currentStamina = readValue<float>(buffer, offset);
+    shieldStrength = readValue<float>(buffer, offset);
+    currentState = static_cast<CombatState>(readValue<uint8_t>(buffer, offset));
+}
+
 Matrix4 Player::getTransformMatrix() const {
     Matrix4 transform;
     transform = Matrix4::translation(position) * rotation.toMatrix4();
@@ -606,14 +776,6 @@ void Player::updateCooldowns(float deltaTime) {
         lastAttackTime -= deltaTime;
     }
     
-    if (teleportCooldown > 0) {
-        teleportCooldown -= deltaTime;
-    }
-    
-    if (shieldCooldown > 0) {
-        shieldCooldown -= deltaTime;
-    }
-    
     if (lastDamageTime < 5.0f) {
         lastDamageTime += deltaTime;
     }
@@ -651,6 +813,18 @@ bool Player::hasStamina(float amount) const {
     return stats.currentStamina >= amount;
 }
 
+TimerWheel& Player::getTimerWheel() {
+    if (!timerWheel) {
+        ownTimerWheel = std::make_unique<TimerWheel>();
+        timerWheel = ownTimerWheel.get();
+    }
+    return *timerWheel;
+}
+
+bool Player::isTimerPending(TimerWheel::TimerId id) const {
+    return timerWheel && timerWheel->isPending(id);
+}
+
 void Player::debugPrint() const {
     std::cout << "=== Player: " << playerName << " ===" << std::endl;
     std::cout << "Level: " << stats.level << " | Exp: " << stats.experience 
@@ -661,4 +835,77 @@ void Player::debugPrint() const {
               << " | STA: " << stats.stamina << " | AGI: " << stats.agility << std::endl;
     std::cout << "State: " << static_cast<int>(currentState) << std::endl;
     std::cout << "Position: (" << position.x << ", " << position.y << ", " << position.z << ")" << std::endl;
+}
+
+CacheLayout::Report Player::describeLayout() const {
+    CacheLayout::Report report("Player", sizeof(Player), alignof(Player));
+    
+    report.add("shield", *this, shield, true);
+    report.add("activeProjectiles", *this, activeProjectiles, true);
+    report.add("pendingExplosions", *this, pendingExplosions, true);
+    report.add("ownTimerWheel", *this, ownTimerWheel, true);
+    report.add("position", *this, position, true);
+    report.add("velocity", *this, velocity, true);
+    report.add("rotation", *this, rotation, true);
+    report.add("lookDirection", *this, lookDirection, true);
+    report.add("moveDirection", *this, moveDirection, true);
+    report.add("moveSpeed", *this, moveSpeed, true);
+    report.add("rotationSpeed", *this, rotationSpeed, true);
+    report.add("currentState", *this, currentState, true);
+    report.add("currentAttack", *this, currentAttack, true);
+    report.add("stateTimer", *this, stateTimer, true);
+    report.add("lastAttackTime", *this, lastAttackTime, true);
+    report.add("lastDamageTime", *this, lastDamageTime, true);
+    report.add("teleportProgress", *this, teleportProgress, true);
+    report.add("comboTimer", *this, comboTimer, true);
+    report.add("damageFlashTimer", *this, damageFlashTimer, true);
+    report.add("healFlashTimer", *this, healFlashTimer, true);
+    report.add("teamMask", *this, teamMask, true);
+    report.add("hostileMask", *this, hostileMask, true);
+    report.add("isTeleporting", *this, isTeleporting, true);
+    report.add("isShielding", *this, isShielding, true);
+    report.add("stats.maxHealth", *this, stats.maxHealth, true);
+    report.add("stats.currentHealth", *this, stats.currentHealth, true);
+    report.add("stats.maxStamina", *this, stats.maxStamina, true);
+    report.add("stats.currentStamina", *this, stats.currentStamina, true);
+    report.add("stats.healthRegen", *this, stats.healthRegen, true);
+    report.add("stats.staminaRegen", *this, stats.staminaRegen, true);
+    report.add("stats.strength", *this, stats.strength, true);
+    report.add("stats.defense", *this, stats.defense, true);
+    report.add("stats.stamina", *this, stats.stamina, true);
+    report.add("stats.agility", *this, stats.agility, true);
+    report.add("stats.dirty", *this, stats.dirty, true);
+    report.add("stats.baseStats", *this, stats.baseStats, false);
+    report.add("stats.statModifiers", *this, stats.statModifiers, false);
+    report.add("stats.level", *this, stats.level, false);
+    report.add("stats.experience", *this, stats.experience, false);
+    report.add("stats.experienceToNextLevel", *this, stats.experienceToNextLevel, false);
+    report.add("stats.statPoints", *this, stats.statPoints, false);
+    
+    report.add("playerId", *this, playerId, false);
+    report.add("teamId", *this, teamId, false);
+    report.add("playerName", *this, playerName, false);
+    report.add("isLocalPlayer", *this, isLocalPlayer, false);
+    report.add("timerWheel", *this, timerWheel, false);
+    report.add("firedTimers", *this, firedTimers, false);
+    report.add("teleportTarget", *this, teleportTarget, false);
+    report.add("teleportCooldownTimer", *this, teleportCooldownTimer, false);
+    report.add("teleportRange", *this, teleportRange, false);
+    report.add("fistDamage", *this, fistDamage, false);
+    report.add("fistRange", *this, fistRange, false);
+    report.add("fistCooldown", *this, fistCooldown, false);
+    report.add("laserDamage", *this, laserDamage, false);
+    report.add("laserRange", *this, laserRange, false);
+    report.add("laserSpeed", *this, laserSpeed, false);
+    report.add("laserCooldown", *this, laserCooldown, false);
+    report.add("shieldStrength", *this, shieldStrength, false);
+    report.add("shieldMaxStrength", *this, shieldMaxStrength, false);
+    report.add("shieldRegenRate", *this, shieldRegenRate, false);
+    report.add("shieldCooldownTimer", *this, shieldCooldownTimer, false);
+    report.add("color", *this, color, false);
+    report.add("comboSequence", *this, comboSequence, false);
+    report.add("comboMultiplier", *this, comboMultiplier, false);
+    report.add("activeBuffs", *this, activeBuffs, false);
+    report.add("activeBuffCount", *this, activeBuffCount, false);
+    return report;
 }
\ No newline at end of file
@@ -2,25 +2,41 @@
 #include "../Math/Vector3.h"
 #include "../Math/Matrix4.h"
 #include "../Math/Quaternion.h"
+#include "../Utils/CacheLayout.h"
+#include "../Utils/TimerWheel.h"
+#include "CombatTimers.h"
 #include <memory>
 #include <vector>
 #include <string>
+#include <cstdint>
 
 // Forward declarations
 class Projectile;
 class Shield;
 class Ability;
+class WorldOrigin;
 
 class Player {
 public:
-    // Player stats structure
+    // Core stat identifiers, used to index stat and modifier arrays
+    enum class StatType : uint8_t {
+        Strength,
+        Defense,
+        Stamina,
+        Agility,
+        Count
+    };
+    static constexpr int StatCount = static_cast<int>(StatType::Count);
+    
+    // Buff identifiers (replaces string-named buffs)
+    enum class BuffType : uint8_t {
+        DamageBoost,
+        SpeedBoost
+    };
+    
+    // Player stats structure. What every tick reads comes first, so it
+    // shares lines with the rest of Player's hot block.
     struct Stats {
-        // Core stats
-        float strength;      // Affects damage output
-        float defense;       // Reduces incoming damage
-        float stamina;       // Affects ability usage and sprinting
-        float agility;       // Affects movement speed and cooldowns
-        
         // Derived stats
         float maxHealth;
         float currentHealth;
@@ -29,6 +45,17 @@ public:
         float healthRegen;
         float staminaRegen;
         
+        // Core stats (base + active buff modifiers)
+        float strength;      // Affects damage output
+        float defense;       // Reduces incoming damage
+        float stamina;       // Affects ability usage and sprinting
+        float agility;       // Affects movement speed and cooldowns
+        bool dirty;          // Core/derived stats need recalculating
+        
+        // Base core stats and accumulated buff modifiers, indexed by StatType
+        float baseStats[StatCount];
+        float statModifiers[StatCount];
+        
         // Experience and leveling
         int level;
         int experience;
@@ -37,8 +64,12 @@ public:
         
         Stats();
         void recalculateDerivedStats();
+        void refreshDerivedStats();  // Recalculate only if dirty
+        void addBaseStat(StatType stat, float amount);
+        void addModifier(StatType stat, float amount);
+        float getStat(StatType stat) const;
         void levelUp();
-        void applyStatPoint(const std::string& statName);
+        void applyStatPoint(StatType stat);
     };
     
     // Combat state
@@ -60,10 +91,26 @@ public:
     };
 
 private:
-    // Player identification
-    int playerId;
-    std::string playerName;
-    bool isLocalPlayer;
+    // Members are grouped by how often a tick touches them, and each group
+    // starts on a cache line (see CacheLayout). New fields go with the
+    // group that uses them; tools/LayoutReport shows where they land.
+    
+    // Hot: what update(), updateMovement() and CombatManager's per-tick
+    // scans read (four lines, stats last)
+    // Combat mechanics
+    alignas(CacheLayout::LineSize) std::unique_ptr<Shield> shield;
+    std::vector<std::unique_ptr<Projectile>> activeProjectiles;
+    
+    // Area blasts from exploded projectiles, drained by CombatManager
+    struct Explosion {
+        Vector3 position;
+        float radius;
+        float damage;
+    };
+    std::vector<Explosion> pendingExplosions;
+    
+    // Driven by update() only when not attached to a shared wheel
+    std::unique_ptr<TimerWheel> ownTimerWheel;
     
     // Position and orientation
     Vector3 position;
@@ -74,26 +121,42 @@ private:
     float moveSpeed;
     float rotationSpeed;
     
-    // Stats
-    Stats stats;
-    
     // Combat state
     CombatState currentState;
     AttackType currentAttack;
     float stateTimer;
     float lastAttackTime;
     float lastDamageTime;
+    float teleportProgress;
+    float comboTimer;
+    float damageFlashTimer;
+    float healFlashTimer;
     
-    // Combat mechanics
-    std::unique_ptr<Shield> shield;
-    std::vector<std::unique_ptr<Projectile>> activeProjectiles;
+    // Team membership as bitmasks (assigned by CombatManager)
+    uint32_t teamMask;       // Bit(s) of the team this player belongs to
+    uint32_t hostileMask;    // Teams this player can damage
+    
+    bool isTeleporting;
+    bool isShielding;
+    
+    // Stats
+    Stats stats;
+    
+    // Cold: identity, tuning and state only actions and events touch
+    // Player identification
+    alignas(CacheLayout::LineSize) int playerId;
+    int teamId;
+    std::string playerName;
+    bool isLocalPlayer;
+    
+    // Timers (buff expiries, cooldowns) live on a shared wheel when attached
+    TimerWheel* timerWheel;
+    std::vector<TimerWheel::FiredTimer> firedTimers;
     
     // Teleportation
     Vector3 teleportTarget;
-    float teleportCooldown;
+    TimerWheel::TimerId teleportCooldownTimer;
     float teleportRange;
-    bool isTeleporting;
-    float teleportProgress;
     
     // Attack properties
     float fistDamage;
@@ -109,27 +172,25 @@ private:
     float shieldStrength;
     float shieldMaxStrength;
     float shieldRegenRate;
-    float shieldCooldown;
-    bool isShielding;
+    TimerWheel::TimerId shieldCooldownTimer;
     
     // Visual effects
     Vector3 color;
-    float damageFlashTimer;
-    float healFlashTimer;
     
     // Combo system
     std::vector<AttackType> comboSequence;
-    float comboTimer;
     int comboMultiplier;
     
-    // Buffs and debuffs
+    // Buffs and debuffs (fixed capacity, no per-pickup allocation)
     struct Buff {
-        std::string name;
-        float duration;
+        BuffType type;
+        StatType affectedStat;
         float statModifier;
-        std::string affectedStat;
+        TimerWheel::TimerId expiryTimer;
     };
-    std::vector<Buff> activeBuffs;
+    static constexpr int MaxBuffs = 8;
+    Buff activeBuffs[MaxBuffs];
+    int activeBuffCount;
     
 public:
     Player(int id, const std::string& name, const Vector3& startPos);
@@ -141,9 +202,12 @@ public:
     void updateMovement(float deltaTime, const Vector3& inputDirection, const Vector3& cameraForward, const Vector3& cameraRight);
     void updateStats(float deltaTime);
     void updateProjectiles(float deltaTime);
-    void updateBuffs(float deltaTime);
     void updateVisualEffects(float deltaTime);
     
+    // Timers
+    void setTimerWheel(TimerWheel* wheel);
+    void onTimerExpired(CombatTimer kind, TimerWheel::TimerId id);
+    
     // Combat actions
     void performFistAttack();
     void fireLaser(const Vector3& direction);
@@ -168,13 +232,18 @@ public:
     void resetStats();
     
     // Buff management
-    void applyBuff(const std::string& buffName, float duration, float modifier, const std::string& stat);
-    void removeBuff(const std::string& buffName);
+    void applyBuff(BuffType type, float duration, float modifier, StatType stat);
+    void removeBuff(BuffType type);
     void clearBuffs();
+    int getActiveBuffCount() const { return activeBuffCount; }
     
     // Getters
     int getPlayerId() const { return playerId; }
     std::string getPlayerName() const { return playerName; }
+    int getTeamId() const { return teamId; }
+    uint32_t getTeamMask() const { return teamMask; }
+    uint32_t getHostileMask() const { return hostileMask; }
+    bool isHostileTo(const Player& other) const { return (hostileMask & other.teamMask) != 0; }
     Vector3 getPosition() const { return position; }
     Vector3 getVelocity() const { return velocity; }
     Quaternion getRotation() const { return rotation; }
@@ -195,14 +264,19 @@ public:
     bool canTeleport() const;
     bool isShieldActive() const { return isShielding; }
     float getShieldStrength() const { return shieldStrength; }
+    std::vector<std::unique_ptr<Projectile>>& getProjectiles() { return activeProjectiles; }
+    const std::vector<std::unique_ptr<Projectile>>& getProjectiles() const { return activeProjectiles; }
+    std::vector<Explosion>& getPendingExplosions() { return pendingExplosions; }
     
     // Setters
     void setPosition(const Vector3& pos);
+    void shiftOrigin(const Vector3& shift);  // Floating origin: moves everything positional by -shift
     void setVelocity(const Vector3& vel);
     void setRotation(const Quaternion& rot);
     void setLookDirection(const Vector3& dir);
     void setMoveDirection(const Vector3& dir) { moveDirection = dir; }
     void setLocalPlayer(bool isLocal) { isLocalPlayer = isLocal; }
+    void setTeam(int team, uint32_t teamBits, uint32_t hostileBits);
     bool getLocalPlayer() const { return isLocalPlayer; }
     Vector3 getMoveDirection() const { return moveDirection; }
     
@@ -211,9 +285,10 @@ public:
     Vector3 getBoundingBoxMin() const;
     Vector3 getBoundingBoxMax() const;
     
-    // Networking
-    void serializeState(std::vector<uint8_t>& buffer) const;
-    void deserializeState(const std::vector<uint8_t>& buffer);
+    // Networking. Peers rebase independently, so the position travels as
+    // a world position and 'origin' is the local frame on either end.
+    void serializeState(std::vector<uint8_t>& buffer, const WorldOrigin& origin) const;
+    void deserializeState(const std::vector<uint8_t>& buffer, const WorldOrigin& origin);
     
     // Rendering
     Matrix4 getTransformMatrix() const;
@@ -221,6 +296,8 @@ public:
     
     // Debug
     void debugPrint() const;
+    // Where each member sits and which ones every tick touches
+    CacheLayout::Report describeLayout() const;
     
 private:
     void updateCooldowns(float deltaTime);
@@ -229,4 +306,7 @@ private:
     float calculateDefense(float incomingDamage) const;
     void consumeStamina(float amount);
     bool hasStamina(float amount) const;
+    void removeBuffAt(int index);
+    TimerWheel& getTimerWheel();
+    bool isTimerPending(TimerWheel::TimerId id) const;
 };
\ No newline at end of file
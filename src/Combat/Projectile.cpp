@@ -3,7 +3,7 @@
 #include <algorithm>
 #include <cmath>
 
-Projectile::Projectile(const Vector3& startPos, const Vector3& vel, float dmg, float range, Player* own)
+Projectile::Projectile(const Vector3& startPos, const Vector3& vel, float dmg, float range, int own)
     : position(startPos)
     , velocity(vel)
     , damage(dmg)
@@ -16,19 +16,20 @@ Projectile::Projectile(const Vector3& startPos, const Vector3& vel, float dmg, f
     , color(Vector3(1.0f, 0.2f, 0.2f))  // Red by default
     , size(0.2f)
     , trailLength(5.0f)
-    , owner(own)
-    , ownerId(own ? own->getPlayerId() : -1)
+    , ownerId(own)
     , collisionRadius(0.3f)
     , hasHit(false)
     , isHoming(false)
-    , homingTarget(nullptr)
+    , homingTargetId(-1)
+    , hasHomingTarget(false)
     , homingStrength(0.0f)
     , isPiercing(false)
     , pierceCount(0)
     , maxPierces(1)
     , hasAreaDamage(false)
     , areaRadius(0.0f)
-    , areaDamage(0.0f) {
+    , areaDamage(0.0f)
+    , exploded(false) {
     
     direction = velocity.normalized();
     speed = velocity.magnitude();
@@ -58,7 +59,7 @@ void Projectile::update(float deltaTime) {
 
 void Projectile::updateMovement(float deltaTime) {
     Vector3 movement = velocity * deltaTime;
-    position = position + movement;
+    position += movement;
     distanceTraveled += movement.magnitude();
 }
 
@@ -73,17 +74,17 @@ void Projectile::updateTrail(float deltaTime) {
 }
 
 void Projectile::updateHoming(float deltaTime) {
-    if (!isHoming || !homingTarget || !homingTarget->isAlive()) return;
+    if (!isHoming || !hasHomingTarget) return;
     
     // Calculate direction to target
-    Vector3 toTarget = homingTarget->getPosition() - position;
-    toTarget = toTarget.normalized();
+    Vector3 toTarget = homingTargetPosition - position;
+    toTarget = toTarget.normalizedFast();
     
     // Lerp velocity towards target
     Vector3 targetVelocity = toTarget * speed;
-    velocity = velocity + (targetVelocity - velocity) * homingStrength * deltaTime;
-    velocity = velocity.normalized() * speed;
-    direction = velocity.normalized();
+    velocity = Vector3::lerpUnclamped(velocity, targetVelocity, homingStrength * deltaTime);
+    direction = velocity.normalizedFast();
+    velocity = direction * speed;
 }
 
 void Projectile::checkCollision() {
@@ -92,8 +93,9 @@ void Projectile::checkCollision() {
 }
 
 void Projectile::explode() {
-    if (hasAreaDamage) {
-        // Game logic will handle area damage to nearby players
+    if (hasAreaDamage && active) {
+        // Owner reports the blast to CombatManager, which queues area damage
+        exploded = true;
     }
     
     deactivate();
@@ -103,10 +105,10 @@ void Projectile::deactivate() {
     active = false;
 }
 
-void Projectile::onHit(Player* target) {
-    if (!active || !target || target == owner) return;
+void Projectile::onHit(Player* target, Player* attacker) {
+    if (!active || !target || target->getPlayerId() == ownerId) return;
     
-    target->takeDamage(damage, owner);
+    target->takeDamage(damage, attacker);
     
     if (isPiercing && pierceCount < maxPierces) {
         pierceCount++;
@@ -120,12 +122,18 @@ void Projectile::onHit(Player* target) {
     }
 }
 
-void Projectile::setHoming(Player* target, float strength) {
+void Projectile::setHoming(int targetId, float strength) {
     isHoming = true;
-    homingTarget = target;
+    homingTargetId = targetId;
+    hasHomingTarget = false;
     homingStrength = std::clamp(strength, 0.0f, 1.0f);
 }
 
+void Projectile::setHomingTargetPosition(const Vector3& targetPosition) {
+    homingTargetPosition = targetPosition;
+    hasHomingTarget = true;
+}
+
 void Projectile::setPiercing(int pierces) {
     isPiercing = true;
     maxPierces = pierces;
@@ -137,8 +145,16 @@ void Projectile::setAreaDamage(float radius, float dmg) {
     areaDamage = dmg;
 }
 
-bool Projectile::checkHitPlayer(Player* player) const {
-    if (!player || player == owner || !active) return false;
+void Projectile::shiftOrigin(const Vector3& shift) {
+    position -= shift;
+    homingTargetPosition -= shift;
+    for (Vector3& trailPosition : trailPositions) {
+        trailPosition -= shift;
+    }
+}
+
+bool Projectile::checkHitPlayer(const Player* player) const {
+    if (!player || player->getPlayerId() == ownerId || !active) return false;
     
     return checkHitPoint(player->getPosition(), 1.0f);  // Assume player radius of 1.0
 }
@@ -35,8 +35,7 @@ private:
     float trailLength;
     std::vector<Vector3> trailPositions;
     
-    // Owner
-    Player* owner;
+    // Owner (player ID handle, resolved through CombatManager)
     int ownerId;
     
     // Collision
@@ -45,7 +44,9 @@ private:
     
     // Special effects
     bool isHoming;
-    Player* homingTarget;
+    int homingTargetId;
+    bool hasHomingTarget;
+    Vector3 homingTargetPosition;  // Refreshed by CombatManager each tick
     float homingStrength;
     
     bool isPiercing;
@@ -55,9 +56,10 @@ private:
     bool hasAreaDamage;
     float areaRadius;
     float areaDamage;
+    bool exploded;
     
 public:
-    Projectile(const Vector3& startPos, const Vector3& velocity, float damage, float range, Player* owner);
+    Projectile(const Vector3& startPos, const Vector3& velocity, float damage, float range, int ownerId);
     ~Projectile();
     
     // Update
@@ -70,7 +72,7 @@ public:
     // Actions
     void explode();
     void deactivate();
-    void onHit(Player* target);
+    void onHit(Player* target, Player* attacker);
     
     // Getters
     Vector3 getPosition() const { return position; }
@@ -78,7 +80,12 @@ public:
     float getDamage() const { return damage; }
     float getSpeed() const { return speed; }
     bool isActive() const { return active; }
-    Player* getOwner() const { return owner; }
+    bool hasExploded() const { return exploded; }
+    float getAreaRadius() const { return areaRadius; }
+    float getAreaDamage() const { return areaDamage; }
+    int getOwnerId() const { return ownerId; }
+    int getHomingTargetId() const { return homingTargetId; }
+    bool isHomingProjectile() const { return isHoming; }
     ProjectileType getType() const { return type; }
     Vector3 getColor() const { return color; }
     float getSize() const { return size; }
@@ -87,12 +94,15 @@ public:
     // Setters
     void setType(ProjectileType t) { type = t; }
     void setColor(const Vector3& c) { color = c; }
-    void setHoming(Player* target, float strength);
+    void setHoming(int targetId, float strength);
+    void setHomingTargetPosition(const Vector3& targetPosition);
+    void clearHomingTarget() { hasHomingTarget = false; }
     void setPiercing(int maxPierces);
     void setAreaDamage(float radius, float dmg);
+    void shiftOrigin(const Vector3& shift);  // Floating origin: moves by -shift
     
     // Collision
-    bool checkHitPlayer(Player* player) const;
+    bool checkHitPlayer(const Player* player) const;
     bool checkHitPoint(const Vector3& point, float radius) const;
     
     // Rendering
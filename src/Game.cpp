@@ -1,13 +1,30 @@
 #include "Game.h"
 #include "Platform/PlatformDetect.h"
+#include "Math/SimMath.h"
 #include <iostream>
 #include <chrono>
 #include <algorithm>
+#include <cmath>
 
 #if !PLATFORM_MOBILE
 #include <GLFW/glfw3.h>
 #endif
 
+namespace {
+    // Tracks longer than this are streamed in chunks instead of kept resident
+    constexpr float StreamingTrackLength = 5000.0f;
+    
+    // AI opponents in racing mode
+    constexpr int AICarCount = 7;
+    
+    void placeOnGrid(Car& car, const Track& track, int slot) {
+        // Cars face down the track; forward is -Z
+        Track::TrackPoint point = track.getGridSlot(slot);
+        car.resetToPosition(point.position);
+        car.setRotation(Quaternion::fromAxisAngle(Vector3::up(), SimMath::atan2(-point.tangent.x, -point.tangent.z)));
+    }
+}
+
 Game::Game() 
     : currentState(GameState::Menu)
     , isRunning(false)
@@ -38,7 +55,11 @@ Game::Game()
     , showHUD(true)
     , showDebugInfo(false)
     , playerCar(nullptr)
-    , localPlayer(nullptr) {
+    , localPlayerId(-1)
+    , localPlayer(nullptr)
+    , uploadedTrack(nullptr)
+    , uploadedTrackGeometryVersion(0)
+    , uploadedTrackLayoutVersion(0) {
 }
 
 Game::~Game() {
@@ -142,9 +163,13 @@ void Game::shutdown() {
     physicsEngine.reset();
     combatManager.reset();
     camera.reset();
+    trackStreamer.reset();
     track.reset();
     cars.clear();
     playerCar = nullptr;
+    carProgress.clear();
+    standings.clear();
+    localPlayerId = -1;
     localPlayer = nullptr;
     pvpPlayers.clear();
     
@@ -182,6 +207,9 @@ void Game::update(float dt) {
     deltaTime = dt;
     gameTime += dt;
     
+    // Drop the local player pointer if it was removed from combat
+    localPlayer = combatManager ? combatManager->getPlayer(localPlayerId) : nullptr;
+    
     if (!isPaused) {
         handleInput();
         
@@ -192,6 +220,8 @@ void Game::update(float dt) {
             updateGameplay(dt);
         }
         
+        // Between ticks, so nothing sees half the world moved
+        updateWorldOrigin();
         updateCamera(dt);
         updateParticles(dt);
         updateTrails(dt);
@@ -271,13 +301,13 @@ void Game::handleInput() {
     // Handle stats menu input
     else if (currentState == GameState::StatsMenu && localPlayer) {
         if (inputManager->isKeyJustPressed(InputManager::Key::F1)) {
-            distributeStatPoint(localPlayer, "strength");
+            distributeStatPoint(localPlayer, Player::StatType::Strength);
         } else if (inputManager->isKeyJustPressed(InputManager::Key::F2)) {
-            distributeStatPoint(localPlayer, "defense");
+            distributeStatPoint(localPlayer, Player::StatType::Defense);
         } else if (inputManager->isKeyJustPressed(InputManager::Key::F3)) {
-            distributeStatPoint(localPlayer, "stamina");
+            distributeStatPoint(localPlayer, Player::StatType::Stamina);
         } else if (inputManager->isKeyJustPressed(InputManager::Key::F4)) {
-            distributeStatPoint(localPlayer, "agility");
+            distributeStatPoint(localPlayer, Player::StatType::Agility);
         }
     }
     // Handle PvP input
@@ -365,6 +395,7 @@ void Game::quit() {
 void Game::addCar(std::unique_ptr<Car> car) {
     if (car) {
         cars.push_back(std::move(car));
+        carProgress.emplace_back(totalLaps);
         if (!playerCar) {
             playerCar = cars.back().get();
         }
@@ -379,7 +410,9 @@ void Game::removeCar(Car* car) {
             if (playerCar == car) {
                 playerCar = nullptr;
             }
+            carProgress.erase(carProgress.begin() + (it - cars.begin()));
             cars.erase(it);
+            standings.clear();
             break;
         }
     }
@@ -389,8 +422,33 @@ void Game::setPlayerCar(Car* car) {
     playerCar = car;
 }
 
+const RaceProgress* Game::getRaceProgress(const Car* car) const {
+    for (size_t i = 0; i < cars.size(); i++) {
+        if (cars[i].get() == car) {
+            return &carProgress[i];
+        }
+    }
+    return nullptr;
+}
+
 void Game::setTrack(std::unique_ptr<Track> newTrack) {
+    // The streamer reads the old track on its own thread; stop it first
+    trackStreamer.reset();
+    if (physicsEngine) {
+        physicsEngine->getGroundQuery().clearTrack();
+    }
+    resetWorldOrigin();
     track = std::move(newTrack);
+    uploadedTrack = nullptr;
+    setupTrackStreaming();
+    buildRacingLine();
+    
+    // Segment hints and gates belong to the old track
+    for (auto& progress : carProgress) {
+        progress.reset();
+    }
+    standings.clear();
+    placeCarsOnGrid();
 }
 
 void Game::setCamera(std::unique_ptr<Camera> newCamera) {
@@ -528,6 +586,11 @@ void Game::renderDebugInfo() {
     
     // Debug info rendering
     renderer->renderDebugInfo();
+    
+    DriverAI::Stats aiStats = driverAI.getStats();
+    renderer->renderText("AI: " + std::to_string(aiStats.cars) + " cars, " + std::to_string(aiStats.lastTickMs) +
+                         " ms (avg " + std::to_string(aiStats.averageTickMs) + ", max " +
+                         std::to_string(aiStats.maxTickMs) + ")", 10, 60, 1.0f, Vector3(1, 1, 1));
 }
 
 void Game::renderMenu() {
@@ -559,14 +622,120 @@ void Game::updateGameplay(float dt) {
 }
 
 void Game::updateLapProgress() {
-    if (!playerCar || !track) return;
+    if (!track) return;
+    
+    for (size_t i = 0; i < cars.size(); i++) {
+        carProgress[i].update(*track, cars[i]->getPosition(), deltaTime);
+    }
+    standings.update(carProgress);
+    updateTrackStreaming();
+    
+    const RaceProgress* progress = getRaceProgress(playerCar);
+    if (!progress) return;
+    
+    if (progress->getLap() > currentLap) {
+        // Lap completed
+        float lapTime = progress->getLastLapTime();
+        if (bestTime <= 0.0f || lapTime < bestTime) {
+            bestTime = lapTime;
+        }
+        currentLapTime = progress->getCurrentLapTime();
+    }
+    currentLap = progress->getLap();
+}
+
+void Game::updateTrackStreaming() {
+    if (!trackStreamer) return;
+    
+    // Stream around the whole field, leader to last car
+    float furthestAhead = 0.0f;
+    float furthestBehind = 0.0f;
+    const std::vector<int>& order = standings.getOrder();
+    if (!order.empty()) {
+        furthestAhead = carProgress[order.front()].getRaceDistance();
+        furthestBehind = carProgress[order.back()].getRaceDistance();
+    }
+    trackStreamer->update(furthestAhead, furthestBehind);
     
-    // Check checkpoint progress
-    if (track->checkCheckpoint(playerCar->getPosition(), 5.0f)) {
-        // Checkpoint passed
+    // Hand chunk changes to the ground query and the renderer as they arrive
+    if (physicsEngine) {
+        GroundQuery& ground = physicsEngine->getGroundQuery();
+        for (int index : trackStreamer->getLoadedChunks()) {
+            const TrackStreamer::Chunk* chunk = trackStreamer->getChunk(index);
+            if (chunk) {
+                chunkSurfaces.clear();
+                for (const Track::TrackPoint& point : chunk->points) {
+                    chunkSurfaces.push_back(point.surface);
+                }
+                ground.setTrackChunk(index, chunk->vertices.data(), chunk->indices.data(), chunk->indices.size(),
+                                     chunkSurfaces.data());
+            }
+        }
+        for (int index : trackStreamer->getEvictedChunks()) {
+            ground.removeTrackChunk(index);
+        }
+    }
+    if (renderer) {
+        for (int index : trackStreamer->getLoadedChunks()) {
+            const TrackStreamer::Chunk* chunk = trackStreamer->getChunk(index);
+            if (chunk) {
+                renderer->uploadTrackChunk(index, chunk->vertices.data(), chunk->vertices.size(),
+                                           chunk->indices.data(), chunk->indices.size());
+            }
+        }
+        for (int index : trackStreamer->getEvictedChunks()) {
+            renderer->releaseTrackChunk(index);
+        }
+    }
+}
+
+void Game::updateWorldOrigin() {
+    // The focus is whoever the camera follows
+    Vector3 focus;
+    if (currentState == GameState::PvPMode && localPlayer) {
+        focus = localPlayer->getPosition();
+    } else if (playerCar) {
+        focus = playerCar->getPosition();
+    } else {
+        return;
     }
     
-    currentLap = track->getCurrentLap();
+    Vector3 shift;
+    if (worldOrigin.update(focus, shift)) {
+        shiftWorld(shift);
+    }
+}
+
+void Game::shiftWorld(const Vector3& shift) {
+    // The track's origin goes first; the ground rebuilds against it
+    Vector3 trackSpaceOrigin = worldOrigin.getTrackSpaceOrigin();
+    if (track) {
+        track->setOrigin(trackSpaceOrigin);
+    }
+    if (physicsEngine) {
+        physicsEngine->shiftOrigin(shift);
+    }
+    if (trackStreamer) {
+        trackStreamer->shiftOrigin(shift);
+    }
+    racingLine.shiftOrigin(shift);
+    for (auto& progress : carProgress) {
+        progress.shiftOrigin(shift);
+    }
+    if (combatManager) {
+        combatManager->shiftOrigin(shift);
+    }
+    if (camera) {
+        camera->shiftOrigin(shift);
+    }
+    if (renderer) {
+        renderer->setWorldOrigin(trackSpaceOrigin);
+    }
+}
+
+void Game::resetWorldOrigin() {
+    // A new track starts out at track-space zero
+    shiftWorld(worldOrigin.reset());
 }
 
 void Game::updateTiming() {
@@ -582,11 +751,50 @@ void Game::checkWinCondition() {
 }
 
 void Game::spawnCars() {
-    // Spawn AI cars
+    for (int i = 0; i < AICarCount; i++) {
+        auto car = std::make_unique<Car>();
+        if (physicsEngine) {
+            physicsEngine->addCar(car.get());
+        }
+        addCar(std::move(car));
+    }
+    placeCarsOnGrid();
+}
+
+void Game::placeCarsOnGrid() {
+    if (!track) return;
+    
+    // AI cars fill the grid from pole; the player starts behind them
+    int slot = 0;
+    for (auto& car : cars) {
+        if (car.get() != playerCar) {
+            placeOnGrid(*car, *track, slot++);
+        }
+    }
+    if (playerCar) {
+        placeOnGrid(*playerCar, *track, slot);
+    }
 }
 
 void Game::updateAI(float dt) {
-    // Update AI car behavior
+    // Edited tracks get a fresh line; otherwise this is a version compare
+    if (track && !racingLine.isBuiltFor(*track)) {
+        racingLine.build(*track);
+    }
+    
+    // Difficulty above 1 speeds up nothing: the line's targets are the limit
+    driverAI.setPace(std::min(difficulty, 1.0f));
+    driverAI.update(racingLine, cars, carProgress, playerCar);
+}
+
+void Game::buildRacingLine() {
+    if (!track) {
+        racingLine.clear();
+        return;
+    }
+    
+    racingLine.build(*track);
+    std::cout << "Racing line solved, ideal lap " << racingLine.getIdealLapTime() << "s" << std::endl;
 }
 
 void Game::setScreenSize(int width, int height) {
@@ -653,13 +861,16 @@ void Game::resetGame() {
     currentLapTime = 0.0f;
     gameTime = 0.0f;
     
-    if (track) {
-        track->resetLapProgress();
+    for (auto& progress : carProgress) {
+        progress.reset();
     }
+    standings.clear();
     
     for (auto& car : cars) {
         car->reset();
     }
+    placeCarsOnGrid();
+    driverAI.reset();
 }
 
 void Game::loadSettings() {
@@ -677,6 +888,7 @@ void Game::showMessage(const std::string& message) {
 void Game::initializeGame() {
     initializeCars();
     initializeTrack();
+    spawnCars();
     initializeCamera();
     initializeInput();
 }
@@ -694,7 +906,41 @@ void Game::initializeCars() {
 }
 
 void Game::initializeTrack() {
-    track = std::make_unique<Track>(50.0f, 10.0f, 100);
+    // Prefer the precompiled track (see tools/TrackBuilder); generate otherwise
+    trackStreamer.reset();
+    if (physicsEngine) {
+        physicsEngine->getGroundQuery().clearTrack();
+    }
+    resetWorldOrigin();
+    track = std::make_unique<Track>("assets/tracks/default.trk");
+    uploadedTrack = nullptr;
+    
+    if (!track->isMapped()) {
+        std::cout << "No precompiled track found, generated default track" << std::endl;
+    }
+    
+    setupTrackStreaming();
+    buildRacingLine();
+}
+
+void Game::setupTrackStreaming() {
+    trackStreamer.reset();
+    if (renderer) {
+        renderer->releaseTrackChunks();
+    }
+    if (physicsEngine) {
+        physicsEngine->getGroundQuery().clearTrackChunks();
+    }
+    
+    // A streamed track's ground comes from its resident chunks, not the
+    // whole track (see updateTrackStreaming)
+    if (track && track->getTrackLength() > StreamingTrackLength) {
+        trackStreamer = std::make_unique<TrackStreamer>(*track);
+        if (physicsEngine) {
+            physicsEngine->getGroundQuery().clearTrack();
+        }
+        std::cout << "Streaming track in " << trackStreamer->getChunkCount() << " chunks" << std::endl;
+    }
 }
 
 void Game::initializeCamera() {
@@ -712,6 +958,11 @@ void Game::initializeInput() {
 
 void Game::updatePhysics(float dt) {
     if (physicsEngine) {
+        // Rebuilds or refits the ground BVH only if the track changed.
+        // Streamed tracks feed it chunk by chunk instead.
+        if (track && !trackStreamer) {
+            physicsEngine->getGroundQuery().syncWithTrack(*track);
+        }
         physicsEngine->update(dt);
     }
 }
@@ -727,11 +978,21 @@ void Game::updateUI(float dt) {
 void Game::renderCars() {
     if (!renderer) return;
     
+    carPositions.clear();
+    carRotations.clear();
+    for (const auto& car : cars) {
+        if (car) {
+            carPositions.push_back(car->getPosition());
+            carRotations.push_back(car->getRotation());
+        }
+    }
+    TransformBatch::composeTransforms(carPositions, carRotations, carTransforms);
+    
+    size_t next = 0;
     for (const auto& car : cars) {
         if (car) {
-            Matrix4 transform = car->getTransformMatrix();
             Vector3 color = (car.get() == playerCar) ? Vector3(1.0f, 0.0f, 0.0f) : Vector3(0.0f, 0.0f, 1.0f);
-            renderer->renderCar(transform, color);
+            renderer->renderCar(carTransforms[next++], color);
         }
     }
 }
@@ -739,9 +1000,33 @@ void Game::renderCars() {
 void Game::renderTrack() {
     if (!renderer || !track) return;
     
-    const auto& vertices = track->getTrackVertices();
-    const auto& indices = track->getTrackIndices();
-    renderer->renderTrack(vertices, indices);
+    // Streamed chunks are uploaded as they arrive in updateTrackStreaming
+    if (trackStreamer) {
+        renderer->renderTrackChunks();
+        return;
+    }
+    
+    // Full upload when the track or its layout changed; edits patch only
+    // the vertices they touched
+    if (track.get() != uploadedTrack || track->getLayoutVersion() != uploadedTrackLayoutVersion) {
+        ArrayView<TrackVertex> vertices = track->getTrackVertices();
+        ArrayView<unsigned int> indices = track->getTrackIndices();
+        renderer->uploadTrackGeometry(vertices.data(), vertices.size(), indices.data(), indices.size());
+        track->consumeDirtyGeometry();
+        
+        uploadedTrack = track.get();
+        uploadedTrackLayoutVersion = track->getLayoutVersion();
+        uploadedTrackGeometryVersion = track->getGeometryVersion();
+    } else if (track->getGeometryVersion() != uploadedTrackGeometryVersion) {
+        Track::GeometryRange dirty = track->consumeDirtyGeometry();
+        if (dirty.vertexCount > 0) {
+            ArrayView<TrackVertex> vertices = track->getTrackVertices();
+            renderer->updateTrackGeometry(vertices.data() + dirty.firstVertex, dirty.firstVertex, dirty.vertexCount);
+        }
+        uploadedTrackGeometryVersion = track->getGeometryVersion();
+    }
+    
+    renderer->renderTrackGeometry();
 }
 
 void Game::renderEnvironment() {
@@ -788,14 +1073,15 @@ void Game::initializePvPMode() {
     localPlayer = combatManager->addPlayer("Player1");
     if (localPlayer) {
         localPlayer->setLocalPlayer(true);
-        pvpPlayers.push_back(localPlayer);
+        localPlayerId = localPlayer->getPlayerId();
+        pvpPlayers.push_back(localPlayerId);
     }
     
     // Add AI opponents for testing
     for (int i = 0; i < 3; i++) {
         Player* aiPlayer = combatManager->addPlayer("AI_" + std::to_string(i + 1));
         if (aiPlayer) {
-            pvpPlayers.push_back(aiPlayer);
+            pvpPlayers.push_back(aiPlayer->getPlayerId());
         }
     }
     
@@ -856,8 +1142,9 @@ void Game::updatePvPMode(float dt) {
     }
     
     // Check for level ups
-    for (auto& player : pvpPlayers) {
-        if (player->getStats().statPoints > 0) {
+    for (int playerId : pvpPlayers) {
+        Player* player = combatManager->getPlayer(playerId);
+        if (player && player->getStats().statPoints > 0) {
             handlePlayerLevelUp(player);
         }
     }
@@ -886,7 +1173,7 @@ void Game::addPvPPlayer(const std::string& name) {
     
     Player* newPlayer = combatManager->addPlayer(name);
     if (newPlayer) {
-        pvpPlayers.push_back(newPlayer);
+        pvpPlayers.push_back(newPlayer->getPlayerId());
     }
 }
 
@@ -896,21 +1183,8 @@ void Game::handlePlayerLevelUp(Player* player) {
     // For AI players, auto-distribute stat points
     if (!player->getLocalPlayer()) {
         // Simple AI stat distribution
-        int choice = rand() % 4;
-        switch (choice) {
-            case 0:
-                player->getStats().applyStatPoint("strength");
-                break;
-            case 1:
-                player->getStats().applyStatPoint("defense");
-                break;
-            case 2:
-                player->getStats().applyStatPoint("stamina");
-                break;
-            case 3:
-                player->getStats().applyStatPoint("agility");
-                break;
-        }
+        int choice = rand() % Player::StatCount;
+        player->getStats().applyStatPoint(static_cast<Player::StatType>(choice));
     }
     // For local player, show stats menu
     else if (currentState != GameState::StatsMenu) {
@@ -918,7 +1192,7 @@ void Game::handlePlayerLevelUp(Player* player) {
     }
 }
 
-void Game::distributeStatPoint(Player* player, const std::string& stat) {
+void Game::distributeStatPoint(Player* player, Player::StatType stat) {
     if (!player) return;
     
     player->getStats().applyStatPoint(stat);
@@ -988,7 +1262,8 @@ void Game::renderPvPMode() {
     renderer->renderPlane(Vector3::zero(), Vector3::up(), 100.0f, Vector3(0.3f, 0.3f, 0.3f));
     
     // Render all players
-    for (auto& player : pvpPlayers) {
+    for (int playerId : pvpPlayers) {
+        Player* player = combatManager ? combatManager->getPlayer(playerId) : nullptr;
         if (!player) continue;
         
         Matrix4 transform = player->getTransformMatrix();
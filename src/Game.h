@@ -1,11 +1,17 @@
 #pragma once
 #include "Platform/PlatformDetect.h"
+#include "AI/DriverAI.h"
 #include "Camera/Camera.h"
+#include "Math/TransformBatch.h"
 #include "Physics/Car.h"
 #include "Physics/PhysicsEngine.h"
 #include "Rendering/Renderer.h"
 #include "Input/InputManager.h"
 #include "World/Track.h"
+#include "World/RaceProgress.h"
+#include "World/RacingLine.h"
+#include "World/TrackStreamer.h"
+#include "World/WorldOrigin.h"
 #include "Combat/CombatManager.h"
 #include "Combat/Player.h"
 #include <memory>
@@ -34,6 +40,11 @@ private:
     std::unique_ptr<PhysicsEngine> physicsEngine;
     std::unique_ptr<Camera> camera;
     std::unique_ptr<Track> track;
+    std::unique_ptr<TrackStreamer> trackStreamer;  // Only for tracks too long to keep resident
+    std::vector<SurfaceMaterial> chunkSurfaces;    // Scratch for handing chunks to the ground query
+    RacingLine racingLine;                         // Solved once per track, sampled by AI drivers
+    DriverAI driverAI;                             // Drives every car but the player's
+    WorldOrigin worldOrigin;                       // Local space follows the focus across the map
     std::unique_ptr<CombatManager> combatManager;
     
 #if PLATFORM_MOBILE
@@ -45,9 +56,25 @@ private:
     std::vector<std::unique_ptr<Car>> cars;
     Car* playerCar;
     
-    // PvP objects
+    // Per-frame car transforms, composed in one batch for rendering
+    TransformBatch::Vector3Arrays carPositions;
+    TransformBatch::QuaternionArrays carRotations;
+    std::vector<Matrix4> carTransforms;
+    
+    // Race progress, indexed like cars
+    std::vector<RaceProgress> carProgress;
+    RaceStandings standings;
+    
+    // PvP objects (players are referenced by CombatManager ID handles;
+    // localPlayer is re-resolved from localPlayerId every frame)
+    int localPlayerId;
     Player* localPlayer;
-    std::vector<Player*> pvpPlayers;
+    std::vector<int> pvpPlayers;
+    
+    // Track geometry last uploaded to the renderer
+    const Track* uploadedTrack;
+    uint32_t uploadedTrackGeometryVersion;
+    uint32_t uploadedTrackLayoutVersion;
     
     // Game state
     GameState currentState;
@@ -114,10 +141,16 @@ public:
     void removeCar(Car* car);
     void setPlayerCar(Car* car);
     Car* getPlayerCar() const { return playerCar; }
+    const RaceProgress* getRaceProgress(const Car* car) const;
+    const RaceStandings& getStandings() const { return standings; }
     
     // Track management
     void setTrack(std::unique_ptr<Track> newTrack);
     Track* getTrack() const { return track.get(); }
+    const TrackStreamer* getTrackStreamer() const { return trackStreamer.get(); }
+    const RacingLine& getRacingLine() const { return racingLine; }
+    const DriverAI& getDriverAI() const { return driverAI; }
+    const WorldOrigin& getWorldOrigin() const { return worldOrigin; }
     
     // Camera management
     void setCamera(std::unique_ptr<Camera> newCamera);
@@ -161,7 +194,9 @@ public:
     void updateTiming();
     void checkWinCondition();
     void spawnCars();
+    void placeCarsOnGrid();
     void updateAI(float deltaTime);
+    void buildRacingLine();
     
     // PvP gameplay
     void initializePvPMode();
@@ -170,7 +205,7 @@ public:
     void endPvPMatch();
     void addPvPPlayer(const std::string& name);
     void handlePlayerLevelUp(Player* player);
-    void distributeStatPoint(Player* player, const std::string& stat);
+    void distributeStatPoint(Player* player, Player::StatType stat);
     
     // Settings
     void setScreenSize(int width, int height);
@@ -214,6 +249,11 @@ private:
     void initializeGame();
     void initializeCars();
     void initializeTrack();
+    void setupTrackStreaming();
+    void updateTrackStreaming();
+    void updateWorldOrigin();
+    void shiftWorld(const Vector3& shift);
+    void resetWorldOrigin();
     void initializeCamera();
     void initializeInput();
     void updatePhysics(float deltaTime);
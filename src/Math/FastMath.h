@@ -0,0 +1,161 @@
+#pragma once
+#include "SIMD.h"
+#include "SimMath.h"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+// Approximate trig and reciprocal square root for hot paths that can live
+// with a small, bounded error. Call sites opt in one at a time; nothing
+// else in the math library switches over.
+//
+// Maximum errors, measured against double-precision results:
+//   sin, cos, sinCos   1e-7 absolute for |x| <= 1000 (reduction error
+//                      grows with |x|; |x| must stay below 1e9)
+//   atan               2e-7 absolute
+//   acos               5e-7 absolute on [-1, 1]
+//   rsqrt, sqrt        3e-7 relative, for x > 0
+//
+// Building with MATH_NO_APPROX defined (CMake APPROXIMATE_MATH=OFF) turns
+// every one of these back into the exact version, to check whether an
+// artefact comes from the approximations. The polynomials only add and
+// multiply floats, so they are as deterministic as the rest of the
+// simulation. The rsqrt estimate instructions differ between CPU vendors,
+// but rsqrt only uses them when SIMD is on and DETERMINISTIC_MATH builds
+// turn SIMD off.
+namespace FastMath {
+    namespace Detail {
+        // x = quadrant * pi/2 + r with |r| <= pi/4 and quadrant in 0..3.
+        // pi/2 is split so the first two products are exact.
+        inline float reduce(float x, int& quadrant) {
+            float scaled = x * 0.636619772f;
+            int n = static_cast<int>(scaled + std::copysign(0.5f, scaled));
+            float fn = static_cast<float>(n);
+            quadrant = n & 3;
+            return ((x - fn * 1.5703125f) - fn * 4.837512969970703125e-4f) - fn * 7.54978995489188216e-8f;
+        }
+
+        // sin and cos of r in [-pi/4, pi/4] (Cephes single-precision kernels)
+        inline float kernelSin(float r) {
+            float z = r * r;
+            return ((-1.9515295891e-4f * z + 8.3321608736e-3f) * z - 1.6666654611e-1f) * z * r + r;
+        }
+
+        inline float kernelCos(float r) {
+            float z = r * r;
+            return ((2.443315711809948e-5f * z - 1.388731625493765e-3f) * z + 4.166664568298827e-2f) * z * z
+                   - 0.5f * z + 1.0f;
+        }
+
+        // atan on [-tan(pi/8), tan(pi/8)] (Cephes single-precision kernel)
+        inline float kernelAtan(float x) {
+            float z = x * x;
+            return (((8.05374449538e-2f * z - 1.38776856032e-1f) * z + 1.99777106478e-1f) * z
+                   - 3.33329491539e-1f) * z * x + x;
+        }
+    }
+
+#if defined(MATH_NO_APPROX) && MATH_NO_APPROX
+    inline float sin(float x) { return SimMath::sin(x); }
+    inline float cos(float x) { return SimMath::cos(x); }
+    inline void sinCos(float x, float& s, float& c) { s = SimMath::sin(x); c = SimMath::cos(x); }
+    inline float atan(float x) { return SimMath::atan(x); }
+    inline float acos(float x) { return SimMath::acos(x); }
+    inline float rsqrt(float x) { return 1.0f / std::sqrt(x); }
+    inline float sqrt(float x) { return std::sqrt(x); }
+#else
+    inline void sinCos(float x, float& s, float& c) {
+        // Per-tick rotation angles are small; they skip the reduction
+        if (std::fabs(x) <= 0.785398163f) {
+            s = Detail::kernelSin(x);
+            c = Detail::kernelCos(x);
+            return;
+        }
+
+        int quadrant;
+        float r = Detail::reduce(x, quadrant);
+        float sr = Detail::kernelSin(r);
+        float cr = Detail::kernelCos(r);
+
+        // Odd quadrants swap sin and cos, and the signs follow the
+        // quadrant. Done on the bits: the quadrant of a random angle is
+        // unpredictable, so branches here would mostly mispredict.
+        uint32_t sinBits, cosBits;
+        std::memcpy(&sinBits, &sr, sizeof(sinBits));
+        std::memcpy(&cosBits, &cr, sizeof(cosBits));
+        uint32_t swap = (sinBits ^ cosBits) & (0u - static_cast<uint32_t>(quadrant & 1));
+        sinBits ^= swap;
+        cosBits ^= swap;
+        sinBits ^= static_cast<uint32_t>(quadrant & 2) << 30;
+        cosBits ^= static_cast<uint32_t>((quadrant + 1) & 2) << 30;
+        std::memcpy(&s, &sinBits, sizeof(s));
+        std::memcpy(&c, &cosBits, sizeof(c));
+    }
+
+    inline float sin(float x) {
+        float s, c;
+        sinCos(x, s, c);
+        return s;
+    }
+
+    inline float cos(float x) {
+        float s, c;
+        sinCos(x, s, c);
+        return c;
+    }
+
+    inline float atan(float x) {
+        // Shift |x| into the kernel's range by subtracting pi/4 or pi/2
+        float a = std::fabs(x);
+        float base = 0.0f;
+        if (a > 2.414213562f) {
+            base = 1.57079632679f;
+            a = -1.0f / a;
+        } else if (a > 0.414213562f) {
+            base = 0.785398163397f;
+            a = (a - 1.0f) / (a + 1.0f);
+        }
+        float result = base + Detail::kernelAtan(a);
+        return x < 0.0f ? -result : result;
+    }
+
+    // Abramowitz and Stegun 4.4.46; x is clamped to [-1, 1]
+    inline float acos(float x) {
+        float a = std::fabs(x);
+        if (a > 1.0f) a = 1.0f;
+        float p = -0.0012624911f;
+        p = p * a + 0.0066700901f;
+        p = p * a - 0.0170881256f;
+        p = p * a + 0.0308918810f;
+        p = p * a - 0.0501743046f;
+        p = p * a + 0.0889789874f;
+        p = p * a - 0.2145988016f;
+        p = p * a + 1.5707963050f;
+        float result = std::sqrt(1.0f - a) * p;
+        return x < 0.0f ? 3.14159265359f - result : result;
+    }
+
+    // 1 / sqrt(x) for x > 0: the hardware estimate refined with Newton
+    // steps. Without SIMD the bit-shift estimate needs three steps to get
+    // this close, which is no faster than a real square root and divide.
+    inline float rsqrt(float x) {
+#if MATH_SIMD_SSE
+        float r = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(x)));
+        return r * (1.5f - 0.5f * x * r * r);
+#elif MATH_SIMD_NEON
+        float32x2_t v = vdup_n_f32(x);
+        float32x2_t r = vrsqrte_f32(v);
+        r = vmul_f32(r, vrsqrts_f32(vmul_f32(v, r), r));
+        r = vmul_f32(r, vrsqrts_f32(vmul_f32(v, r), r));
+        return vget_lane_f32(r, 0);
+#else
+        return 1.0f / std::sqrt(x);
+#endif
+    }
+
+    // sqrt(x) for x >= 0
+    inline float sqrt(float x) {
+        return x > 0.0f ? x * rsqrt(x) : 0.0f;
+    }
+#endif
+}
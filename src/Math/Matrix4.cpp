@@ -1,65 +1,5 @@
 #include "Matrix4.h"
 #include <cmath>
-#include <cstring>
-
-Matrix4::Matrix4() {
-    std::memset(m, 0, sizeof(m));
-    m[0] = m[5] = m[10] = m[15] = 1.0f;
-}
-
-Matrix4::Matrix4(const Matrix4& other) {
-    std::memcpy(m, other.m, sizeof(m));
-}
-
-Matrix4 Matrix4::operator*(const Matrix4& other) const {
-    Matrix4 result;
-    for (int i = 0; i < 4; i++) {
-        for (int j = 0; j < 4; j++) {
-            result(i, j) = 0.0f;
-            for (int k = 0; k < 4; k++) {
-                result(i, j) += (*this)(i, k) * other(k, j);
-            }
-        }
-    }
-    return result;
-}
-
-Vector3 Matrix4::operator*(const Vector3& v) const {
-    float w = (*this)(3, 0) * v.x + (*this)(3, 1) * v.y + (*this)(3, 2) * v.z + (*this)(3, 3);
-    if (w != 0.0f) {
-        w = 1.0f / w;
-    }
-    return Vector3(
-        ((*this)(0, 0) * v.x + (*this)(0, 1) * v.y + (*this)(0, 2) * v.z + (*this)(0, 3)) * w,
-        ((*this)(1, 0) * v.x + (*this)(1, 1) * v.y + (*this)(1, 2) * v.z + (*this)(1, 3)) * w,
-        ((*this)(2, 0) * v.x + (*this)(2, 1) * v.y + (*this)(2, 2) * v.z + (*this)(2, 3)) * w
-    );
-}
-
-Matrix4& Matrix4::operator*=(const Matrix4& other) {
-    *this = *this * other;
-    return *this;
-}
-
-float& Matrix4::operator()(int row, int col) {
-    return m[row * 4 + col];
-}
-
-const float& Matrix4::operator()(int row, int col) const {
-    return m[row * 4 + col];
-}
-
-Matrix4 Matrix4::identity() {
-    return Matrix4();
-}
-
-Matrix4 Matrix4::translation(const Vector3& translation) {
-    Matrix4 result = identity();
-    result(0, 3) = translation.x;
-    result(1, 3) = translation.y;
-    result(2, 3) = translation.z;
-    return result;
-}
 
 Matrix4 Matrix4::rotation(const Vector3& axis, float angle) {
     Vector3 normalizedAxis = axis.normalized();
@@ -91,14 +31,6 @@ Matrix4 Matrix4::rotation(const Vector3& axis, float angle) {
     return result;
 }
 
-Matrix4 Matrix4::scale(const Vector3& scale) {
-    Matrix4 result = identity();
-    result(0, 0) = scale.x;
-    result(1, 1) = scale.y;
-    result(2, 2) = scale.z;
-    return result;
-}
-
 Matrix4 Matrix4::lookAt(const Vector3& eye, const Vector3& center, const Vector3& up) {
     Vector3 f = (center - eye).normalized();
     Vector3 s = f.cross(up).normalized();
@@ -166,31 +98,195 @@ Matrix4 Matrix4::orthographic(float left, float right, float bottom, float top,
     return result;
 }
 
-Matrix4 Matrix4::transpose() const {
-    Matrix4 result;
-    for (int i = 0; i < 4; i++) {
-        for (int j = 0; j < 4; j++) {
-            result(i, j) = (*this)(j, i);
-        }
+#if MATH_SIMD_SSE
+#define MATRIX4_LANES(x, y, z, w) ((x) | ((y) << 2) | ((z) << 4) | ((w) << 6))
+
+namespace {
+    // Lane helpers for the 2x2-block inverse. A 2x2 block is packed into one
+    // register row-major as (a, b, c, d).
+    template <int Mask>
+    inline __m128 swizzle(__m128 v) {
+        return _mm_castsi128_ps(_mm_shuffle_epi32(_mm_castps_si128(v), Mask));
+    }
+
+    // A * B
+    inline __m128 multiply2x2(__m128 a, __m128 b) {
+        return _mm_add_ps(_mm_mul_ps(a, swizzle<MATRIX4_LANES(0, 3, 0, 3)>(b)),
+                          _mm_mul_ps(swizzle<MATRIX4_LANES(1, 0, 3, 2)>(a), swizzle<MATRIX4_LANES(2, 1, 2, 1)>(b)));
+    }
+
+    // adj(A) * B
+    inline __m128 adjugateMultiply2x2(__m128 a, __m128 b) {
+        return _mm_sub_ps(_mm_mul_ps(swizzle<MATRIX4_LANES(3, 3, 0, 0)>(a), b),
+                          _mm_mul_ps(swizzle<MATRIX4_LANES(1, 1, 2, 2)>(a), swizzle<MATRIX4_LANES(2, 3, 0, 1)>(b)));
+    }
+
+    // A * adj(B)
+    inline __m128 multiplyAdjugate2x2(__m128 a, __m128 b) {
+        return _mm_sub_ps(_mm_mul_ps(a, swizzle<MATRIX4_LANES(3, 0, 3, 0)>(b)),
+                          _mm_mul_ps(swizzle<MATRIX4_LANES(1, 0, 3, 2)>(a), swizzle<MATRIX4_LANES(2, 1, 2, 1)>(b)));
     }
-    return result;
 }
+#endif
 
 Matrix4 Matrix4::inverse() const {
-    // Simplified inverse calculation - for production use a proper matrix inverse
-    Matrix4 result = *this;
-    // This is a placeholder - implement proper matrix inverse
+#if MATH_SIMD_SSE
+    // Split into 2x2 blocks [A B; C D] and invert blockwise:
+    // each block of the inverse is a few 2x2 products of adjugates, all
+    // over the one determinant built from the block determinants
+    __m128 row0 = _mm_load_ps(&m[0]);
+    __m128 row1 = _mm_load_ps(&m[4]);
+    __m128 row2 = _mm_load_ps(&m[8]);
+    __m128 row3 = _mm_load_ps(&m[12]);
+
+    __m128 a = _mm_movelh_ps(row0, row1);
+    __m128 b = _mm_movehl_ps(row1, row0);
+    __m128 c = _mm_movelh_ps(row2, row3);
+    __m128 d = _mm_movehl_ps(row3, row2);
+
+    // Determinants of A, B, C, D in lanes 0-3
+    __m128 blockDets = _mm_sub_ps(
+        _mm_mul_ps(_mm_shuffle_ps(row0, row2, MATRIX4_LANES(0, 2, 0, 2)), _mm_shuffle_ps(row1, row3, MATRIX4_LANES(1, 3, 1, 3))),
+        _mm_mul_ps(_mm_shuffle_ps(row0, row2, MATRIX4_LANES(1, 3, 1, 3)), _mm_shuffle_ps(row1, row3, MATRIX4_LANES(0, 2, 0, 2))));
+    __m128 detA = swizzle<MATRIX4_LANES(0, 0, 0, 0)>(blockDets);
+    __m128 detB = swizzle<MATRIX4_LANES(1, 1, 1, 1)>(blockDets);
+    __m128 detC = swizzle<MATRIX4_LANES(2, 2, 2, 2)>(blockDets);
+    __m128 detD = swizzle<MATRIX4_LANES(3, 3, 3, 3)>(blockDets);
+
+    __m128 dc = adjugateMultiply2x2(d, c);
+    __m128 ab = adjugateMultiply2x2(a, b);
+    __m128 x = _mm_sub_ps(_mm_mul_ps(detD, a), multiply2x2(b, dc));
+    __m128 w = _mm_sub_ps(_mm_mul_ps(detA, d), multiply2x2(c, ab));
+    __m128 y = _mm_sub_ps(_mm_mul_ps(detB, c), multiplyAdjugate2x2(d, ab));
+    __m128 z = _mm_sub_ps(_mm_mul_ps(detC, b), multiplyAdjugate2x2(a, dc));
+
+    // det = detA detD + detB detC - tr(adj(A) B adj(D) C)
+    __m128 trace = _mm_mul_ps(ab, swizzle<MATRIX4_LANES(0, 2, 1, 3)>(dc));
+    trace = _mm_add_ps(trace, swizzle<MATRIX4_LANES(1, 0, 3, 2)>(trace));
+    trace = _mm_add_ps(trace, swizzle<MATRIX4_LANES(2, 3, 0, 1)>(trace));
+    __m128 det = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), trace);
+    if (_mm_cvtss_f32(det) == 0.0f) {
+        return identity();
+    }
+
+    __m128 scale = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), det);
+    x = _mm_mul_ps(x, scale);
+    y = _mm_mul_ps(y, scale);
+    z = _mm_mul_ps(z, scale);
+    w = _mm_mul_ps(w, scale);
+
+    // The blocks come out as adjugates; unpack them transposed into rows
+    Matrix4 result;
+    _mm_store_ps(&result.m[0], _mm_shuffle_ps(x, y, MATRIX4_LANES(3, 1, 3, 1)));
+    _mm_store_ps(&result.m[4], _mm_shuffle_ps(x, y, MATRIX4_LANES(2, 0, 2, 0)));
+    _mm_store_ps(&result.m[8], _mm_shuffle_ps(z, w, MATRIX4_LANES(3, 1, 3, 1)));
+    _mm_store_ps(&result.m[12], _mm_shuffle_ps(z, w, MATRIX4_LANES(2, 0, 2, 0)));
     return result;
+#else
+    return inverseScalar();
+#endif
 }
 
-Vector3 Matrix4::getTranslation() const {
-    return Vector3((*this)(0, 3), (*this)(1, 3), (*this)(2, 3));
+Matrix4 Matrix4::inverseScalar() const {
+    const Matrix4& a = *this;
+
+    // 2x2 minors of the top two rows (s) and bottom two rows (c)
+    float s0 = a(0, 0) * a(1, 1) - a(1, 0) * a(0, 1);
+    float s1 = a(0, 0) * a(1, 2) - a(1, 0) * a(0, 2);
+    float s2 = a(0, 0) * a(1, 3) - a(1, 0) * a(0, 3);
+    float s3 = a(0, 1) * a(1, 2) - a(1, 1) * a(0, 2);
+    float s4 = a(0, 1) * a(1, 3) - a(1, 1) * a(0, 3);
+    float s5 = a(0, 2) * a(1, 3) - a(1, 2) * a(0, 3);
+
+    float c5 = a(2, 2) * a(3, 3) - a(3, 2) * a(2, 3);
+    float c4 = a(2, 1) * a(3, 3) - a(3, 1) * a(2, 3);
+    float c3 = a(2, 1) * a(3, 2) - a(3, 1) * a(2, 2);
+    float c2 = a(2, 0) * a(3, 3) - a(3, 0) * a(2, 3);
+    float c1 = a(2, 0) * a(3, 2) - a(3, 0) * a(2, 2);
+    float c0 = a(2, 0) * a(3, 1) - a(3, 0) * a(2, 1);
+
+    float det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+    // One named result on every path, so it is built in place (a singular
+    // matrix gets the identity it starts as)
+    Matrix4 result;
+    if (det == 0.0f) {
+        return result;
+    }
+    float inv = 1.0f / det;
+
+    result(0, 0) = ( a(1, 1) * c5 - a(1, 2) * c4 + a(1, 3) * c3) * inv;
+    result(0, 1) = (-a(0, 1) * c5 + a(0, 2) * c4 - a(0, 3) * c3) * inv;
+    result(0, 2) = ( a(3, 1) * s5 - a(3, 2) * s4 + a(3, 3) * s3) * inv;
+    result(0, 3) = (-a(2, 1) * s5 + a(2, 2) * s4 - a(2, 3) * s3) * inv;
+
+    result(1, 0) = (-a(1, 0) * c5 + a(1, 2) * c2 - a(1, 3) * c1) * inv;
+    result(1, 1) = ( a(0, 0) * c5 - a(0, 2) * c2 + a(0, 3) * c1) * inv;
+    result(1, 2) = (-a(3, 0) * s5 + a(3, 2) * s2 - a(3, 3) * s1) * inv;
+    result(1, 3) = ( a(2, 0) * s5 - a(2, 2) * s2 + a(2, 3) * s1) * inv;
+
+    result(2, 0) = ( a(1, 0) * c4 - a(1, 1) * c2 + a(1, 3) * c0) * inv;
+    result(2, 1) = (-a(0, 0) * c4 + a(0, 1) * c2 - a(0, 3) * c0) * inv;
+    result(2, 2) = ( a(3, 0) * s4 - a(3, 1) * s2 + a(3, 3) * s0) * inv;
+    result(2, 3) = (-a(2, 0) * s4 + a(2, 1) * s2 - a(2, 3) * s0) * inv;
+
+    result(3, 0) = (-a(1, 0) * c3 + a(1, 1) * c1 - a(1, 2) * c0) * inv;
+    result(3, 1) = ( a(0, 0) * c3 - a(0, 1) * c1 + a(0, 2) * c0) * inv;
+    result(3, 2) = (-a(3, 0) * s3 + a(3, 1) * s1 - a(3, 2) * s0) * inv;
+    result(3, 3) = ( a(2, 0) * s3 - a(2, 1) * s1 + a(2, 2) * s0) * inv;
+    return result;
 }
 
-Vector3 Matrix4::getScale() const {
-    return Vector3(
-        Vector3((*this)(0, 0), (*this)(1, 0), (*this)(2, 0)).length(),
-        Vector3((*this)(0, 1), (*this)(1, 1), (*this)(2, 1)).length(),
-        Vector3((*this)(0, 2), (*this)(1, 2), (*this)(2, 2)).length()
-    );
-}
\ No newline at end of file
+Matrix4 Matrix4::inverseAffine() const {
+    // The inverse of the upper 3x3 has the cross products of its rows as
+    // columns; the translation is then undone in the inverted frame
+    Vector3 row0((*this)(0, 0), (*this)(0, 1), (*this)(0, 2));
+    Vector3 row1((*this)(1, 0), (*this)(1, 1), (*this)(1, 2));
+    Vector3 row2((*this)(2, 0), (*this)(2, 1), (*this)(2, 2));
+    Vector3 col0 = row1.cross(row2);
+    Vector3 col1 = row2.cross(row0);
+    Vector3 col2 = row0.cross(row1);
+
+    float det = row0.dot(col0);
+    Matrix4 result;
+    if (det == 0.0f) {
+        return result;
+    }
+    float inv = 1.0f / det;
+    col0 *= inv;
+    col1 *= inv;
+    col2 *= inv;
+
+    Vector3 t = getTranslation();
+    result(0, 0) = col0.x; result(0, 1) = col1.x; result(0, 2) = col2.x;
+    result(1, 0) = col0.y; result(1, 1) = col1.y; result(1, 2) = col2.y;
+    result(2, 0) = col0.z; result(2, 1) = col1.z; result(2, 2) = col2.z;
+    result(0, 3) = -(col0.x * t.x + col1.x * t.y + col2.x * t.z);
+    result(1, 3) = -(col0.y * t.x + col1.y * t.y + col2.y * t.z);
+    result(2, 3) = -(col0.z * t.x + col1.z * t.y + col2.z * t.z);
+    return result;
+}
+
+Matrix4 Matrix4::normalMatrix() const {
+    // Transposing the affine inverse's 3x3 turns those cross products into rows
+    Vector3 row0((*this)(0, 0), (*this)(0, 1), (*this)(0, 2));
+    Vector3 row1((*this)(1, 0), (*this)(1, 1), (*this)(1, 2));
+    Vector3 row2((*this)(2, 0), (*this)(2, 1), (*this)(2, 2));
+    Vector3 cofactor0 = row1.cross(row2);
+    Vector3 cofactor1 = row2.cross(row0);
+    Vector3 cofactor2 = row0.cross(row1);
+
+    float det = row0.dot(cofactor0);
+    Matrix4 result;
+    if (det == 0.0f) {
+        return result;
+    }
+    float inv = 1.0f / det;
+    cofactor0 *= inv;
+    cofactor1 *= inv;
+    cofactor2 *= inv;
+
+    result(0, 0) = cofactor0.x; result(0, 1) = cofactor0.y; result(0, 2) = cofactor0.z;
+    result(1, 0) = cofactor1.x; result(1, 1) = cofactor1.y; result(1, 2) = cofactor1.z;
+    result(2, 0) = cofactor2.x; result(2, 1) = cofactor2.y; result(2, 2) = cofactor2.z;
+    return result;
+}
@@ -1,35 +1,176 @@
 #pragma once
+#include "SIMD.h"
 #include "Vector3.h"
+#include <type_traits>
 
+// Row-major 4x4 matrix: element (row, col) is m[row * 4 + col].
+// Products and transforms are in the header so they inline into callers;
+// with SSE or NEON available the matrix product runs on whole rows at once.
+// The *Scalar versions are the reference the SIMD paths must match.
 class Matrix4 {
 public:
-    float m[16];
+    alignas(16) float m[16];
+
+    constexpr Matrix4()
+        : m{ 1.0f, 0.0f, 0.0f, 0.0f,
+             0.0f, 1.0f, 0.0f, 0.0f,
+             0.0f, 0.0f, 1.0f, 0.0f,
+             0.0f, 0.0f, 0.0f, 1.0f } {}
 
-    Matrix4();
-    Matrix4(const Matrix4& other);
-    
     // Matrix operations
-    Matrix4 operator*(const Matrix4& other) const;
-    Vector3 operator*(const Vector3& v) const;
-    Matrix4& operator*=(const Matrix4& other);
+    Matrix4 operator*(const Matrix4& other) const {
+#if MATH_SIMD_SSE
+        __m128 b0 = _mm_load_ps(&other.m[0]);
+        __m128 b1 = _mm_load_ps(&other.m[4]);
+        __m128 b2 = _mm_load_ps(&other.m[8]);
+        __m128 b3 = _mm_load_ps(&other.m[12]);
+
+        // Each result row is this row's weights applied to other's rows
+        Matrix4 result;
+        for (int i = 0; i < 4; i++) {
+            const float* row = &m[i * 4];
+            __m128 sum = _mm_mul_ps(_mm_set1_ps(row[0]), b0);
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(row[1]), b1));
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(row[2]), b2));
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(row[3]), b3));
+            _mm_store_ps(&result.m[i * 4], sum);
+        }
+        return result;
+#elif MATH_SIMD_NEON
+        float32x4_t b0 = vld1q_f32(&other.m[0]);
+        float32x4_t b1 = vld1q_f32(&other.m[4]);
+        float32x4_t b2 = vld1q_f32(&other.m[8]);
+        float32x4_t b3 = vld1q_f32(&other.m[12]);
+
+        Matrix4 result;
+        for (int i = 0; i < 4; i++) {
+            const float* row = &m[i * 4];
+            float32x4_t sum = vmulq_n_f32(b0, row[0]);
+            sum = vmlaq_n_f32(sum, b1, row[1]);
+            sum = vmlaq_n_f32(sum, b2, row[2]);
+            sum = vmlaq_n_f32(sum, b3, row[3]);
+            vst1q_f32(&result.m[i * 4], sum);
+        }
+        return result;
+#else
+        return multiplyScalar(other);
+#endif
+    }
+
+    // Transforms a point, with the perspective divide. Scalar on purpose:
+    // packing one Vector3 into lanes costs more than the lanes save, so
+    // vectorising pays off only in loops over many points.
+    Vector3 operator*(const Vector3& v) const {
+        return transformPointScalar(v);
+    }
+
+    Matrix4& operator*=(const Matrix4& other) {
+        *this = *this * other;
+        return *this;
+    }
+
+    // Scalar reference implementations
+    Matrix4 multiplyScalar(const Matrix4& other) const {
+        Matrix4 result;
+        for (int i = 0; i < 4; i++) {
+            for (int j = 0; j < 4; j++) {
+                float sum = (*this)(i, 0) * other(0, j);
+                for (int k = 1; k < 4; k++) {
+                    sum += (*this)(i, k) * other(k, j);
+                }
+                result(i, j) = sum;
+            }
+        }
+        return result;
+    }
+
+    Vector3 transformPointScalar(const Vector3& v) const {
+        float out[4];
+        for (int i = 0; i < 4; i++) {
+            out[i] = (*this)(i, 0) * v.x + (*this)(i, 1) * v.y + (*this)(i, 2) * v.z + (*this)(i, 3);
+        }
+        return perspectiveDivide(out);
+    }
 
     // Access elements
-    float& operator()(int row, int col);
-    const float& operator()(int row, int col) const;
+    float& operator()(int row, int col) { return m[row * 4 + col]; }
+    const float& operator()(int row, int col) const { return m[row * 4 + col]; }
 
     // Static factory methods
-    static Matrix4 identity();
-    static Matrix4 translation(const Vector3& translation);
+    static Matrix4 identity() { return Matrix4(); }
+    static Matrix4 translation(const Vector3& translation) {
+        Matrix4 result;
+        result(0, 3) = translation.x;
+        result(1, 3) = translation.y;
+        result(2, 3) = translation.z;
+        return result;
+    }
     static Matrix4 rotation(const Vector3& axis, float angle);
-    static Matrix4 scale(const Vector3& scale);
+    static Matrix4 scale(const Vector3& scale) {
+        Matrix4 result;
+        result(0, 0) = scale.x;
+        result(1, 1) = scale.y;
+        result(2, 2) = scale.z;
+        return result;
+    }
     static Matrix4 lookAt(const Vector3& eye, const Vector3& center, const Vector3& up);
     static Matrix4 perspective(float fov, float aspect, float near, float far);
     static Matrix4 orthographic(float left, float right, float bottom, float top, float near, float far);
 
     // Utility functions
-    Matrix4 transpose() const;
+    Matrix4 transpose() const {
+        Matrix4 result;
+        for (int i = 0; i < 4; i++) {
+            for (int j = 0; j < 4; j++) {
+                result(i, j) = (*this)(j, i);
+            }
+        }
+        return result;
+    }
+
+    // General inverse by cofactors (SSE on x86); identity if singular
     Matrix4 inverse() const;
-    Vector3 getTranslation() const;
-    Vector3 getScale() const;
+    Matrix4 inverseScalar() const;
+
+    // Inverse of a matrix whose bottom row is 0 0 0 1 (model matrices with
+    // scale or shear); identity if the upper 3x3 is singular
+    Matrix4 inverseAffine() const;
+
+    // Inverse of rotation plus translation only, such as a lookAt view:
+    // transpose the rotation and rotate the negated translation
+    Matrix4 inverseRigid() const {
+        Matrix4 result;
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++) {
+                result(i, j) = (*this)(j, i);
+            }
+            result(i, 3) = -((*this)(0, i) * m[3] + (*this)(1, i) * m[7] + (*this)(2, i) * m[11]);
+        }
+        return result;
+    }
+
+    // Inverse-transpose of the upper 3x3, for transforming normals; no
+    // translation. Identity if the upper 3x3 is singular.
+    Matrix4 normalMatrix() const;
+
+    Vector3 getTranslation() const { return Vector3((*this)(0, 3), (*this)(1, 3), (*this)(2, 3)); }
+    Vector3 getScale() const {
+        return Vector3(
+            Vector3((*this)(0, 0), (*this)(1, 0), (*this)(2, 0)).length(),
+            Vector3((*this)(0, 1), (*this)(1, 1), (*this)(2, 1)).length(),
+            Vector3((*this)(0, 2), (*this)(1, 2), (*this)(2, 2)).length()
+        );
+    }
     const float* data() const { return &m[0]; }  // Get raw data pointer
-};
\ No newline at end of file
+
+private:
+    static Vector3 perspectiveDivide(const float* out) {
+        float w = out[3];
+        if (w != 0.0f) {
+            w = 1.0f / w;
+        }
+        return Vector3(out[0] * w, out[1] * w, out[2] * w);
+    }
+};
+
+static_assert(std::is_trivially_copyable<Matrix4>::value, "Matrix4 must stay trivially copyable");
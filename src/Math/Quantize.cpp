@@ -0,0 +1,241 @@
+#include "Quantize.h"
+#include "SIMD.h"
+
+// The SSE2 half conversions are the same bit manipulations as the scalar
+// ones four lanes at a time (after Fabian Giesen's public domain versions).
+// AArch64 has conversion instructions that round the same way; 32-bit ARM
+// only has them with the optional FP16 extension, so it stays scalar.
+#if MATH_SIMD_NEON && defined(__aarch64__)
+    #define QUANTIZE_NEON_HALF 1
+#else
+    #define QUANTIZE_NEON_HALF 0
+#endif
+
+#if MATH_SIMD_SSE
+namespace {
+    // Four floats to halves, one per 32-bit lane
+    inline __m128i halvesFromFloats(__m128 value) {
+        const __m128i signMask = _mm_set1_epi32(static_cast<int>(0x80000000u));
+        const __m128i halfMax = _mm_set1_epi32((127 + 16) << 23);
+        const __m128i minNormal = _mm_set1_epi32((127 - 14) << 23);
+        const __m128i subnormalMagic = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+        const __m128i normalBias = _mm_set1_epi32(0xfff - ((127 - 15) << 23));
+
+        __m128i bits = _mm_castps_si128(value);
+        __m128i sign = _mm_and_si128(bits, signMask);
+        __m128i magnitude = _mm_xor_si128(bits, sign);
+
+        __m128i isRegular = _mm_cmpgt_epi32(halfMax, magnitude);
+        __m128i isSubnormal = _mm_cmpgt_epi32(minNormal, magnitude);
+        __m128 isNaN = _mm_cmpunord_ps(_mm_castsi128_ps(magnitude), _mm_castsi128_ps(magnitude));
+        __m128i special = _mm_or_si128(_mm_set1_epi32(0x7c00), _mm_and_si128(_mm_castps_si128(isNaN), _mm_set1_epi32(0x200)));
+
+        __m128 subnormalSum = _mm_add_ps(_mm_castsi128_ps(magnitude), _mm_castsi128_ps(subnormalMagic));
+        __m128i subnormal = _mm_sub_epi32(_mm_castps_si128(subnormalSum), subnormalMagic);
+
+        __m128i mantissaOdd = _mm_srai_epi32(_mm_slli_epi32(magnitude, 31 - 13), 31);
+        __m128i normal = _mm_srli_epi32(_mm_sub_epi32(_mm_add_epi32(magnitude, normalBias), mantissaOdd), 13);
+
+        __m128i finite = _mm_or_si128(_mm_and_si128(isSubnormal, subnormal), _mm_andnot_si128(isSubnormal, normal));
+        __m128i half = _mm_or_si128(_mm_and_si128(isRegular, finite), _mm_andnot_si128(isRegular, special));
+        // The arithmetic shift sign-extends negative halves, so a signed
+        // saturating pack keeps their low 16 bits
+        return _mm_or_si128(half, _mm_srai_epi32(sign, 16));
+    }
+
+    // Four halves, zero-extended to 32-bit lanes, to floats
+    inline __m128 floatsFromHalves(__m128i halves) {
+        const __m128i magnitudeMask = _mm_set1_epi32(0x7fff);
+        const __m128 rescale = _mm_castsi128_ps(_mm_set1_epi32((254 - 15) << 23));
+        const __m128i largestFinite = _mm_set1_epi32(0x7bff);
+        const __m128 infinityExponent = _mm_castsi128_ps(_mm_set1_epi32(255 << 23));
+
+        __m128i magnitude = _mm_and_si128(halves, magnitudeMask);
+        __m128i sign = _mm_slli_epi32(_mm_xor_si128(halves, magnitude), 16);
+        __m128 value = _mm_mul_ps(_mm_castsi128_ps(_mm_slli_epi32(magnitude, 13)), rescale);
+        __m128 wasSpecial = _mm_castsi128_ps(_mm_cmpgt_epi32(magnitude, largestFinite));
+        __m128 exponent = _mm_and_ps(wasSpecial, infinityExponent);
+        return _mm_or_ps(value, _mm_or_ps(_mm_castsi128_ps(sign), exponent));
+    }
+}
+#endif
+
+namespace Quantize {
+    void floatsToHalves(const float* in, uint16_t* out, size_t count) {
+        size_t i = 0;
+#if MATH_SIMD_SSE
+        for (; i + 8 <= count; i += 8) {
+            __m128i lo = halvesFromFloats(_mm_loadu_ps(in + i));
+            __m128i hi = halvesFromFloats(_mm_loadu_ps(in + i + 4));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packs_epi32(lo, hi));
+        }
+#elif QUANTIZE_NEON_HALF
+        for (; i + 4 <= count; i += 4) {
+            vst1_u16(out + i, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(in + i))));
+        }
+#endif
+        for (; i < count; i++) {
+            out[i] = floatToHalf(in[i]);
+        }
+    }
+
+    void halvesToFloats(const uint16_t* in, float* out, size_t count) {
+        size_t i = 0;
+#if MATH_SIMD_SSE
+        const __m128i zero = _mm_setzero_si128();
+        for (; i + 8 <= count; i += 8) {
+            __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+            _mm_storeu_ps(out + i, floatsFromHalves(_mm_unpacklo_epi16(packed, zero)));
+            _mm_storeu_ps(out + i + 4, floatsFromHalves(_mm_unpackhi_epi16(packed, zero)));
+        }
+#elif QUANTIZE_NEON_HALF
+        for (; i + 4 <= count; i += 4) {
+            vst1q_f32(out + i, vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(in + i))));
+        }
+#endif
+        for (; i < count; i++) {
+            out[i] = halfToFloat(in[i]);
+        }
+    }
+
+    void encodeHalves(const TransformBatch::Vector3Arrays& vectors, Packed3Arrays& out) {
+        size_t count = vectors.size();
+        out.resize(count);
+        if (count == 0) return;
+
+        floatsToHalves(vectors.x.data(), out.x.data(), count);
+        floatsToHalves(vectors.y.data(), out.y.data(), count);
+        floatsToHalves(vectors.z.data(), out.z.data(), count);
+    }
+
+    void decodeHalves(const Packed3Arrays& halves, TransformBatch::Vector3Arrays& out) {
+        size_t count = halves.size();
+        out.resize(count);
+        if (count == 0) return;
+
+        halvesToFloats(halves.x.data(), out.x.data(), count);
+        halvesToFloats(halves.y.data(), out.y.data(), count);
+        halvesToFloats(halves.z.data(), out.z.data(), count);
+    }
+
+    namespace {
+        // One axis of PositionRange::encode and decode
+        void encodeAxis(const float* in, uint16_t* out, size_t count, float minimum, float stepsPerUnit) {
+            size_t i = 0;
+#if MATH_SIMD_SSE
+            const __m128 low = _mm_set1_ps(minimum);
+            const __m128 scale = _mm_set1_ps(stepsPerUnit);
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 steps = _mm_set1_ps(65535.0f);
+            const __m128 half = _mm_set1_ps(0.5f);
+            const __m128i bias = _mm_set1_epi32(32768);
+            const __m128i flip = _mm_set1_epi16(static_cast<short>(0x8000));
+
+            for (; i + 8 <= count; i += 8) {
+                __m128 tLo = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(in + i), low), scale);
+                __m128 tHi = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(in + i + 4), low), scale);
+                // max returns its second operand for NaN, like the scalar version
+                tLo = _mm_min_ps(_mm_max_ps(tLo, zero), steps);
+                tHi = _mm_min_ps(_mm_max_ps(tHi, zero), steps);
+                // SSE2 only has a signed pack: shift 0..65535 down to signed
+                // range, pack, then flip the top bit back
+                __m128i stepsLo = _mm_sub_epi32(_mm_cvttps_epi32(_mm_add_ps(tLo, half)), bias);
+                __m128i stepsHi = _mm_sub_epi32(_mm_cvttps_epi32(_mm_add_ps(tHi, half)), bias);
+                __m128i packed = _mm_xor_si128(_mm_packs_epi32(stepsLo, stepsHi), flip);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), packed);
+            }
+#elif MATH_SIMD_NEON
+            const float32x4_t low = vdupq_n_f32(minimum);
+            const float32x4_t scale = vdupq_n_f32(stepsPerUnit);
+            const float32x4_t zero = vdupq_n_f32(0.0f);
+            const float32x4_t steps = vdupq_n_f32(65535.0f);
+            const float32x4_t half = vdupq_n_f32(0.5f);
+
+            for (; i + 4 <= count; i += 4) {
+                float32x4_t t = vmulq_f32(vsubq_f32(vld1q_f32(in + i), low), scale);
+                // NaN survives min/max here but converts to 0
+                t = vminq_f32(vmaxq_f32(t, zero), steps);
+                vst1_u16(out + i, vmovn_u32(vcvtq_u32_f32(vaddq_f32(t, half))));
+            }
+#endif
+            for (; i < count; i++) {
+                float t = (in[i] - minimum) * stepsPerUnit;
+                t = t > 0.0f ? t : 0.0f;
+                t = t < 65535.0f ? t : 65535.0f;
+                out[i] = static_cast<uint16_t>(t + 0.5f);
+            }
+        }
+
+        void decodeAxis(const uint16_t* in, float* out, size_t count, float minimum, float unitsPerStep) {
+            size_t i = 0;
+#if MATH_SIMD_SSE
+            const __m128 low = _mm_set1_ps(minimum);
+            const __m128 scale = _mm_set1_ps(unitsPerStep);
+            const __m128i zero = _mm_setzero_si128();
+
+            for (; i + 8 <= count; i += 8) {
+                __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+                __m128 lo = _mm_cvtepi32_ps(_mm_unpacklo_epi16(packed, zero));
+                __m128 hi = _mm_cvtepi32_ps(_mm_unpackhi_epi16(packed, zero));
+                _mm_storeu_ps(out + i, _mm_add_ps(low, _mm_mul_ps(lo, scale)));
+                _mm_storeu_ps(out + i + 4, _mm_add_ps(low, _mm_mul_ps(hi, scale)));
+            }
+#elif MATH_SIMD_NEON
+            const float32x4_t low = vdupq_n_f32(minimum);
+            const float32x4_t scale = vdupq_n_f32(unitsPerStep);
+
+            for (; i + 4 <= count; i += 4) {
+                float32x4_t q = vcvtq_f32_u32(vmovl_u16(vld1_u16(in + i)));
+                vst1q_f32(out + i, vaddq_f32(low, vmulq_f32(q, scale)));
+            }
+#endif
+            for (; i < count; i++) {
+                out[i] = minimum + in[i] * unitsPerStep;
+            }
+        }
+    }
+
+    void encodePositions(const PositionRange& range, const TransformBatch::Vector3Arrays& positions, Packed3Arrays& out) {
+        size_t count = positions.size();
+        out.resize(count);
+        if (count == 0) return;
+
+        Vector3 minimum = range.getMinimum();
+        Vector3 scale = range.getStepsPerUnit();
+        encodeAxis(positions.x.data(), out.x.data(), count, minimum.x, scale.x);
+        encodeAxis(positions.y.data(), out.y.data(), count, minimum.y, scale.y);
+        encodeAxis(positions.z.data(), out.z.data(), count, minimum.z, scale.z);
+    }
+
+    void decodePositions(const PositionRange& range, const Packed3Arrays& packed, TransformBatch::Vector3Arrays& out) {
+        size_t count = packed.size();
+        out.resize(count);
+        if (count == 0) return;
+
+        Vector3 minimum = range.getMinimum();
+        Vector3 resolution = range.getResolution();
+        decodeAxis(packed.x.data(), out.x.data(), count, minimum.x, resolution.x);
+        decodeAxis(packed.y.data(), out.y.data(), count, minimum.y, resolution.y);
+        decodeAxis(packed.z.data(), out.z.data(), count, minimum.z, resolution.z);
+    }
+
+    void encodeRotations(const TransformBatch::QuaternionArrays& rotations, std::vector<PackedQuaternion>& out) {
+        size_t count = rotations.size();
+        out.resize(count);
+        for (size_t i = 0; i < count; i++) {
+            out[i] = PackedQuaternion::encode(rotations.get(i));
+        }
+    }
+
+    void decodeRotations(const std::vector<PackedQuaternion>& packed, TransformBatch::QuaternionArrays& out) {
+        size_t count = packed.size();
+        out.resize(count);
+        for (size_t i = 0; i < count; i++) {
+            Quaternion q = packed[i].decode();
+            out.x[i] = q.x;
+            out.y[i] = q.y;
+            out.z[i] = q.z;
+            out.w[i] = q.w;
+        }
+    }
+}
@@ -0,0 +1,208 @@
+#pragma once
+#include "Vector3.h"
+#include "Quaternion.h"
+#include "TransformBatch.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Packed transform state for anything that buffers or sends a lot of it
+// (rewind history, replays, replication):
+//
+//   HalfVector3       6 bytes   IEEE half per component; velocities and
+//                               directions (11-bit precision, |v| < 65504)
+//   PackedQuaternion  4 bytes   smallest three at 10 bits each; at most
+//                               2e-3 error per component, under 0.25 degrees
+//   PackedPosition    6 bytes   16 bits per axis across a PositionRange;
+//                               a 1 km range resolves to 1.5 cm
+//
+// against 12, 16 and 12 bytes unpacked. The single-value conversions are
+// here; the batch ones convert whole structure-of-arrays streams with SSE2
+// or NEON where the build has it, and give the same results (NaN payloads
+// aside).
+namespace Quantize {
+    namespace Detail {
+        inline uint32_t floatBits(float value) {
+            uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            return bits;
+        }
+
+        inline float bitsFloat(uint32_t bits) {
+            float value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+    }
+
+    // Round to nearest even. Values past the half range become infinity,
+    // NaN stays NaN and tiny values become half subnormals or zero.
+    inline uint16_t floatToHalf(float value) {
+        uint32_t bits = Detail::floatBits(value);
+        uint32_t sign = bits & 0x80000000u;
+        bits ^= sign;
+
+        uint32_t half;
+        if (bits >= ((127u + 16u) << 23)) {
+            half = bits > (255u << 23) ? 0x7e00u : 0x7c00u;
+        } else if (bits < (113u << 23)) {
+            // Adding a magic number lines the subnormal mantissa up at the
+            // bottom of the float, rounded by the FPU
+            const uint32_t magic = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+            half = Detail::floatBits(Detail::bitsFloat(bits) + Detail::bitsFloat(magic)) - magic;
+        } else {
+            uint32_t mantissaOdd = (bits >> 13) & 1u;
+            bits += (static_cast<uint32_t>(15 - 127) << 23) + 0xfffu;
+            bits += mantissaOdd;
+            half = bits >> 13;
+        }
+        return static_cast<uint16_t>(half | (sign >> 16));
+    }
+
+    // Exact: every half is a float
+    inline float halfToFloat(uint16_t half) {
+        uint32_t magnitude = half & 0x7fffu;
+        // Rescaling by 2^112 fixes the exponent bias and normalizes subnormals
+        float value = Detail::bitsFloat(magnitude << 13) * Detail::bitsFloat((254u - 15u) << 23);
+        uint32_t bits = Detail::floatBits(value);
+        if (magnitude > 0x7bffu) bits |= 255u << 23;  // Infinity and NaN
+        return Detail::bitsFloat(bits | (static_cast<uint32_t>(half & 0x8000u) << 16));
+    }
+
+    struct HalfVector3 {
+        uint16_t x, y, z;
+
+        static HalfVector3 encode(const Vector3& v) {
+            return HalfVector3{ floatToHalf(v.x), floatToHalf(v.y), floatToHalf(v.z) };
+        }
+
+        Vector3 decode() const {
+            return Vector3(halfToFloat(x), halfToFloat(y), halfToFloat(z));
+        }
+    };
+
+    // Smallest three: a unit quaternion's largest component follows from
+    // the other three, so only its index (2 bits) and the other three (10
+    // bits each, all within +-1/sqrt(2)) are stored. q and -q are the same
+    // rotation, so the sign is chosen to make the dropped component positive.
+    struct PackedQuaternion {
+        uint32_t bits;
+
+        static PackedQuaternion encode(const Quaternion& q) {
+            const float components[4] = { q.x, q.y, q.z, q.w };
+            int largest = 0;
+            for (int i = 1; i < 4; i++) {
+                if (std::fabs(components[i]) > std::fabs(components[largest])) largest = i;
+            }
+            float sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+
+            uint32_t packed = static_cast<uint32_t>(largest);
+            for (int i = 0; i < 4; i++) {
+                if (i == largest) continue;
+                // [-1/sqrt(2), 1/sqrt(2)] onto 1..1023 with 0 at 512, so
+                // an exactly zero component (any single-axis rotation) stays 0
+                float scaled = std::clamp(components[i] * sign * 1.41421356f, -1.0f, 1.0f) * 511.0f;
+                int step = static_cast<int>(scaled + (scaled < 0.0f ? -0.5f : 0.5f));
+                packed = (packed << 10) | (static_cast<uint32_t>(step + 512) & 0x3ffu);
+            }
+            return PackedQuaternion{ packed };
+        }
+
+        Quaternion decode() const {
+            int largest = static_cast<int>(bits >> 30);
+            float components[4];
+            float sumSquares = 0.0f;
+            int shift = 20;
+            for (int i = 0; i < 4; i++) {
+                if (i == largest) continue;
+                int step = static_cast<int>((bits >> shift) & 0x3ffu) - 512;
+                components[i] = static_cast<float>(step) * (0.707106781f / 511.0f);
+                sumSquares += components[i] * components[i];
+                shift -= 10;
+            }
+            components[largest] = std::sqrt(std::max(0.0f, 1.0f - sumSquares));
+            return Quaternion(components[0], components[1], components[2], components[3]);
+        }
+    };
+
+    struct PackedPosition {
+        uint16_t x, y, z;
+    };
+
+    // The box PackedPositions are quantized across. Positions outside it
+    // clamp to its faces.
+    class PositionRange {
+    private:
+        Vector3 minimum;
+        Vector3 stepsPerUnit;
+        Vector3 unitsPerStep;
+
+        static constexpr float Steps = 65535.0f;
+
+        static constexpr float steps(float low, float high) {
+            return high > low ? Steps / (high - low) : 0.0f;
+        }
+
+        // Written so NaN lands on 0, the same as the SIMD min/max do
+        static constexpr uint16_t quantize(float value, float low, float scale) {
+            float t = (value - low) * scale;
+            t = t > 0.0f ? t : 0.0f;
+            t = t < Steps ? t : Steps;
+            return static_cast<uint16_t>(t + 0.5f);
+        }
+
+    public:
+        constexpr PositionRange(const Vector3& min, const Vector3& max)
+            : minimum(min)
+            , stepsPerUnit(steps(min.x, max.x), steps(min.y, max.y), steps(min.z, max.z))
+            , unitsPerStep((max.x - min.x) / Steps, (max.y - min.y) / Steps, (max.z - min.z) / Steps) {}
+
+        constexpr PackedPosition encode(const Vector3& position) const {
+            return PackedPosition{
+                quantize(position.x, minimum.x, stepsPerUnit.x),
+                quantize(position.y, minimum.y, stepsPerUnit.y),
+                quantize(position.z, minimum.z, stepsPerUnit.z)
+            };
+        }
+
+        constexpr Vector3 decode(const PackedPosition& packed) const {
+            return Vector3(minimum.x + packed.x * unitsPerStep.x,
+                           minimum.y + packed.y * unitsPerStep.y,
+                           minimum.z + packed.z * unitsPerStep.z);
+        }
+
+        constexpr Vector3 getMinimum() const { return minimum; }
+        constexpr Vector3 getStepsPerUnit() const { return stepsPerUnit; }
+        // Size of one step; the worst-case error is half of it
+        constexpr Vector3 getResolution() const { return unitsPerStep; }
+    };
+
+    // Structure-of-arrays streams of packed values, matching
+    // TransformBatch's unpacked ones
+    struct Packed3Arrays {
+        std::vector<uint16_t> x, y, z;
+
+        size_t size() const { return x.size(); }
+        void clear() { x.clear(); y.clear(); z.clear(); }
+        void resize(size_t count) { x.resize(count); y.resize(count); z.resize(count); }
+    };
+
+    // Raw conversions over count values; the batch functions below run
+    // these per component
+    void floatsToHalves(const float* in, uint16_t* out, size_t count);
+    void halvesToFloats(const uint16_t* in, float* out, size_t count);
+
+    void encodeHalves(const TransformBatch::Vector3Arrays& vectors, Packed3Arrays& out);
+    void decodeHalves(const Packed3Arrays& halves, TransformBatch::Vector3Arrays& out);
+
+    void encodePositions(const PositionRange& range, const TransformBatch::Vector3Arrays& positions, Packed3Arrays& out);
+    void decodePositions(const PositionRange& range, const Packed3Arrays& packed, TransformBatch::Vector3Arrays& out);
+
+    // Picking the dropped component is a per-element branch, so these
+    // stay scalar
+    void encodeRotations(const TransformBatch::QuaternionArrays& rotations, std::vector<PackedQuaternion>& out);
+    void decodeRotations(const std::vector<PackedQuaternion>& packed, TransformBatch::QuaternionArrays& out);
+}
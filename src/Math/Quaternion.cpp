@@ -1,147 +1,40 @@
 #include "Quaternion.h"
 #include "Matrix4.h"
+#include "SimMath.h"
 #include <cmath>
 #include <algorithm>
 
-Quaternion Quaternion::operator+(const Quaternion& other) const {
-    return Quaternion(x + other.x, y + other.y, z + other.z, w + other.w);
-}
-
-Quaternion Quaternion::operator-(const Quaternion& other) const {
-    return Quaternion(x - other.x, y - other.y, z - other.z, w - other.w);
-}
-
-Quaternion Quaternion::operator*(const Quaternion& other) const {
-    return Quaternion(
-        w * other.x + x * other.w + y * other.z - z * other.y,
-        w * other.y - x * other.z + y * other.w + z * other.x,
-        w * other.z + x * other.y - y * other.x + z * other.w,
-        w * other.w - x * other.x - y * other.y - z * other.z
-    );
-}
-
-Quaternion Quaternion::operator*(float scalar) const {
-    return Quaternion(x * scalar, y * scalar, z * scalar, w * scalar);
-}
-
-Vector3 Quaternion::operator*(const Vector3& v) const {
-    // Convert vector to quaternion (0, v.x, v.y, v.z)
-    Quaternion vecQuat(v.x, v.y, v.z, 0.0f);
-    
-    // Perform rotation: q * v * q^-1
-    Quaternion result = *this * vecQuat * inverse();
-    
-    // Extract the vector part
-    return Vector3(result.x, result.y, result.z);
-}
-
-Quaternion& Quaternion::operator*=(const Quaternion& other) {
-    *this = *this * other;
-    return *this;
-}
-
-float Quaternion::length() const {
-    return std::sqrt(x * x + y * y + z * z + w * w);
-}
-
-float Quaternion::lengthSquared() const {
-    return x * x + y * y + z * z + w * w;
-}
-
-Quaternion Quaternion::normalized() const {
-    float len = length();
-    if (len > 0.0f) {
-        return *this * (1.0f / len);
-    }
-    return identity();
-}
-
-void Quaternion::normalize() {
-    float len = length();
-    if (len > 0.0f) {
-        *this = *this * (1.0f / len);
-    }
-}
-
-Quaternion Quaternion::conjugate() const {
-    return Quaternion(-x, -y, -z, w);
-}
-
-Quaternion Quaternion::inverse() const {
-    float lenSq = lengthSquared();
-    if (lenSq > 0.0f) {
-        Quaternion conj = conjugate();
-        return conj * (1.0f / lenSq);
-    }
-    return identity();
-}
-
-Matrix4 Quaternion::toMatrix4() const {
-    float xx = x * x;
-    float yy = y * y;
-    float zz = z * z;
-    float xy = x * y;
-    float xz = x * z;
-    float yz = y * z;
-    float wx = w * x;
-    float wy = w * y;
-    float wz = w * z;
-
-    Matrix4 result;
-    result(0, 0) = 1.0f - 2.0f * (yy + zz);
-    result(0, 1) = 2.0f * (xy - wz);
-    result(0, 2) = 2.0f * (xz + wy);
-    result(0, 3) = 0.0f;
-
-    result(1, 0) = 2.0f * (xy + wz);
-    result(1, 1) = 1.0f - 2.0f * (xx + zz);
-    result(1, 2) = 2.0f * (yz - wx);
-    result(1, 3) = 0.0f;
-
-    result(2, 0) = 2.0f * (xz - wy);
-    result(2, 1) = 2.0f * (yz + wx);
-    result(2, 2) = 1.0f - 2.0f * (xx + yy);
-    result(2, 3) = 0.0f;
-
-    result(3, 0) = 0.0f;
-    result(3, 1) = 0.0f;
-    result(3, 2) = 0.0f;
-    result(3, 3) = 1.0f;
-
-    return result;
-}
-
 Vector3 Quaternion::toEulerAngles() const {
     float roll, pitch, yaw;
 
     // Roll (x-axis rotation)
     float sinr_cosp = 2.0f * (w * x + y * z);
     float cosr_cosp = 1.0f - 2.0f * (x * x + y * y);
-    roll = std::atan2(sinr_cosp, cosr_cosp);
+    roll = SimMath::atan2(sinr_cosp, cosr_cosp);
 
     // Pitch (y-axis rotation)
     float sinp = 2.0f * (w * y - z * x);
     if (std::abs(sinp) >= 1.0f) {
         pitch = std::copysign(M_PI / 2.0f, sinp); // Use 90 degrees if out of range
     } else {
-        pitch = std::asin(sinp);
+        pitch = SimMath::asin(sinp);
     }
 
     // Yaw (z-axis rotation)
     float siny_cosp = 2.0f * (w * z + x * y);
     float cosy_cosp = 1.0f - 2.0f * (y * y + z * z);
-    yaw = std::atan2(siny_cosp, cosy_cosp);
+    yaw = SimMath::atan2(siny_cosp, cosy_cosp);
 
     return Vector3(roll, pitch, yaw);
 }
 
 Quaternion Quaternion::fromEulerAngles(const Vector3& euler) {
-    float cr = std::cos(euler.x * 0.5f);
-    float sr = std::sin(euler.x * 0.5f);
-    float cp = std::cos(euler.y * 0.5f);
-    float sp = std::sin(euler.y * 0.5f);
-    float cy = std::cos(euler.z * 0.5f);
-    float sy = std::sin(euler.z * 0.5f);
+    float cr = SimMath::cos(euler.x * 0.5f);
+    float sr = SimMath::sin(euler.x * 0.5f);
+    float cp = SimMath::cos(euler.y * 0.5f);
+    float sp = SimMath::sin(euler.y * 0.5f);
+    float cy = SimMath::cos(euler.z * 0.5f);
+    float sy = SimMath::sin(euler.z * 0.5f);
 
     return Quaternion(
         sr * cp * cy - cr * sp * sy,
@@ -153,14 +46,14 @@ Quaternion Quaternion::fromEulerAngles(const Vector3& euler) {
 
 Quaternion Quaternion::fromAxisAngle(const Vector3& axis, float angle) {
     float halfAngle = angle * 0.5f;
-    float s = std::sin(halfAngle);
+    float s = SimMath::sin(halfAngle);
     Vector3 normalizedAxis = axis.normalized();
     
     return Quaternion(
         normalizedAxis.x * s,
         normalizedAxis.y * s,
         normalizedAxis.z * s,
-        std::cos(halfAngle)
+        SimMath::cos(halfAngle)
     );
 }
 
@@ -206,10 +99,6 @@ Quaternion Quaternion::lookRotation(const Vector3& forward, const Vector3& up) {
     }
 }
 
-Quaternion Quaternion::identity() {
-    return Quaternion(0.0f, 0.0f, 0.0f, 1.0f);
-}
-
 Quaternion Quaternion::slerp(const Quaternion& a, const Quaternion& b, float t) {
     t = std::clamp(t, 0.0f, 1.0f);
     
@@ -224,12 +113,12 @@ Quaternion Quaternion::slerp(const Quaternion& a, const Quaternion& b, float t)
         return (a + (b - a) * t).normalized();
     }
     
-    float theta_0 = std::acos(std::abs(dot));
-    float sin_theta_0 = std::sin(theta_0);
+    float theta_0 = SimMath::acos(std::abs(dot));
+    float sin_theta_0 = SimMath::sin(theta_0);
     float theta = theta_0 * t;
-    float sin_theta = std::sin(theta);
+    float sin_theta = SimMath::sin(theta);
     
-    float s0 = std::cos(theta) - dot * sin_theta / sin_theta_0;
+    float s0 = SimMath::cos(theta) - dot * sin_theta / sin_theta_0;
     float s1 = sin_theta / sin_theta_0;
     
     return (a * s0 + b * s1).normalized();
@@ -1,41 +1,188 @@
 #pragma once
+#include "SIMD.h"
+#include "FastMath.h"
 #include "Vector3.h"
+#include "Matrix4.h"
+#include <limits>
+#include <type_traits>
 
-// Forward declaration
-class Matrix4;
-
+// Products, rotation and normalisation are in the header so they inline
+// into callers; with SSE or NEON available the Hamilton product uses
+// vector lanes. The *Scalar versions are the reference it must match.
 class Quaternion {
 public:
     float x, y, z, w;
 
-    Quaternion() : x(0.0f), y(0.0f), z(0.0f), w(1.0f) {}
-    Quaternion(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) {}
-    Quaternion(const Quaternion& other) : x(other.x), y(other.y), z(other.z), w(other.w) {}
+    constexpr Quaternion() : x(0.0f), y(0.0f), z(0.0f), w(1.0f) {}
+    constexpr Quaternion(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) {}
 
     // Basic operations
-    Quaternion operator+(const Quaternion& other) const;
-    Quaternion operator-(const Quaternion& other) const;
-    Quaternion operator*(const Quaternion& other) const;
-    Quaternion operator*(float scalar) const;
-    Vector3 operator*(const Vector3& v) const;  // Rotate a vector by this quaternion
-    Quaternion& operator*=(const Quaternion& other);
+    constexpr Quaternion operator+(const Quaternion& other) const {
+        return Quaternion(x + other.x, y + other.y, z + other.z, w + other.w);
+    }
+
+    constexpr Quaternion operator-(const Quaternion& other) const {
+        return Quaternion(x - other.x, y - other.y, z - other.z, w - other.w);
+    }
+
+    Quaternion operator*(const Quaternion& other) const {
+#if MATH_SIMD_SSE
+        // Hamilton product as four broadcast lanes of this times permuted,
+        // sign-flipped lanes of other, summed in the scalar order
+        __m128 a = _mm_loadu_ps(&x);
+        __m128 b = _mm_loadu_ps(&other.x);
+        __m128 sum = _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 3, 3)), b);
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 0, 0)),
+            _mm_xor_ps(_mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 1, 2, 3)), _mm_set_ps(-0.0f, 0.0f, -0.0f, 0.0f))));
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 1, 1, 1)),
+            _mm_xor_ps(_mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 3, 2)), _mm_set_ps(-0.0f, -0.0f, 0.0f, 0.0f))));
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 2, 2)),
+            _mm_xor_ps(_mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 3, 0, 1)), _mm_set_ps(-0.0f, 0.0f, 0.0f, -0.0f))));
+
+        Quaternion result;
+        _mm_storeu_ps(&result.x, sum);
+        return result;
+#elif MATH_SIMD_NEON
+        static const float signs[3][4] = {
+            { 1.0f, -1.0f, 1.0f, -1.0f },
+            { 1.0f, 1.0f, -1.0f, -1.0f },
+            { -1.0f, 1.0f, 1.0f, -1.0f }
+        };
+        float32x4_t b = vld1q_f32(&other.x);
+        float32x4_t swapped = vrev64q_f32(b);           // y x w z
+        float32x4_t reversed = vextq_f32(swapped, swapped, 2);  // w z y x
+        float32x4_t rotated = vextq_f32(b, b, 2);       // z w x y
+
+        float32x4_t sum = vmulq_n_f32(b, w);
+        sum = vaddq_f32(sum, vmulq_n_f32(vmulq_f32(reversed, vld1q_f32(signs[0])), x));
+        sum = vaddq_f32(sum, vmulq_n_f32(vmulq_f32(rotated, vld1q_f32(signs[1])), y));
+        sum = vaddq_f32(sum, vmulq_n_f32(vmulq_f32(swapped, vld1q_f32(signs[2])), z));
+
+        Quaternion result;
+        vst1q_f32(&result.x, sum);
+        return result;
+#else
+        return multiplyScalar(other);
+#endif
+    }
+
+    constexpr Quaternion operator*(float scalar) const {
+        return Quaternion(x * scalar, y * scalar, z * scalar, w * scalar);
+    }
+
+    // Rotate a vector by this quaternion (q v q^-1, so it needn't be unit).
+    // Scalar for the same reason as Matrix4's point transform.
+    Vector3 operator*(const Vector3& v) const {
+        return rotateScalar(v);
+    }
+
+    Quaternion& operator*=(const Quaternion& other) {
+        *this = *this * other;
+        return *this;
+    }
+
+    // Scalar reference implementations
+    constexpr Quaternion multiplyScalar(const Quaternion& other) const {
+        return Quaternion(
+            w * other.x + x * other.w + y * other.z - z * other.y,
+            w * other.y - x * other.z + y * other.w + z * other.x,
+            w * other.z + x * other.y - y * other.x + z * other.w,
+            w * other.w - x * other.x - y * other.y - z * other.z
+        );
+    }
+
+    Vector3 rotateScalar(const Vector3& v) const {
+        // Expanded q v q*: (w^2 - u.u) v + 2 (u.v) u + 2 w (u x v), over |q|^2
+        float vectorSq = x * x + y * y + z * z;
+        float lengthSq = vectorSq + w * w;
+        if (lengthSq <= 0.0f) return Vector3::zero();
+
+        Vector3 u(x, y, z);
+        Vector3 cross = u.cross(v);
+        float along = x * v.x + y * v.y + z * v.z;
+        Vector3 sum = v * (w * w - vectorSq) + u * (2.0f * along) + cross * (2.0f * w);
+        return sum * (1.0f / lengthSq);
+    }
 
     // Utility functions
-    float length() const;
-    float lengthSquared() const;
-    Quaternion normalized() const;
-    void normalize();
-    Quaternion conjugate() const;
-    Quaternion inverse() const;
+    float length() const { return std::sqrt(lengthSquared()); }
+    constexpr float lengthSquared() const { return x * x + y * y + z * z + w * w; }
+
+    Quaternion normalized() const {
+        float len = length();
+        if (len > 0.0f) {
+            return *this * (1.0f / len);
+        }
+        return identity();
+    }
+
+    void normalize() {
+        float len = length();
+        if (len > 0.0f) {
+            *this = *this * (1.0f / len);
+        }
+    }
+
+    // normalize() through FastMath::rsqrt, for renormalizing a rotation
+    // that has only drifted slightly off unit length
+    void normalizeFast() {
+        float lenSq = lengthSquared();
+        if (lenSq >= std::numeric_limits<float>::min()) {
+            *this = *this * FastMath::rsqrt(lenSq);
+        }
+    }
+
+    constexpr Quaternion conjugate() const { return Quaternion(-x, -y, -z, w); }
+
+    Quaternion inverse() const {
+        float lenSq = lengthSquared();
+        if (lenSq > 0.0f) {
+            return conjugate() * (1.0f / lenSq);
+        }
+        return identity();
+    }
 
     // Conversion functions
-    Matrix4 toMatrix4() const;
+    Matrix4 toMatrix4() const {
+        float xx = x * x;
+        float yy = y * y;
+        float zz = z * z;
+        float xy = x * y;
+        float xz = x * z;
+        float yz = y * z;
+        float wx = w * x;
+        float wy = w * y;
+        float wz = w * z;
+
+        Matrix4 result;
+        result(0, 0) = 1.0f - 2.0f * (yy + zz);
+        result(0, 1) = 2.0f * (xy - wz);
+        result(0, 2) = 2.0f * (xz + wy);
+
+        result(1, 0) = 2.0f * (xy + wz);
+        result(1, 1) = 1.0f - 2.0f * (xx + zz);
+        result(1, 2) = 2.0f * (yz - wx);
+
+        result(2, 0) = 2.0f * (xz - wy);
+        result(2, 1) = 2.0f * (yz + wx);
+        result(2, 2) = 1.0f - 2.0f * (xx + yy);
+        return result;
+    }
+
     Vector3 toEulerAngles() const;
     static Quaternion fromEulerAngles(const Vector3& euler);
     static Quaternion fromAxisAngle(const Vector3& axis, float angle);
+    // fromAxisAngle with FastMath::sinCos; axis must already be unit length
+    static Quaternion fromAxisAngleFast(const Vector3& unitAxis, float angle) {
+        float s, c;
+        FastMath::sinCos(angle * 0.5f, s, c);
+        return Quaternion(unitAxis.x * s, unitAxis.y * s, unitAxis.z * s, c);
+    }
     static Quaternion lookRotation(const Vector3& forward, const Vector3& up = Vector3::up());
 
     // Static constants
-    static Quaternion identity();
+    static constexpr Quaternion identity() { return Quaternion(0.0f, 0.0f, 0.0f, 1.0f); }
     static Quaternion slerp(const Quaternion& a, const Quaternion& b, float t);
-};
\ No newline at end of file
+};
+
+static_assert(std::is_trivially_copyable<Quaternion>::value, "Quaternion must stay trivially copyable");
@@ -0,0 +1,31 @@
+#pragma once
+
+// Vector instruction set used by the math library's hot paths.
+// SSE2 is baseline on x86-64 and NEON on arm64, so no extra compiler flags
+// are needed. Anything else, or a build with MATH_NO_SIMD defined, uses the
+// scalar paths, which are also what the SIMD results are checked against.
+//
+// Deterministic builds (MATH_DETERMINISTIC) stay on the scalar paths too:
+// some SIMD paths use a different algorithm from the scalar one (the
+// Matrix4 inverse, for one), so x86 and ARM would not agree bit for bit.
+#if defined(MATH_DETERMINISTIC) && MATH_DETERMINISTIC && !defined(MATH_NO_SIMD)
+    #define MATH_NO_SIMD 1
+#endif
+
+#if !defined(MATH_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+    #include <emmintrin.h>
+    #define MATH_SIMD_SSE 1
+#elif !defined(MATH_NO_SIMD) && (defined(__ARM_NEON) || defined(__ARM_NEON__))
+    #include <arm_neon.h>
+    #define MATH_SIMD_NEON 1
+#endif
+
+#ifndef MATH_SIMD_SSE
+    #define MATH_SIMD_SSE 0
+#endif
+
+#ifndef MATH_SIMD_NEON
+    #define MATH_SIMD_NEON 0
+#endif
+
+#define MATH_SIMD (MATH_SIMD_SSE || MATH_SIMD_NEON)
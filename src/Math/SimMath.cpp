@@ -0,0 +1,209 @@
+#include "SimMath.h"
+
+// The software versions evaluate in double and round once to float at the
+// end, so the polynomial error stays far below float precision. The
+// polynomials and reduction constants are the ones from fdlibm (Sun
+// Microsystems, freely redistributable), which most C libraries also use.
+namespace {
+    // pi/2 split into three parts so n * part is exact for the n a float
+    // argument can produce in practice (|x| up to about 1e6)
+    const double InvPio2 = 6.36619772367581382433e-01;
+    const double Pio2_1 = 1.57079632673412561417e+00;
+    const double Pio2_2 = 6.07710050630396597660e-11;
+    const double Pio2_3 = 2.02226624871116645580e-21;
+    const double Pio2 = 1.57079632679489655800e+00;
+    const double Pi = 3.14159265358979311600e+00;
+
+    const double S1 = -1.66666666666666324348e-01;
+    const double S2 = 8.33333333332248946124e-03;
+    const double S3 = -1.98412698298579493134e-04;
+    const double S4 = 2.75573137070700676789e-06;
+    const double S5 = -2.50507602534068634195e-08;
+    const double S6 = 1.58969099521155010221e-10;
+
+    const double C1 = 4.16666666666666019037e-02;
+    const double C2 = -1.38888888888741095749e-03;
+    const double C3 = 2.48015872894767294178e-05;
+    const double C4 = -2.75573143513906633035e-07;
+    const double C5 = 2.08757232129817482790e-09;
+    const double C6 = -1.13596475577881948265e-11;
+
+    const double AtanHi[4] = {
+        4.63647609000806093515e-01,  // atan(0.5)
+        7.85398163397448278999e-01,  // atan(1.0)
+        9.82793723247329054082e-01,  // atan(1.5)
+        1.57079632679489655800e+00   // atan(inf)
+    };
+    const double AtanLo[4] = {
+        2.26987774529616870924e-17,
+        3.06161699786838301793e-17,
+        1.39033110312309984516e-17,
+        6.12323399573676603587e-17
+    };
+    const double AT[11] = {
+        3.33333333333329318027e-01,
+        -1.99999999998764832476e-01,
+        1.42857142725034663711e-01,
+        -1.11111104054623557880e-01,
+        9.09088713343650656196e-02,
+        -7.69187620504482999495e-02,
+        6.66107313738753120669e-02,
+        -5.83357013379057348645e-02,
+        4.97687799461593236017e-02,
+        -3.65315727442169155270e-02,
+        1.62858201153657823623e-02
+    };
+
+    // sin and cos of r in [-pi/4, pi/4]
+    double kernelSin(double r) {
+        if (std::fabs(r) < 7.45058059692382812500e-09) return r;  // 2^-27, keeps -0
+
+        double z = r * r;
+        double p = S2 + z * (S3 + z * (S4 + z * (S5 + z * S6)));
+        return r + z * r * (S1 + z * p);
+    }
+
+    double kernelCos(double r) {
+        double z = r * r;
+        double p = C1 + z * (C2 + z * (C3 + z * (C4 + z * (C5 + z * C6))));
+        return 1.0 - 0.5 * z + z * z * p;
+    }
+
+    // x = quadrant * pi/2 + r with |r| <= pi/4; quadrant is 0..3
+    double reduce(double x, int& quadrant) {
+        double n = std::floor(x * InvPio2 + 0.5);
+        double r = ((x - n * Pio2_1) - n * Pio2_2) - n * Pio2_3;
+        quadrant = static_cast<int>(n - 4.0 * std::floor(n * 0.25));
+        return r;
+    }
+
+    double atanDouble(double x) {
+        if (x != x) return x + x;
+
+        bool negative = x < 0.0;
+        double a = negative ? -x : x;
+        if (a >= 7.37869762948382064640e+19) {  // 2^66
+            return negative ? -AtanHi[3] : AtanHi[3];
+        }
+
+        int id;
+        if (a < 0.4375) {
+            if (a < 1e-29) return x;
+            id = -1;
+        } else if (a < 1.1875) {
+            if (a < 0.6875) {
+                id = 0;
+                a = (2.0 * a - 1.0) / (2.0 + a);
+            } else {
+                id = 1;
+                a = (a - 1.0) / (a + 1.0);
+            }
+        } else if (a < 2.4375) {
+            id = 2;
+            a = (a - 1.5) / (1.0 + 1.5 * a);
+        } else {
+            id = 3;
+            a = -1.0 / a;
+        }
+
+        double z = a * a;
+        double w = z * z;
+        double s1 = z * (AT[0] + w * (AT[2] + w * (AT[4] + w * (AT[6] + w * (AT[8] + w * AT[10])))));
+        double s2 = w * (AT[1] + w * (AT[3] + w * (AT[5] + w * (AT[7] + w * AT[9]))));
+        if (id < 0) {
+            double result = a - a * (s1 + s2);
+            return negative ? -result : result;
+        }
+
+        double result = AtanHi[id] - ((a * (s1 + s2) - AtanLo[id]) - a);
+        return negative ? -result : result;
+    }
+
+    double atan2Double(double y, double x) {
+        if (x != x || y != y) return x + y;
+
+        bool yNegative = std::signbit(y);
+        bool xNegative = std::signbit(x);
+
+        if (y == 0.0) {
+            // atan2(+-0, +x) = +-0, atan2(+-0, -x) = +-pi
+            if (!xNegative) return y;
+            return yNegative ? -Pi : Pi;
+        }
+        if (x == 0.0) {
+            return yNegative ? -Pio2 : Pio2;
+        }
+        if (std::isinf(x)) {
+            if (std::isinf(y)) {
+                double angle = xNegative ? 3.0 * Pio2 * 0.5 : Pio2 * 0.5;
+                return yNegative ? -angle : angle;
+            }
+            if (!xNegative) return yNegative ? -0.0 : 0.0;
+            return yNegative ? -Pi : Pi;
+        }
+        if (std::isinf(y)) {
+            return yNegative ? -Pio2 : Pio2;
+        }
+
+        // Float inputs can't overflow or underflow the quotient in double
+        double angle = atanDouble(std::fabs(y / x));
+        if (xNegative) angle = Pi - angle;
+        return yNegative ? -angle : angle;
+    }
+}
+
+namespace SimMath {
+    float softSin(float x) {
+        if (!std::isfinite(x)) return x - x;
+
+        int quadrant;
+        double r = reduce(x, quadrant);
+        switch (quadrant) {
+            case 0: return static_cast<float>(kernelSin(r));
+            case 1: return static_cast<float>(kernelCos(r));
+            case 2: return static_cast<float>(-kernelSin(r));
+            default: return static_cast<float>(-kernelCos(r));
+        }
+    }
+
+    float softCos(float x) {
+        if (!std::isfinite(x)) return x - x;
+
+        int quadrant;
+        double r = reduce(x, quadrant);
+        switch (quadrant) {
+            case 0: return static_cast<float>(kernelCos(r));
+            case 1: return static_cast<float>(-kernelSin(r));
+            case 2: return static_cast<float>(-kernelCos(r));
+            default: return static_cast<float>(kernelSin(r));
+        }
+    }
+
+    float softTan(float x) {
+        if (!std::isfinite(x)) return x - x;
+
+        int quadrant;
+        double r = reduce(x, quadrant);
+        double s = kernelSin(r);
+        double c = kernelCos(r);
+        return static_cast<float>((quadrant & 1) ? -c / s : s / c);
+    }
+
+    float softAtan(float x) {
+        return static_cast<float>(atanDouble(x));
+    }
+
+    float softAtan2(float y, float x) {
+        return static_cast<float>(atan2Double(y, x));
+    }
+
+    float softAsin(float x) {
+        double a = x;
+        return static_cast<float>(atan2Double(a, std::sqrt((1.0 - a) * (1.0 + a))));
+    }
+
+    float softAcos(float x) {
+        double a = x;
+        return static_cast<float>(atan2Double(std::sqrt((1.0 - a) * (1.0 + a)), a));
+    }
+}
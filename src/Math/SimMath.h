@@ -0,0 +1,43 @@
+#pragma once
+#include <cmath>
+
+// Trigonometry for code that feeds the simulation (physics, AI, track
+// geometry, quaternion construction). The C library's sin/cos/atan differ
+// in the last bit between platforms and library versions, which is enough
+// for two machines running the same inputs to drift apart.
+//
+// Normally these forward to <cmath>. Builds configured with
+// DETERMINISTIC_MATH (which defines MATH_DETERMINISTIC) use the software
+// versions below instead: they only use +, -, *, / and sqrt on doubles,
+// which IEEE 754 rounds the same way everywhere, so they give the same
+// bits on every platform as long as the compiler doesn't fuse or reorder
+// them (the CMake option also turns off FP contraction).
+//
+// Rendering and effects code can keep using <cmath> directly.
+namespace SimMath {
+    float softSin(float x);
+    float softCos(float x);
+    float softTan(float x);
+    float softAtan(float x);
+    float softAtan2(float y, float x);
+    float softAsin(float x);   // NaN outside [-1, 1]
+    float softAcos(float x);   // NaN outside [-1, 1]
+
+#if defined(MATH_DETERMINISTIC) && MATH_DETERMINISTIC
+    inline float sin(float x) { return softSin(x); }
+    inline float cos(float x) { return softCos(x); }
+    inline float tan(float x) { return softTan(x); }
+    inline float atan(float x) { return softAtan(x); }
+    inline float atan2(float y, float x) { return softAtan2(y, x); }
+    inline float asin(float x) { return softAsin(x); }
+    inline float acos(float x) { return softAcos(x); }
+#else
+    inline float sin(float x) { return std::sin(x); }
+    inline float cos(float x) { return std::cos(x); }
+    inline float tan(float x) { return std::tan(x); }
+    inline float atan(float x) { return std::atan(x); }
+    inline float atan2(float y, float x) { return std::atan2(y, x); }
+    inline float asin(float x) { return std::asin(x); }
+    inline float acos(float x) { return std::acos(x); }
+#endif
+}
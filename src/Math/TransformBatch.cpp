@@ -0,0 +1,250 @@
+#include "TransformBatch.h"
+#include "TransformKernels.h"
+#include "SIMD.h"
+#include <algorithm>
+
+#if MATH_SIMD_SSE && defined(_MSC_VER)
+    #include <intrin.h>
+    #include <immintrin.h>
+#endif
+
+namespace {
+    struct ScalarLanes {
+        typedef float Type;
+        static const size_t Width = 1;
+
+        static Type load(const float* p) { return *p; }
+        static void store(float* p, Type v) { *p = v; }
+        static Type set(float v) { return v; }
+        static Type add(Type a, Type b) { return a + b; }
+        static Type sub(Type a, Type b) { return a - b; }
+        static Type mul(Type a, Type b) { return a * b; }
+
+        static void storeMatrices(const Type* rows, float* out) {
+            for (int k = 0; k < 16; k++) {
+                out[k] = rows[k];
+            }
+        }
+    };
+
+#if MATH_SIMD_SSE
+    struct SSELanes {
+        typedef __m128 Type;
+        static const size_t Width = 4;
+
+        static Type load(const float* p) { return _mm_loadu_ps(p); }
+        static void store(float* p, Type v) { _mm_storeu_ps(p, v); }
+        static Type set(float v) { return _mm_set1_ps(v); }
+        static Type add(Type a, Type b) { return _mm_add_ps(a, b); }
+        static Type sub(Type a, Type b) { return _mm_sub_ps(a, b); }
+        static Type mul(Type a, Type b) { return _mm_mul_ps(a, b); }
+
+        // rows[k] holds element k of four matrices; transpose each group of
+        // four elements so every matrix's row is stored contiguously
+        static void storeMatrices(const Type* rows, float* out) {
+            for (int r = 0; r < 4; r++) {
+                __m128 a = rows[r * 4 + 0];
+                __m128 b = rows[r * 4 + 1];
+                __m128 c = rows[r * 4 + 2];
+                __m128 d = rows[r * 4 + 3];
+                _MM_TRANSPOSE4_PS(a, b, c, d);
+                _mm_storeu_ps(out + 0 * 16 + r * 4, a);
+                _mm_storeu_ps(out + 1 * 16 + r * 4, b);
+                _mm_storeu_ps(out + 2 * 16 + r * 4, c);
+                _mm_storeu_ps(out + 3 * 16 + r * 4, d);
+            }
+        }
+    };
+#endif
+
+#if MATH_SIMD_NEON
+    struct NEONLanes {
+        typedef float32x4_t Type;
+        static const size_t Width = 4;
+
+        static Type load(const float* p) { return vld1q_f32(p); }
+        static void store(float* p, Type v) { vst1q_f32(p, v); }
+        static Type set(float v) { return vdupq_n_f32(v); }
+        static Type add(Type a, Type b) { return vaddq_f32(a, b); }
+        static Type sub(Type a, Type b) { return vsubq_f32(a, b); }
+        static Type mul(Type a, Type b) { return vmulq_f32(a, b); }
+
+        static void storeMatrices(const Type* rows, float* out) {
+            for (int r = 0; r < 4; r++) {
+                float32x4x2_t ab = vtrnq_f32(rows[r * 4 + 0], rows[r * 4 + 1]);
+                float32x4x2_t cd = vtrnq_f32(rows[r * 4 + 2], rows[r * 4 + 3]);
+                vst1q_f32(out + 0 * 16 + r * 4, vcombine_f32(vget_low_f32(ab.val[0]), vget_low_f32(cd.val[0])));
+                vst1q_f32(out + 1 * 16 + r * 4, vcombine_f32(vget_low_f32(ab.val[1]), vget_low_f32(cd.val[1])));
+                vst1q_f32(out + 2 * 16 + r * 4, vcombine_f32(vget_high_f32(ab.val[0]), vget_high_f32(cd.val[0])));
+                vst1q_f32(out + 3 * 16 + r * 4, vcombine_f32(vget_high_f32(ab.val[1]), vget_high_f32(cd.val[1])));
+            }
+        }
+    };
+#endif
+
+    bool cpuHasAVX2() {
+#if MATH_SIMD_SSE && defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) return false;
+
+        // The OS must save the YMM registers as well as the CPU having them
+        __cpuid(info, 1);
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        bool avx = (info[2] & (1 << 28)) != 0;
+        if (!osxsave || !avx || (_xgetbv(0) & 6) != 6) return false;
+
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#elif MATH_SIMD_SSE && (defined(__GNUC__) || defined(__clang__))
+        return __builtin_cpu_supports("avx2");
+#else
+        return false;
+#endif
+    }
+
+    struct Selection {
+        TransformBatch::Kernel kernel;
+        TransformKernels::Table table;
+    };
+
+    bool getTable(TransformBatch::Kernel kernel, TransformKernels::Table& table) {
+        switch (kernel) {
+            case TransformBatch::Kernel::Scalar:
+                table = TransformKernels::makeTable<ScalarLanes>();
+                return true;
+#if MATH_SIMD_SSE
+            case TransformBatch::Kernel::SSE:
+                table = TransformKernels::makeTable<SSELanes>();
+                return true;
+            case TransformBatch::Kernel::AVX2:
+                return cpuHasAVX2() && TransformKernels::getAVX2Table(table);
+#endif
+#if MATH_SIMD_NEON
+            case TransformBatch::Kernel::NEON:
+                table = TransformKernels::makeTable<NEONLanes>();
+                return true;
+#endif
+            default:
+                return false;
+        }
+    }
+
+    Selection& selection() {
+        static Selection current = [] {
+            const TransformBatch::Kernel preference[] = {
+                TransformBatch::Kernel::AVX2,
+                TransformBatch::Kernel::SSE,
+                TransformBatch::Kernel::NEON,
+                TransformBatch::Kernel::Scalar
+            };
+            Selection best;
+            for (TransformBatch::Kernel kernel : preference) {
+                if (getTable(kernel, best.table)) {
+                    best.kernel = kernel;
+                    break;
+                }
+            }
+            return best;
+        }();
+        return current;
+    }
+
+    const TransformKernels::Table& scalarTable() {
+        static const TransformKernels::Table table = TransformKernels::makeTable<ScalarLanes>();
+        return table;
+    }
+}
+
+namespace TransformBatch {
+    void transformPoints(const Matrix4& matrix, const Vector3Arrays& points, Vector3Arrays& out) {
+        size_t count = points.size();
+        out.resize(count);
+        if (count == 0) return;
+
+        size_t done = selection().table.transformPoints(matrix.m,
+            points.x.data(), points.y.data(), points.z.data(),
+            out.x.data(), out.y.data(), out.z.data(), count);
+        scalarTable().transformPoints(matrix.m,
+            points.x.data() + done, points.y.data() + done, points.z.data() + done,
+            out.x.data() + done, out.y.data() + done, out.z.data() + done, count - done);
+    }
+
+    void rotateVectors(const QuaternionArrays& rotations, const Vector3Arrays& vectors, Vector3Arrays& out) {
+        size_t count = std::min(rotations.size(), vectors.size());
+        out.resize(count);
+        if (count == 0) return;
+
+        size_t done = selection().table.rotateVectors(
+            rotations.x.data(), rotations.y.data(), rotations.z.data(), rotations.w.data(),
+            vectors.x.data(), vectors.y.data(), vectors.z.data(),
+            out.x.data(), out.y.data(), out.z.data(), count);
+        scalarTable().rotateVectors(
+            rotations.x.data() + done, rotations.y.data() + done, rotations.z.data() + done, rotations.w.data() + done,
+            vectors.x.data() + done, vectors.y.data() + done, vectors.z.data() + done,
+            out.x.data() + done, out.y.data() + done, out.z.data() + done, count - done);
+    }
+
+    namespace {
+        void compose(const Vector3Arrays& positions, const QuaternionArrays& rotations,
+                     const Vector3Arrays* scales, size_t count, std::vector<Matrix4>& out) {
+            out.resize(count);
+            if (count == 0) return;
+
+            float* matrices = out[0].m;
+            const float* sx = scales ? scales->x.data() : nullptr;
+            const float* sy = scales ? scales->y.data() : nullptr;
+            const float* sz = scales ? scales->z.data() : nullptr;
+
+            size_t done = selection().table.composeTransforms(
+                positions.x.data(), positions.y.data(), positions.z.data(),
+                rotations.x.data(), rotations.y.data(), rotations.z.data(), rotations.w.data(),
+                sx, sy, sz, matrices, count);
+            scalarTable().composeTransforms(
+                positions.x.data() + done, positions.y.data() + done, positions.z.data() + done,
+                rotations.x.data() + done, rotations.y.data() + done, rotations.z.data() + done, rotations.w.data() + done,
+                sx ? sx + done : nullptr, sy ? sy + done : nullptr, sz ? sz + done : nullptr,
+                matrices + done * 16, count - done);
+        }
+    }
+
+    void composeTransforms(const Vector3Arrays& positions, const QuaternionArrays& rotations,
+                           std::vector<Matrix4>& out) {
+        compose(positions, rotations, nullptr, std::min(positions.size(), rotations.size()), out);
+    }
+
+    void composeTransforms(const Vector3Arrays& positions, const QuaternionArrays& rotations,
+                           const Vector3Arrays& scales, std::vector<Matrix4>& out) {
+        size_t count = std::min(std::min(positions.size(), rotations.size()), scales.size());
+        compose(positions, rotations, &scales, count, out);
+    }
+
+    Kernel getKernel() {
+        return selection().kernel;
+    }
+
+    bool setKernel(Kernel kernel) {
+        TransformKernels::Table table;
+        if (!getTable(kernel, table)) return false;
+
+        Selection& current = selection();
+        current.kernel = kernel;
+        current.table = table;
+        return true;
+    }
+
+    bool isSupported(Kernel kernel) {
+        TransformKernels::Table table;
+        return getTable(kernel, table);
+    }
+
+    const char* getKernelName(Kernel kernel) {
+        switch (kernel) {
+            case Kernel::Scalar: return "Scalar";
+            case Kernel::SSE: return "SSE";
+            case Kernel::AVX2: return "AVX2";
+            case Kernel::NEON: return "NEON";
+        }
+        return "Unknown";
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include "Vector3.h"
+#include "Quaternion.h"
+#include "Matrix4.h"
+#include <cstddef>
+#include <vector>
+
+// Transforms over many elements at once, for loops that would otherwise
+// push one Vector3 at a time through Matrix4 or Quaternion. Inputs are
+// structure-of-arrays, one array per component, so each SIMD lane holds a
+// whole element. The widest kernel this CPU can run (AVX2, SSE, NEON or
+// scalar) is picked on first use; all of them compute every element the
+// same way, so switching kernels does not change results.
+namespace TransformBatch {
+    struct Vector3Arrays {
+        std::vector<float> x, y, z;
+
+        size_t size() const { return x.size(); }
+        void clear() { x.clear(); y.clear(); z.clear(); }
+        void resize(size_t count) { x.resize(count); y.resize(count); z.resize(count); }
+        void push_back(const Vector3& v) { x.push_back(v.x); y.push_back(v.y); z.push_back(v.z); }
+        Vector3 get(size_t index) const { return Vector3(x[index], y[index], z[index]); }
+    };
+
+    struct QuaternionArrays {
+        std::vector<float> x, y, z, w;
+
+        size_t size() const { return x.size(); }
+        void clear() { x.clear(); y.clear(); z.clear(); w.clear(); }
+        void resize(size_t count) { x.resize(count); y.resize(count); z.resize(count); w.resize(count); }
+        void push_back(const Quaternion& q) { x.push_back(q.x); y.push_back(q.y); z.push_back(q.z); w.push_back(q.w); }
+        Quaternion get(size_t index) const { return Quaternion(x[index], y[index], z[index], w[index]); }
+    };
+
+    enum class Kernel {
+        Scalar,
+        SSE,
+        AVX2,
+        NEON
+    };
+
+    // matrix * (p, 1) for every point. Affine: the bottom row is ignored and
+    // there is no perspective divide. out may be points.
+    void transformPoints(const Matrix4& matrix, const Vector3Arrays& points, Vector3Arrays& out);
+
+    // rotations[i] * vectors[i]. The quaternions must be unit length, unlike
+    // Quaternion::operator*(Vector3). out may be vectors.
+    void rotateVectors(const QuaternionArrays& rotations, const Vector3Arrays& vectors, Vector3Arrays& out);
+
+    // translation(positions[i]) * rotations[i].toMatrix4() * scale(scales[i])
+    void composeTransforms(const Vector3Arrays& positions, const QuaternionArrays& rotations,
+                           std::vector<Matrix4>& out);
+    void composeTransforms(const Vector3Arrays& positions, const QuaternionArrays& rotations,
+                           const Vector3Arrays& scales, std::vector<Matrix4>& out);
+
+    // Kernel selection; setKernel returns false (and changes nothing) if
+    // this build or CPU can't run the requested one
+    Kernel getKernel();
+    bool setKernel(Kernel kernel);
+    bool isSupported(Kernel kernel);
+    const char* getKernelName(Kernel kernel);
+}
@@ -0,0 +1,63 @@
+// AVX2 instantiation of the TransformBatch kernels. The build compiles only
+// this file with AVX2 enabled (-mavx2 or /arch:AVX2) and TransformBatch.cpp
+// calls into it only after checking the CPU, so it must not include any
+// header with inline functions the rest of the program also uses.
+#include "TransformKernels.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+
+namespace {
+    struct AVX2Lanes {
+        typedef __m256 Type;
+        static const size_t Width = 8;
+
+        static Type load(const float* p) { return _mm256_loadu_ps(p); }
+        static void store(float* p, Type v) { _mm256_storeu_ps(p, v); }
+        static Type set(float v) { return _mm256_set1_ps(v); }
+        static Type add(Type a, Type b) { return _mm256_add_ps(a, b); }
+        static Type sub(Type a, Type b) { return _mm256_sub_ps(a, b); }
+        static Type mul(Type a, Type b) { return _mm256_mul_ps(a, b); }
+
+        // rows[k] holds element k of eight matrices: transpose each row's
+        // four elements as two 4x4 blocks, one per half of the lanes, so
+        // every matrix's row is stored contiguously
+        static void storeMatrices(const Type* rows, float* out) {
+            for (int r = 0; r < 4; r++) {
+                __m128 a = _mm256_castps256_ps128(rows[r * 4 + 0]);
+                __m128 b = _mm256_castps256_ps128(rows[r * 4 + 1]);
+                __m128 c = _mm256_castps256_ps128(rows[r * 4 + 2]);
+                __m128 d = _mm256_castps256_ps128(rows[r * 4 + 3]);
+                _MM_TRANSPOSE4_PS(a, b, c, d);
+                _mm_storeu_ps(out + 0 * 16 + r * 4, a);
+                _mm_storeu_ps(out + 1 * 16 + r * 4, b);
+                _mm_storeu_ps(out + 2 * 16 + r * 4, c);
+                _mm_storeu_ps(out + 3 * 16 + r * 4, d);
+
+                a = _mm256_extractf128_ps(rows[r * 4 + 0], 1);
+                b = _mm256_extractf128_ps(rows[r * 4 + 1], 1);
+                c = _mm256_extractf128_ps(rows[r * 4 + 2], 1);
+                d = _mm256_extractf128_ps(rows[r * 4 + 3], 1);
+                _MM_TRANSPOSE4_PS(a, b, c, d);
+                _mm_storeu_ps(out + 4 * 16 + r * 4, a);
+                _mm_storeu_ps(out + 5 * 16 + r * 4, b);
+                _mm_storeu_ps(out + 6 * 16 + r * 4, c);
+                _mm_storeu_ps(out + 7 * 16 + r * 4, d);
+            }
+        }
+    };
+}
+
+bool TransformKernels::getAVX2Table(Table& table) {
+    table = makeTable<AVX2Lanes>();
+    return true;
+}
+
+#else
+
+bool TransformKernels::getAVX2Table(Table& table) {
+    (void)table;
+    return false;
+}
+
+#endif
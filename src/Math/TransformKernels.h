@@ -0,0 +1,160 @@
+#pragma once
+#include <cstddef>
+
+// Lane-generic bodies of the TransformBatch kernels. Each instruction set
+// supplies a Lanes type (Type, Width, load/store/set/add/sub/mul and
+// storeMatrices) and instantiates these templates in its own translation
+// unit, so the AVX2 instantiations can be compiled with AVX2 enabled
+// without that code leaking into the rest of the program. Keep this header
+// free of other project includes for the same reason.
+//
+// Every kernel processes whole groups of Lanes::Width elements and returns
+// how many it did; the caller finishes the tail with the scalar lanes.
+// The operations and their order are the same for every lane type, so all
+// kernels give the same results as the scalar one.
+namespace TransformKernels {
+    struct Table {
+        // matrix is a row-major Matrix4; the bottom row is ignored
+        size_t (*transformPoints)(const float* matrix,
+                                  const float* inX, const float* inY, const float* inZ,
+                                  float* outX, float* outY, float* outZ, size_t count);
+        size_t (*rotateVectors)(const float* qx, const float* qy, const float* qz, const float* qw,
+                                const float* inX, const float* inY, const float* inZ,
+                                float* outX, float* outY, float* outZ, size_t count);
+        // scaleX/Y/Z may be null for unit scale; out is count row-major Matrix4s
+        size_t (*composeTransforms)(const float* px, const float* py, const float* pz,
+                                    const float* qx, const float* qy, const float* qz, const float* qw,
+                                    const float* scaleX, const float* scaleY, const float* scaleZ,
+                                    float* out, size_t count);
+    };
+
+    // Defined in TransformBatchAVX2.cpp; false when that file was built
+    // without AVX2 enabled
+    bool getAVX2Table(Table& table);
+
+    template <class L>
+    size_t transformPoints(const float* matrix,
+                           const float* inX, const float* inY, const float* inZ,
+                           float* outX, float* outY, float* outZ, size_t count) {
+        typedef typename L::Type V;
+        V m[12];
+        for (int k = 0; k < 12; k++) {
+            m[k] = L::set(matrix[k]);
+        }
+
+        size_t i = 0;
+        for (; i + L::Width <= count; i += L::Width) {
+            V x = L::load(inX + i);
+            V y = L::load(inY + i);
+            V z = L::load(inZ + i);
+            L::store(outX + i, L::add(L::add(L::add(L::mul(m[0], x), L::mul(m[1], y)), L::mul(m[2], z)), m[3]));
+            L::store(outY + i, L::add(L::add(L::add(L::mul(m[4], x), L::mul(m[5], y)), L::mul(m[6], z)), m[7]));
+            L::store(outZ + i, L::add(L::add(L::add(L::mul(m[8], x), L::mul(m[9], y)), L::mul(m[10], z)), m[11]));
+        }
+        return i;
+    }
+
+    template <class L>
+    size_t rotateVectors(const float* qx, const float* qy, const float* qz, const float* qw,
+                         const float* inX, const float* inY, const float* inZ,
+                         float* outX, float* outY, float* outZ, size_t count) {
+        typedef typename L::Type V;
+        V two = L::set(2.0f);
+
+        // Unit quaternions only: t = 2 (u x v), v' = v + w t + u x t
+        size_t i = 0;
+        for (; i + L::Width <= count; i += L::Width) {
+            V ux = L::load(qx + i);
+            V uy = L::load(qy + i);
+            V uz = L::load(qz + i);
+            V w = L::load(qw + i);
+            V x = L::load(inX + i);
+            V y = L::load(inY + i);
+            V z = L::load(inZ + i);
+
+            V tx = L::mul(two, L::sub(L::mul(uy, z), L::mul(uz, y)));
+            V ty = L::mul(two, L::sub(L::mul(uz, x), L::mul(ux, z)));
+            V tz = L::mul(two, L::sub(L::mul(ux, y), L::mul(uy, x)));
+
+            L::store(outX + i, L::add(L::add(x, L::mul(w, tx)), L::sub(L::mul(uy, tz), L::mul(uz, ty))));
+            L::store(outY + i, L::add(L::add(y, L::mul(w, ty)), L::sub(L::mul(uz, tx), L::mul(ux, tz))));
+            L::store(outZ + i, L::add(L::add(z, L::mul(w, tz)), L::sub(L::mul(ux, ty), L::mul(uy, tx))));
+        }
+        return i;
+    }
+
+    template <class L>
+    size_t composeTransforms(const float* px, const float* py, const float* pz,
+                             const float* qx, const float* qy, const float* qz, const float* qw,
+                             const float* scaleX, const float* scaleY, const float* scaleZ,
+                             float* out, size_t count) {
+        typedef typename L::Type V;
+        V zero = L::set(0.0f);
+        V one = L::set(1.0f);
+        V two = L::set(2.0f);
+
+        // Translation * rotation * scale, with the rotation terms written
+        // as in Quaternion::toMatrix4
+        size_t i = 0;
+        for (; i + L::Width <= count; i += L::Width) {
+            V x = L::load(qx + i);
+            V y = L::load(qy + i);
+            V z = L::load(qz + i);
+            V w = L::load(qw + i);
+
+            V xx = L::mul(x, x);
+            V yy = L::mul(y, y);
+            V zz = L::mul(z, z);
+            V xy = L::mul(x, y);
+            V xz = L::mul(x, z);
+            V yz = L::mul(y, z);
+            V wx = L::mul(w, x);
+            V wy = L::mul(w, y);
+            V wz = L::mul(w, z);
+
+            V rows[16];
+            rows[0] = L::sub(one, L::mul(two, L::add(yy, zz)));
+            rows[1] = L::mul(two, L::sub(xy, wz));
+            rows[2] = L::mul(two, L::add(xz, wy));
+            rows[3] = L::load(px + i);
+
+            rows[4] = L::mul(two, L::add(xy, wz));
+            rows[5] = L::sub(one, L::mul(two, L::add(xx, zz)));
+            rows[6] = L::mul(two, L::sub(yz, wx));
+            rows[7] = L::load(py + i);
+
+            rows[8] = L::mul(two, L::sub(xz, wy));
+            rows[9] = L::mul(two, L::add(yz, wx));
+            rows[10] = L::sub(one, L::mul(two, L::add(xx, yy)));
+            rows[11] = L::load(pz + i);
+
+            rows[12] = zero;
+            rows[13] = zero;
+            rows[14] = zero;
+            rows[15] = one;
+
+            if (scaleX) {
+                V sx = L::load(scaleX + i);
+                V sy = L::load(scaleY + i);
+                V sz = L::load(scaleZ + i);
+                for (int r = 0; r < 3; r++) {
+                    rows[r * 4 + 0] = L::mul(rows[r * 4 + 0], sx);
+                    rows[r * 4 + 1] = L::mul(rows[r * 4 + 1], sy);
+                    rows[r * 4 + 2] = L::mul(rows[r * 4 + 2], sz);
+                }
+            }
+
+            L::storeMatrices(rows, out + i * 16);
+        }
+        return i;
+    }
+
+    template <class L>
+    Table makeTable() {
+        Table table;
+        table.transformPoints = &transformPoints<L>;
+        table.rotateVectors = &rotateVectors<L>;
+        table.composeTransforms = &composeTransforms<L>;
+        return table;
+    }
+}
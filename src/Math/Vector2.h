@@ -9,7 +9,6 @@ public:
     Vector2() : x(0), y(0) {}
     Vector2(float x, float y) : x(x), y(y) {}
     Vector2(float value) : x(value), y(value) {}
-    Vector2(const Vector2& other) : x(other.x), y(other.y) {}
     
     // Static vectors
     static Vector2 zero() { return Vector2(0, 0); }
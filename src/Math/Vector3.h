@@ -1,38 +1,151 @@
 #pragma once
+#include "FastMath.h"
+#include <algorithm>
 #include <cmath>
+#include <limits>
+#include <type_traits>
 
+// Defined in the header so the operators inline into physics and combat
+// loops without link-time optimisation. Trivially copyable (no user copy
+// constructor), so it is passed in registers and containers of it move
+// with memcpy.
 class Vector3 {
 public:
     float x, y, z;
 
-    Vector3() : x(0.0f), y(0.0f), z(0.0f) {}
-    Vector3(float x, float y, float z) : x(x), y(y), z(z) {}
-    Vector3(const Vector3& other) : x(other.x), y(other.y), z(other.z) {}
+    constexpr Vector3() : x(0.0f), y(0.0f), z(0.0f) {}
+    constexpr Vector3(float x, float y, float z) : x(x), y(y), z(z) {}
 
     // Basic operations
-    Vector3 operator+(const Vector3& other) const;
-    Vector3 operator-(const Vector3& other) const;
-    Vector3 operator-() const;  // Unary negation
-    Vector3 operator*(float scalar) const;
-    Vector3 operator/(float scalar) const;
-    Vector3& operator+=(const Vector3& other);
-    Vector3& operator-=(const Vector3& other);
-    Vector3& operator*=(float scalar);
-    Vector3& operator/=(float scalar);
+    constexpr Vector3 operator+(const Vector3& other) const {
+        return Vector3(x + other.x, y + other.y, z + other.z);
+    }
+
+    constexpr Vector3 operator-(const Vector3& other) const {
+        return Vector3(x - other.x, y - other.y, z - other.z);
+    }
+
+    constexpr Vector3 operator-() const {  // Unary negation
+        return Vector3(-x, -y, -z);
+    }
+
+    constexpr Vector3 operator*(float scalar) const {
+        return Vector3(x * scalar, y * scalar, z * scalar);
+    }
+
+    constexpr Vector3 operator/(float scalar) const {
+        return Vector3(x / scalar, y / scalar, z / scalar);
+    }
+
+    constexpr Vector3& operator+=(const Vector3& other) {
+        x += other.x;
+        y += other.y;
+        z += other.z;
+        return *this;
+    }
+
+    constexpr Vector3& operator-=(const Vector3& other) {
+        x -= other.x;
+        y -= other.y;
+        z -= other.z;
+        return *this;
+    }
+
+    constexpr Vector3& operator*=(float scalar) {
+        x *= scalar;
+        y *= scalar;
+        z *= scalar;
+        return *this;
+    }
+
+    constexpr Vector3& operator/=(float scalar) {
+        x /= scalar;
+        y /= scalar;
+        z /= scalar;
+        return *this;
+    }
 
     // Vector operations
-    float dot(const Vector3& other) const;
-    Vector3 cross(const Vector3& other) const;
-    float length() const;
-    float lengthSquared() const;
+    constexpr float dot(const Vector3& other) const {
+        return x * other.x + y * other.y + z * other.z;
+    }
+
+    constexpr Vector3 cross(const Vector3& other) const {
+        return Vector3(
+            y * other.z - z * other.y,
+            z * other.x - x * other.z,
+            x * other.y - y * other.x
+        );
+    }
+
+    float length() const {
+        return std::sqrt(x * x + y * y + z * z);
+    }
+
+    constexpr float lengthSquared() const {
+        return x * x + y * y + z * z;
+    }
+
     float magnitude() const { return length(); }  // Alias for length
-    Vector3 normalized() const;
-    void normalize();
+
+    Vector3 normalized() const {
+        float len = length();
+        if (len > 0.0f) {
+            return *this / len;
+        }
+        return Vector3::zero();
+    }
+
+    void normalize() {
+        float len = length();
+        if (len > 0.0f) {
+            *this /= len;
+        }
+    }
+
+    // Same through FastMath::rsqrt, for hot paths that can take its
+    // 3e-7 relative error. Vectors too short for the estimate give zero.
+    Vector3 normalizedFast() const {
+        float lenSq = lengthSquared();
+        if (lenSq >= std::numeric_limits<float>::min()) {
+            return *this * FastMath::rsqrt(lenSq);
+        }
+        return Vector3::zero();
+    }
 
     // Utility functions
-    static Vector3 zero();
-    static Vector3 up();
-    static Vector3 forward();
-    static Vector3 right();
-    static Vector3 lerp(const Vector3& a, const Vector3& b, float t);
-};
\ No newline at end of file
+    static constexpr Vector3 zero() { return Vector3(0.0f, 0.0f, 0.0f); }
+    static constexpr Vector3 up() { return Vector3(0.0f, 1.0f, 0.0f); }
+    static constexpr Vector3 forward() { return Vector3(0.0f, 0.0f, -1.0f); }
+    static constexpr Vector3 right() { return Vector3(1.0f, 0.0f, 0.0f); }
+
+    // Fused forms of common chains: one expression per component, so they
+    // build no intermediate Vector3s and round exactly like the written-out
+    // operator chain
+
+    // a + b * s
+    static constexpr Vector3 madd(const Vector3& a, const Vector3& b, float s) {
+        return Vector3(a.x + b.x * s, a.y + b.y * s, a.z + b.z * s);
+    }
+
+    // a + (b - a) * t, t not clamped
+    static constexpr Vector3 lerpUnclamped(const Vector3& a, const Vector3& b, float t) {
+        return Vector3(a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.z + (b.z - a.z) * t);
+    }
+
+    static constexpr Vector3 lerp(const Vector3& a, const Vector3& b, float t) {
+        return lerpUnclamped(a, b, std::clamp(t, 0.0f, 1.0f));
+    }
+
+    // This vector shortened to maxLength if it is longer; the square root
+    // is only taken when it is
+    Vector3 clampedLength(float maxLength) const {
+        float lenSq = lengthSquared();
+        if (lenSq > maxLength * maxLength) {
+            return *this * (maxLength / std::sqrt(lenSq));
+        }
+        return *this;
+    }
+};
+
+static_assert(std::is_trivially_copyable<Vector3>::value, "Vector3 must stay trivially copyable");
@@ -1,4 +1,5 @@
 #include "Car.h"
+#include "../Math/SimMath.h"
 #include <cmath>
 #include <algorithm>
 
@@ -8,30 +9,33 @@ Car::Car()
     , angularVelocity(0.0f, 0.0f, 0.0f)
     , rotation(Quaternion::identity())
     , mass(1200.0f)
-    , centerOfMass(0.0f, -0.5f, 0.0f)
-    , inertia(1.0f, 1.0f, 1.0f)
     , throttleInput(0.0f)
     , brakeInput(0.0f)
     , steerInput(0.0f)
+    , groundHeight(0.0f)
+    , groundNormal(0.0f, 1.0f, 0.0f)
+    , groundGrip(1.0f)
+    , groundRollingResistance(1.0f)
     , maxSteerAngle(30.0f)
-    , maxSpeed(50.0f)
-    , acceleration(20.0f)
     , brakeForce(30.0f)
     , friction(0.8f)
     , airResistance(0.3f)
     , downforce(0.1f)
-    , boostPower(50.0f)
-    , boostCapacity(100.0f)
-    , currentBoost(boostCapacity)
-    , isBoosting(false)
+    , maxSpeed(50.0f)
+    , isGrounded(false)
+    , hasGroundContact(false)
+    , currentBoost(0.0f)
     , boostCooldown(0.0f)
+    , boostCapacity(100.0f)
     , boostRechargeRate(20.0f)
+    , boostPower(50.0f)
+    , speedEffectIntensity(0.0f)
     , lastPosition(0.0f, 0.0f, 0.0f)
     , velocityDirection(0.0f, 0.0f, 0.0f)
-    , speedEffectIntensity(0.0f)
-    , isGrounded(false)
-    , groundHeight(0.0f)
-    , groundNormal(0.0f, 1.0f, 0.0f) {
+    , acceleration(20.0f)
+    , centerOfMass(0.0f, -0.5f, 0.0f)
+    , inertia(1.0f, 1.0f, 1.0f)
+    , isBoosting(false) {
     
     // Initialize wheels
     wheels[0].position = Vector3(-1.0f, -0.5f, 1.5f);  // Front left
@@ -50,6 +54,9 @@ Car::Car()
         wheels[i].suspensionStiffness = 20.0f;
         wheels[i].damping = 2.0f;
         wheels[i].normal = Vector3::up();
+        wheels[i].contactPoint = Vector3::zero();
+        wheels[i].heightAboveGround = 0.0f;
+        wheels[i].material = SurfaceMaterial::Asphalt;
     }
     
     // Initialize engine
@@ -63,6 +70,9 @@ Car::Car()
     engine.gearRatio = 2.5f;
     engine.finalDrive = 3.5f;
     engine.isRunning = true;
+    
+    // Start with a full tank
+    currentBoost = boostCapacity;
 }
 
 Car::Car(const Vector3& startPosition) : Car() {
@@ -89,6 +99,10 @@ float Car::getSpeedKmh() const {
     return getSpeed() * 3.6f; // Convert m/s to km/h
 }
 
+float Car::getWheelbase() const {
+    return wheels[0].position.z - wheels[2].position.z;
+}
+
 void Car::setPosition(const Vector3& pos) {
     position = pos;
 }
@@ -152,6 +166,9 @@ void Car::update(float deltaTime) {
     updatePhysics(deltaTime);
     updateWheels(deltaTime);
     updateEngine(deltaTime);
+}
+
+void Car::updateEffects(float deltaTime) {
     updateBoost(deltaTime);
     updateVisualEffects(deltaTime);
     
@@ -164,6 +181,8 @@ void Car::update(float deltaTime) {
 void Car::updatePhysics(float deltaTime) {
     checkGroundCollision();
     applyGroundForces();
+    applySteering(deltaTime);
+    applyBrakes(deltaTime);
     applyAirResistance();
     applyDownforce();
     
@@ -171,14 +190,16 @@ void Car::updatePhysics(float deltaTime) {
     position += velocity * deltaTime;
     
     // Update rotation based on angular velocity
-    if (angularVelocity.length() > 0.001f) {
-        Quaternion angularQuat = Quaternion::fromAxisAngle(angularVelocity.normalized(), angularVelocity.length() * deltaTime);
+    float angularSpeed = angularVelocity.length();
+    if (angularSpeed > 0.001f) {
+        Quaternion angularQuat = Quaternion::fromAxisAngleFast(angularVelocity * (1.0f / angularSpeed), angularSpeed * deltaTime);
         rotation = rotation * angularQuat;
-        rotation.normalize();
+        rotation.normalizeFast();
     }
     
-    // Apply damping
-    velocity *= 0.99f;
+    // Apply damping. Air and rolling resistance slow the car; this only
+    // settles the suspension.
+    velocity.y *= 0.99f;
     angularVelocity *= 0.95f;
 }
 
@@ -186,18 +207,13 @@ void Car::updateWheels(float deltaTime) {
     for (int i = 0; i < 4; i++) {
         Wheel& wheel = wheels[i];
         
-        // Update wheel position relative to car
-        Vector3 worldWheelPos = position + rotation * wheel.position;
-        
-        // Simple ground collision
-        wheel.isGrounded = worldWheelPos.y <= 0.0f;
-        
+        // Contact comes from this step's ground probe
         if (wheel.isGrounded) {
-            // Apply suspension forces
-            float suspensionForce = wheel.suspensionStiffness * (wheel.suspensionLength - worldWheelPos.y);
-            float dampingForce = wheel.damping * wheel.velocity.y;
+            // Apply suspension forces along the ground normal
+            float suspensionForce = wheel.suspensionStiffness * (wheel.suspensionLength - wheel.heightAboveGround);
+            float dampingForce = wheel.damping * wheel.velocity.dot(wheel.normal);
             
-            Vector3 suspensionVector = Vector3::up() * (suspensionForce - dampingForce);
+            Vector3 suspensionVector = wheel.normal * (suspensionForce - dampingForce);
             velocity += suspensionVector * deltaTime / mass;
             
             // Update wheel rotation based on forward velocity
@@ -205,8 +221,15 @@ void Car::updateWheels(float deltaTime) {
             wheel.angularVelocity = forwardSpeed / wheel.radius;
             wheel.rotation += wheel.angularVelocity * deltaTime;
             
-            // Apply friction
-            Vector3 frictionForce = -velocity * friction;
+            // Apply friction from the surface under this wheel: grip resists
+            // sliding sideways, rolling resistance slows the car along its
+            // heading. Asphalt is 1 for both.
+            const SurfaceProperties& surface = getSurfaceProperties(wheel.material);
+            Vector3 forward = getForward();
+            Vector3 rolling = forward * velocity.dot(forward);
+            Vector3 sliding = velocity - rolling;
+            float rollingResistance = surface.rollingResistance * RollingResistanceScale;
+            Vector3 frictionForce = -(sliding * surface.friction + rolling * rollingResistance) * friction;
             velocity += frictionForce * deltaTime;
         }
     }
@@ -230,9 +253,12 @@ void Car::updateEngine(float deltaTime) {
     float torqueCurve = 1.0f - (engine.rpm / engine.maxRpm) * 0.3f;
     engine.torque = engine.throttle * engine.maxTorque * torqueCurve;
     
-    // Apply engine force
-    if (engine.torque > 0.0f && isGrounded) {
-        Vector3 engineForce = getForward() * engine.torque * engine.gearRatio * engine.finalDrive;
+    // Apply engine force, up to the car's top speed
+    if (engine.torque > 0.0f && isGrounded && velocity.dot(getForward()) < maxSpeed) {
+        // Torque at the wheels over their radius. Low-grip surfaces spin
+        // the wheels instead of driving the car.
+        float driveForce = engine.torque * engine.gearRatio * engine.finalDrive / wheels[0].radius;
+        Vector3 engineForce = getForward() * driveForce * groundGrip;
         velocity += engineForce * deltaTime / mass;
     }
 }
@@ -264,27 +290,92 @@ void Car::updateVisualEffects(float deltaTime) {
     
     // Update velocity direction for motion blur effects
     if (speed > 0.1f) {
-        velocityDirection = velocity.normalized();
+        velocityDirection = velocity.normalizedFast();
     }
     
     // Store last position for trail effects
     lastPosition = position;
 }
 
+GroundQuery::Cast Car::getWheelCast(int wheelIndex) const {
+    return getWheelCast(wheelIndex, rotation * getWheelMountOffset(wheelIndex), getUp());
+}
+
+GroundQuery::Cast Car::getWheelCast(int wheelIndex, const Vector3& mountOffset, const Vector3& up) const {
+    const Wheel& wheel = wheels[wheelIndex];
+    Vector3 mount = position + mountOffset;
+    
+    // Long enough to find ground anywhere within suspension travel
+    GroundQuery::Cast cast;
+    cast.origin = mount + up * WheelProbeHeight;
+    cast.direction = -up;
+    cast.maxDistance = WheelProbeHeight - wheel.position.y + wheel.suspensionLength;
+    cast.radius = wheel.radius;
+    return cast;
+}
+
+Vector3 Car::getWheelMountOffset(int wheelIndex) const {
+    const Wheel& wheel = wheels[wheelIndex];
+    return Vector3(wheel.position.x, 0.0f, wheel.position.z);
+}
+
+void Car::setWheelContacts(const GroundQuery::Hit* hits) {
+    hasGroundContact = false;
+    groundHeight = 0.0f;
+    groundGrip = 0.0f;
+    groundRollingResistance = 0.0f;
+    Vector3 normalSum = Vector3::zero();
+    int contacts = 0;
+    
+    for (int i = 0; i < 4; i++) {
+        Wheel& wheel = wheels[i];
+        const GroundQuery::Hit& hit = hits[i];
+        
+        // Sphere casts stop one radius short of the surface
+        wheel.heightAboveGround = hit.distance + wheel.radius - WheelProbeHeight + wheel.position.y;
+        wheel.isGrounded = hit.hit && wheel.heightAboveGround <= 0.0f;
+        wheel.material = hit.material;
+        
+        if (hit.hit) {
+            wheel.normal = hit.normal;
+            wheel.contactPoint = hit.point;
+            groundHeight += hit.point.y;
+            const SurfaceProperties& surface = getSurfaceProperties(hit.material);
+            groundGrip += surface.friction;
+            groundRollingResistance += surface.rollingResistance;
+            normalSum += hit.normal;
+            contacts++;
+        } else {
+            wheel.normal = Vector3::up();
+        }
+    }
+    
+    if (contacts > 0) {
+        hasGroundContact = true;
+        groundHeight /= contacts;
+        groundGrip /= contacts;
+        groundRollingResistance /= contacts;
+        groundNormal = normalSum.normalized();
+    } else {
+        groundNormal = Vector3::up();
+        groundGrip = 1.0f;
+        groundRollingResistance = 1.0f;
+    }
+}
+
 void Car::checkGroundCollision() {
     isGrounded = false;
-    groundHeight = 0.0f;
-    groundNormal = Vector3::up();
+    if (!hasGroundContact) return;
     
-    // Simple ground plane collision
-    if (position.y <= 0.0f) {
+    // Ground under the car, from the wheel contacts
+    if (position.y <= groundHeight) {
         isGrounded = true;
-        groundHeight = 0.0f;
-        position.y = 0.0f;
+        position.y = groundHeight;
         
-        // Stop downward velocity
-        if (velocity.y < 0.0f) {
-            velocity.y = 0.0f;
+        // Stop velocity into the ground
+        float intoGround = velocity.dot(groundNormal);
+        if (intoGround < 0.0f) {
+            velocity -= groundNormal * intoGround;
         }
     }
 }
@@ -296,10 +387,42 @@ void Car::applyGroundForces() {
     velocity.y -= 9.81f * 0.016f; // Assuming 60 FPS
 }
 
+void Car::applySteering(float deltaTime) {
+    if (!isGrounded || steerInput == 0.0f) return;
+    
+    // Kinematic bicycle model: yaw rate from speed, steer angle and
+    // wheelbase. Positive steer turns right, i.e. clockwise seen from above.
+    float forwardSpeed = velocity.dot(getForward());
+    float steerAngle = steerInput * maxSteerAngle * 3.14159265f / 180.0f;
+    float yaw = -forwardSpeed * SimMath::tan(steerAngle) / getWheelbase() * deltaTime;
+    
+    Vector3 up = getUp();
+    rotation = rotation * Quaternion::fromAxisAngleFast(Vector3::up(), yaw);
+    rotation.normalizeFast();
+    
+    // The tires carry the velocity round with the body as far as the
+    // surface grips; the rest is left to slide
+    float carried = yaw * std::min(groundGrip, 1.0f);
+    Vector3 alongUp = up * velocity.dot(up);
+    velocity = alongUp + Quaternion::fromAxisAngleFast(up, carried) * (velocity - alongUp);
+}
+
+void Car::applyBrakes(float deltaTime) {
+    if (!isGrounded || brakeInput <= 0.0f) return;
+    
+    float speed = getSpeed();
+    if (speed <= 0.0f) return;
+    
+    // Braking is limited by grip and never pushes the car backwards
+    float slowdown = std::min(speed, brakeForce * brakeInput * groundGrip * deltaTime);
+    velocity -= velocity * (slowdown / speed);
+}
+
 void Car::applyAirResistance() {
     float speed = getSpeed();
     if (speed > 0.1f) {
-        Vector3 airResistanceForce = -velocity.normalized() * speed * speed * airResistance;
+        // -direction * speed^2, without normalizing the velocity first
+        Vector3 airResistanceForce = -velocity * (speed * airResistance);
         velocity += airResistanceForce * 0.016f / mass;
     }
 }
@@ -369,7 +492,82 @@ void Car::resetToPosition(const Vector3& pos) {
     position = pos;
 }
 
+void Car::shiftOrigin(const Vector3& shift) {
+    position -= shift;
+    lastPosition -= shift;
+    groundHeight -= shift.y;
+    for (Wheel& wheel : wheels) {
+        wheel.contactPoint -= shift;
+    }
+}
+
 void Car::debugDraw() const {
     // This would be implemented with a debug rendering system
     // For now, it's a placeholder
-}
\ No newline at end of file
+}
+
+void Car::hashState(StateHash& hash) const {
+    hash.add(position);
+    hash.add(velocity);
+    hash.add(angularVelocity);
+    hash.add(rotation);
+    hash.add(lastPosition);
+
+    for (int i = 0; i < 4; i++) {
+        hash.add(wheels[i].rotation);
+        hash.add(wheels[i].angularVelocity);
+        hash.add(wheels[i].heightAboveGround);
+        hash.add(wheels[i].isGrounded);
+        hash.add(wheels[i].normal);
+    }
+
+    hash.add(engine.rpm);
+    hash.add(engine.torque);
+    hash.add(currentBoost);
+    hash.add(isBoosting);
+    hash.add(boostCooldown);
+    hash.add(isGrounded);
+    hash.add(groundHeight);
+    hash.add(groundNormal);
+}
+
+CacheLayout::Report Car::describeLayout() const {
+    CacheLayout::Report report("Car", sizeof(Car), alignof(Car));
+    
+    report.add("position", *this, position, true);
+    report.add("velocity", *this, velocity, true);
+    report.add("angularVelocity", *this, angularVelocity, true);
+    report.add("rotation", *this, rotation, true);
+    report.add("mass", *this, mass, true);
+    report.add("throttleInput", *this, throttleInput, true);
+    report.add("brakeInput", *this, brakeInput, true);
+    report.add("steerInput", *this, steerInput, true);
+    report.add("groundHeight", *this, groundHeight, true);
+    report.add("groundNormal", *this, groundNormal, true);
+    report.add("groundGrip", *this, groundGrip, true);
+    report.add("groundRollingResistance", *this, groundRollingResistance, true);
+    report.add("maxSteerAngle", *this, maxSteerAngle, true);
+    report.add("brakeForce", *this, brakeForce, true);
+    report.add("friction", *this, friction, true);
+    report.add("airResistance", *this, airResistance, true);
+    report.add("downforce", *this, downforce, true);
+    report.add("maxSpeed", *this, maxSpeed, true);
+    report.add("isGrounded", *this, isGrounded, true);
+    report.add("hasGroundContact", *this, hasGroundContact, true);
+    report.add("wheels", *this, wheels, true);
+    report.add("engine", *this, engine, true);
+    
+    report.add("currentBoost", *this, currentBoost, false);
+    report.add("boostCooldown", *this, boostCooldown, false);
+    report.add("boostCapacity", *this, boostCapacity, false);
+    report.add("boostRechargeRate", *this, boostRechargeRate, false);
+    report.add("boostPower", *this, boostPower, false);
+    report.add("speedEffectIntensity", *this, speedEffectIntensity, false);
+    report.add("lastPosition", *this, lastPosition, false);
+    report.add("velocityDirection", *this, velocityDirection, false);
+    report.add("acceleration", *this, acceleration, false);
+    report.add("centerOfMass", *this, centerOfMass, false);
+    report.add("inertia", *this, inertia, false);
+    report.add("isBoosting", *this, isBoosting, false);
+    return report;
+}
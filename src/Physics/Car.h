@@ -2,9 +2,13 @@
 #include "../Math/Vector3.h"
 #include "../Math/Matrix4.h"
 #include "../Math/Quaternion.h"
+#include "GroundQuery.h"
+#include "../Utils/CacheLayout.h"
+#include "../Utils/StateHash.h"
 
 class Car {
 public:
+    // The small fields sit together at the end, to pad once rather than twice
     struct Wheel {
         Vector3 position;
         Vector3 velocity;
@@ -12,11 +16,14 @@ public:
         float angularVelocity;
         float radius;
         float width;
-        bool isGrounded;
         float suspensionLength;
         float suspensionStiffness;
         float damping;
         Vector3 normal; // Ground normal
+        Vector3 contactPoint;
+        float heightAboveGround;  // Of the wheel's rest position, along the probe
+        bool isGrounded;
+        SurfaceMaterial material;
     };
 
     struct Engine {
@@ -33,53 +40,62 @@ public:
     };
 
 private:
-    // Physical properties
-    Vector3 position;
+    // Members are grouped by how often a physics step touches them, and
+    // each group starts on a cache line (see CacheLayout). New fields go
+    // with the group that uses them; tools/LayoutReport shows where they land.
+    
+    // Hot: body state, inputs, ground contact and the handling constants
+    // every step reads (two lines)
+    alignas(CacheLayout::LineSize) Vector3 position;
     Vector3 velocity;
     Vector3 angularVelocity;
     Quaternion rotation;
-    
     float mass;
-    Vector3 centerOfMass;
-    Vector3 inertia;
-    
-    // Wheels
-    Wheel wheels[4]; // Front left, front right, rear left, rear right
-    
-    // Engine
-    Engine engine;
     
     // Input
     float throttleInput;
     float brakeInput;
     float steerInput;
     
+    // Ground under the wheels, from this step's probes
+    float groundHeight;
+    Vector3 groundNormal;
+    float groundGrip;               // Mean surface properties under the
+    float groundRollingResistance;  // wheels in contact
+    
     // Physics constants
     float maxSteerAngle;
-    float maxSpeed;
-    float acceleration;
     float brakeForce;
     float friction;
     float airResistance;
     float downforce;
+    float maxSpeed;
     
-    // Dash/Boost system
-    float boostPower;
-    float boostCapacity;
-    float currentBoost;
-    bool isBoosting;
+    // State
+    bool isGrounded;
+    bool hasGroundContact;  // Any wheel probe found ground this step
+    
+    // Hot: wheels and engine (lines 2-7)
+    alignas(CacheLayout::LineSize) Wheel wheels[4]; // Front left, front right, rear left, rear right
+    Engine engine;
+    
+    // Cold: boost and visual effects, which updateEffects() advances once a
+    // frame after the steps, and tuning nothing reads per step
+    alignas(CacheLayout::LineSize) float currentBoost;
     float boostCooldown;
+    float boostCapacity;
     float boostRechargeRate;
-    
-    // Visual effects
+    float boostPower;
+    float speedEffectIntensity;
     Vector3 lastPosition;
     Vector3 velocityDirection;
-    float speedEffectIntensity;
+    float acceleration;
+    Vector3 centerOfMass;
+    Vector3 inertia;
+    bool isBoosting;
     
-    // State
-    bool isGrounded;
-    float groundHeight;
-    Vector3 groundNormal;
+    // Wheel probes start this far above the wheel mounts
+    static constexpr float WheelProbeHeight = 1.0f;
 
 public:
     Car();
@@ -96,9 +112,17 @@ public:
     float getSpeed() const;
     float getSpeedKmh() const;
     bool getIsGrounded() const { return isGrounded; }
+    bool getHasGroundContact() const { return hasGroundContact; }
+    float getGroundHeight() const { return groundHeight; }
+    Vector3 getGroundNormal() const { return groundNormal; }
+    float getGroundGrip() const { return groundGrip; }
+    float getGroundRollingResistance() const { return groundRollingResistance; }
+    const Wheel& getWheel(int wheelIndex) const { return wheels[wheelIndex]; }
     float getCurrentBoost() const { return currentBoost; }
     bool getIsBoosting() const { return isBoosting; }
     float getSpeedEffectIntensity() const { return speedEffectIntensity; }
+    float getMaxSteerAngle() const { return maxSteerAngle; }  // Degrees
+    float getWheelbase() const;
     
     // Setters
     void setPosition(const Vector3& pos);
@@ -117,17 +141,28 @@ public:
     void setBoost(bool boost);
     void setHandbrake(bool handbrake);
     
-    // Physics update
+    // Physics update. update() is one fixed step; updateEffects() runs
+    // once a frame, after the frame's steps, over the time they covered.
     void update(float deltaTime);
+    void updateEffects(float deltaTime);
     void updatePhysics(float deltaTime);
     void updateWheels(float deltaTime);
     void updateEngine(float deltaTime);
     void updateBoost(float deltaTime);
     void updateVisualEffects(float deltaTime);
     
-    // Collision and ground detection
+    // Collision and ground detection. The physics engine casts every
+    // wheel probe in one batch and hands the four hits back in wheel order.
+    GroundQuery::Cast getWheelCast(int wheelIndex) const;
+    // Same, from the wheel's mount offset and the car's up vector already
+    // rotated into world space (done for all cars at once by the engine)
+    GroundQuery::Cast getWheelCast(int wheelIndex, const Vector3& mountOffset, const Vector3& up) const;
+    Vector3 getWheelMountOffset(int wheelIndex) const;
+    void setWheelContacts(const GroundQuery::Hit* hits);
     void checkGroundCollision();
     void applyGroundForces();
+    void applySteering(float deltaTime);
+    void applyBrakes(float deltaTime);
     void applyAirResistance();
     void applyDownforce();
     
@@ -141,7 +176,14 @@ public:
     Vector3 getWheelPosition(int wheelIndex) const;
     void reset();
     void resetToPosition(const Vector3& pos);
+    // Floating origin: moves every stored position by -shift
+    void shiftOrigin(const Vector3& shift);
     
     // Debug
     void debugDraw() const;
+    // Folds everything update() and updateEffects() carry from one tick to
+    // the next into hash
+    void hashState(StateHash& hash) const;
+    // Where each member sits and which ones every step touches
+    CacheLayout::Report describeLayout() const;
 };
\ No newline at end of file
@@ -0,0 +1,565 @@
+#include "GroundQuery.h"
+#include "../World/Track.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+    float component(const Vector3& v, int axis) {
+        return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+    }
+
+    float safeInverse(float value) {
+        return value != 0.0f ? 1.0f / value : std::copysign(1e30f, value);
+    }
+
+    Vector3 vertexPosition(const TrackVertex& vertex) {
+        return Vector3(vertex.position[0], vertex.position[1], vertex.position[2]);
+    }
+
+    // The floor only wins when clearly closer, so surfaces lying on it
+    // (like a flat track at the floor's height) take precedence
+    constexpr float GroundPlaneBias = 1e-3f;
+}
+
+GroundQuery::GroundQuery()
+    : sourceTrack(nullptr)
+    , sourceGeometryVersion(0)
+    , sourceLayoutVersion(0)
+    , hasGroundPlane(true)
+    , groundPlaneNormal(0.0f, 1.0f, 0.0f)
+    , groundPlaneHeight(0.0f)
+    , groundPlaneMaterial(SurfaceMaterial::Grass) {
+    heightfield.minX = heightfield.minZ = 0.0f;
+    heightfield.cellSize = 1.0f;
+    heightfield.width = heightfield.depth = 0;
+    heightfield.material = SurfaceMaterial::Grass;
+}
+
+void GroundQuery::buildFromTrack(const Track& track) {
+    std::vector<Triangle>& triangles = trackBvh.triangles;
+    triangles.clear();
+
+    int count = (int)(track.getTrackIndices().size() / 3);
+    triangles.reserve(count);
+    for (int i = 0; i < count; i++) {
+        triangles.push_back(makeTrackTriangle(track, i));
+    }
+
+    sourceTrack = &track;
+    sourceGeometryVersion = track.getGeometryVersion();
+    sourceLayoutVersion = track.getLayoutVersion();
+    buildBvh(trackBvh);
+}
+
+void GroundQuery::syncWithTrack(const Track& track) {
+    if (&track != sourceTrack || track.getLayoutVersion() != sourceLayoutVersion) {
+        buildFromTrack(track);
+    } else if (track.getGeometryVersion() != sourceGeometryVersion) {
+        refit(track);
+    }
+}
+
+void GroundQuery::clearTrack() {
+    trackBvh.triangles.clear();
+    trackBvh.nodes.clear();
+    sourceTrack = nullptr;
+}
+
+void GroundQuery::setTrackChunk(int index, const TrackVertex* vertices, const unsigned int* indices, size_t indexCount,
+                                const SurfaceMaterial* surfaces) {
+    if (index < 0) return;
+    if ((size_t)index >= chunkBvhs.size()) {
+        chunkBvhs.resize(index + 1);
+    }
+
+    Bvh& bvh = chunkBvhs[index];
+    bvh.triangles.clear();
+    bvh.triangles.reserve(indexCount / 3);
+    for (size_t i = 0; i + 2 < indexCount; i += 3) {
+        bvh.triangles.push_back(makeTriangle(vertexPosition(vertices[indices[i]]),
+                                             vertexPosition(vertices[indices[i + 1]]),
+                                             vertexPosition(vertices[indices[i + 2]]),
+                                             -1, surfaces[i / 6]));
+    }
+    buildBvh(bvh);
+}
+
+void GroundQuery::removeTrackChunk(int index) {
+    if (index < 0 || (size_t)index >= chunkBvhs.size()) return;
+
+    // Replaced rather than cleared, so the memory goes with the chunk
+    chunkBvhs[index] = Bvh();
+}
+
+void GroundQuery::clearTrackChunks() {
+    chunkBvhs.clear();
+}
+
+size_t GroundQuery::getTriangleCount() const {
+    size_t count = trackBvh.triangles.size();
+    for (const Bvh& bvh : chunkBvhs) {
+        count += bvh.triangles.size();
+    }
+    return count;
+}
+
+size_t GroundQuery::getNodeCount() const {
+    size_t count = trackBvh.nodes.size();
+    for (const Bvh& bvh : chunkBvhs) {
+        count += bvh.nodes.size();
+    }
+    return count;
+}
+
+void GroundQuery::setHeightfield(float minX, float minZ, float cellSize, int width, int depth,
+                                 const std::vector<float>& heights, SurfaceMaterial material) {
+    if (width < 2 || depth < 2 || cellSize <= 0.0f || heights.size() != (size_t)width * depth) {
+        clearHeightfield();
+        return;
+    }
+
+    heightfield.minX = minX;
+    heightfield.minZ = minZ;
+    heightfield.cellSize = cellSize;
+    heightfield.width = width;
+    heightfield.depth = depth;
+    heightfield.heights = heights;
+    heightfield.cellMaterials.clear();
+    heightfield.material = material;
+}
+
+void GroundQuery::setHeightfieldMaterials(const std::vector<SurfaceMaterial>& cellMaterials) {
+    size_t cells = (size_t)std::max(0, heightfield.width - 1) * std::max(0, heightfield.depth - 1);
+    if (cellMaterials.size() == cells) {
+        heightfield.cellMaterials = cellMaterials;
+    } else {
+        heightfield.cellMaterials.clear();
+    }
+}
+
+void GroundQuery::clearHeightfield() {
+    heightfield.width = heightfield.depth = 0;
+    heightfield.heights.clear();
+    heightfield.cellMaterials.clear();
+}
+
+void GroundQuery::setGroundPlane(bool enabled, float height, const Vector3& normal, SurfaceMaterial material) {
+    hasGroundPlane = enabled;
+    groundPlaneHeight = height;
+    groundPlaneNormal = normal.normalized();
+    groundPlaneMaterial = material;
+}
+
+void GroundQuery::shiftOrigin(const Vector3& shift) {
+    if (sourceTrack) {
+        if (sourceTrack->getLayoutVersion() != sourceLayoutVersion) {
+            buildFromTrack(*sourceTrack);
+        } else {
+            refit(*sourceTrack);
+        }
+    }
+
+    // Chunk BVHs move in step with the streamer's resident chunks
+    for (Bvh& bvh : chunkBvhs) {
+        for (Triangle& triangle : bvh.triangles) {
+            triangle.v0 -= shift;
+        }
+        for (Node& node : bvh.nodes) {
+            node.boundsMin[0] -= shift.x;
+            node.boundsMin[1] -= shift.y;
+            node.boundsMin[2] -= shift.z;
+            node.boundsMax[0] -= shift.x;
+            node.boundsMax[1] -= shift.y;
+            node.boundsMax[2] -= shift.z;
+        }
+    }
+
+    heightfield.minX -= shift.x;
+    heightfield.minZ -= shift.z;
+    for (float& height : heightfield.heights) {
+        height -= shift.y;
+    }
+
+    // The floor passes through (0, height, 0)
+    if (groundPlaneNormal.y != 0.0f) {
+        groundPlaneHeight -= groundPlaneNormal.dot(shift) / groundPlaneNormal.y;
+    }
+}
+
+GroundQuery::Hit GroundQuery::cast(const Cast& cast) const {
+    Hit best;
+    best.point = cast.origin + cast.direction * cast.maxDistance;
+    best.normal = Vector3::up();
+    best.distance = cast.maxDistance;
+    best.material = SurfaceMaterial::Asphalt;
+    best.hit = false;
+
+    castTrack(cast, best);
+    castHeightfield(cast, best);
+    castGroundPlane(cast, best);
+    return best;
+}
+
+void GroundQuery::castBatch(const Cast* casts, Hit* hits, size_t count) const {
+    for (size_t i = 0; i < count; i++) {
+        hits[i] = cast(casts[i]);
+    }
+}
+
+GroundQuery::Hit GroundQuery::raycast(const Vector3& origin, const Vector3& direction, float maxDistance) const {
+    return cast({ origin, direction, maxDistance, 0.0f });
+}
+
+GroundQuery::Hit GroundQuery::sphereCast(const Vector3& origin, const Vector3& direction, float maxDistance, float radius) const {
+    return cast({ origin, direction, maxDistance, radius });
+}
+
+void GroundQuery::buildBvh(Bvh& bvh) {
+    bvh.nodes.clear();
+    if (bvh.triangles.empty()) return;
+
+    bvh.nodes.reserve(bvh.triangles.size() * 2);
+    bvh.nodes.push_back(Node());
+    buildNode(bvh, 0, 0, (int)bvh.triangles.size(), 0);
+}
+
+void GroundQuery::buildNode(Bvh& bvh, int nodeIndex, int first, int count, int depth) {
+    std::vector<Triangle>& triangles = bvh.triangles;
+    std::vector<Node>& nodes = bvh.nodes;
+    computeBounds(bvh, nodes[nodeIndex], first, count);
+    nodes[nodeIndex].first = first;
+    nodes[nodeIndex].count = count;
+    if (count <= MaxLeafTriangles || depth >= MaxDepth) return;
+
+    // Split at the median centroid along the widest centroid axis
+    float centroidMin[3] = { std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max() };
+    float centroidMax[3] = { -std::numeric_limits<float>::max(), -std::numeric_limits<float>::max(), -std::numeric_limits<float>::max() };
+    for (int i = first; i < first + count; i++) {
+        const Triangle& triangle = triangles[i];
+        Vector3 centroid = triangle.v0 + (triangle.edge1 + triangle.edge2) / 3.0f;
+        for (int axis = 0; axis < 3; axis++) {
+            centroidMin[axis] = std::min(centroidMin[axis], component(centroid, axis));
+            centroidMax[axis] = std::max(centroidMax[axis], component(centroid, axis));
+        }
+    }
+
+    int axis = 0;
+    for (int i = 1; i < 3; i++) {
+        if (centroidMax[i] - centroidMin[i] > centroidMax[axis] - centroidMin[axis]) axis = i;
+    }
+    if (centroidMax[axis] - centroidMin[axis] <= 0.0f) return;
+
+    int mid = first + count / 2;
+    std::nth_element(triangles.begin() + first, triangles.begin() + mid, triangles.begin() + first + count,
+                     [axis](const Triangle& a, const Triangle& b) {
+        return component(a.v0 * 3.0f + a.edge1 + a.edge2, axis) < component(b.v0 * 3.0f + b.edge1 + b.edge2, axis);
+    });
+
+    int left = (int)nodes.size();
+    nodes.push_back(Node());
+    buildNode(bvh, left, first, mid - first, depth + 1);
+
+    int right = (int)nodes.size();
+    nodes.push_back(Node());
+    buildNode(bvh, right, mid, first + count - mid, depth + 1);
+
+    nodes[nodeIndex].first = right;
+    nodes[nodeIndex].count = 0;
+}
+
+void GroundQuery::computeBounds(const Bvh& bvh, Node& node, int first, int count) const {
+    for (int axis = 0; axis < 3; axis++) {
+        node.boundsMin[axis] = std::numeric_limits<float>::max();
+        node.boundsMax[axis] = -std::numeric_limits<float>::max();
+    }
+
+    for (int i = first; i < first + count; i++) {
+        const Triangle& triangle = bvh.triangles[i];
+        Vector3 corners[3] = { triangle.v0, triangle.v0 + triangle.edge1, triangle.v0 + triangle.edge2 };
+        for (const Vector3& corner : corners) {
+            for (int axis = 0; axis < 3; axis++) {
+                node.boundsMin[axis] = std::min(node.boundsMin[axis], component(corner, axis));
+                node.boundsMax[axis] = std::max(node.boundsMax[axis], component(corner, axis));
+            }
+        }
+    }
+}
+
+void GroundQuery::refit(const Track& track) {
+    std::vector<Node>& nodes = trackBvh.nodes;
+    for (Triangle& triangle : trackBvh.triangles) {
+        triangle = makeTrackTriangle(track, triangle.source);
+    }
+
+    // Children always follow their parent, so a reverse sweep is bottom-up
+    for (int i = (int)nodes.size() - 1; i >= 0; i--) {
+        Node& node = nodes[i];
+        if (node.count > 0) {
+            computeBounds(trackBvh, node, node.first, node.count);
+            continue;
+        }
+
+        const Node& left = nodes[i + 1];
+        const Node& right = nodes[node.first];
+        for (int axis = 0; axis < 3; axis++) {
+            node.boundsMin[axis] = std::min(left.boundsMin[axis], right.boundsMin[axis]);
+            node.boundsMax[axis] = std::max(left.boundsMax[axis], right.boundsMax[axis]);
+        }
+    }
+
+    sourceGeometryVersion = track.getGeometryVersion();
+}
+
+void GroundQuery::castTrack(const Cast& cast, Hit& best) const {
+    Vector3 inverseDirection(safeInverse(cast.direction.x), safeInverse(cast.direction.y), safeInverse(cast.direction.z));
+
+    castBvh(cast, inverseDirection, trackBvh, best);
+    for (const Bvh& bvh : chunkBvhs) {
+        castBvh(cast, inverseDirection, bvh, best);
+    }
+}
+
+void GroundQuery::castBvh(const Cast& cast, const Vector3& inverseDirection, const Bvh& bvh, Hit& best) const {
+    const std::vector<Node>& nodes = bvh.nodes;
+    if (nodes.empty()) return;
+
+    int stack[MaxDepth * 2 + 2];
+    int top = 0;
+    stack[top++] = 0;
+
+    while (top > 0) {
+        int index = stack[--top];
+        const Node& node = nodes[index];
+        if (!castBounds(cast, inverseDirection, node, best.distance)) continue;
+
+        if (node.count > 0) {
+            for (int i = node.first; i < node.first + node.count; i++) {
+                castTriangle(cast, bvh.triangles[i], best);
+            }
+        } else {
+            stack[top++] = node.first;
+            stack[top++] = index + 1;
+        }
+    }
+}
+
+void GroundQuery::castHeightfield(const Cast& cast, Hit& best) const {
+    const Heightfield& field = heightfield;
+    if (field.width < 2 || field.depth < 2) return;
+
+    int cellsX = field.width - 1;
+    int cellsZ = field.depth - 1;
+
+    auto castCell = [&](int x, int z) {
+        auto corner = [&](int cx, int cz) {
+            return Vector3(field.minX + cx * field.cellSize, field.heights[cz * field.width + cx], field.minZ + cz * field.cellSize);
+        };
+        Vector3 p00 = corner(x, z), p10 = corner(x + 1, z);
+        Vector3 p01 = corner(x, z + 1), p11 = corner(x + 1, z + 1);
+        SurfaceMaterial material = field.cellMaterials.empty() ? field.material : field.cellMaterials[z * cellsX + x];
+        castTriangle(cast, makeTriangle(p00, p11, p10, -1, material), best);
+        castTriangle(cast, makeTriangle(p00, p01, p11, -1, material), best);
+    };
+
+    if (cast.radius > 0.0f) {
+        // Sphere casts (short wheel probes) test every cell under their swept footprint
+        Vector3 end = cast.origin + cast.direction * best.distance;
+        int x0 = (int)std::floor((std::min(cast.origin.x, end.x) - cast.radius - field.minX) / field.cellSize);
+        int x1 = (int)std::floor((std::max(cast.origin.x, end.x) + cast.radius - field.minX) / field.cellSize);
+        int z0 = (int)std::floor((std::min(cast.origin.z, end.z) - cast.radius - field.minZ) / field.cellSize);
+        int z1 = (int)std::floor((std::max(cast.origin.z, end.z) + cast.radius - field.minZ) / field.cellSize);
+
+        for (int z = std::max(0, z0); z <= std::min(cellsZ - 1, z1); z++) {
+            for (int x = std::max(0, x0); x <= std::min(cellsX - 1, x1); x++) {
+                castCell(x, z);
+            }
+        }
+        return;
+    }
+
+    // Rays walk the cells they cross, front to back
+    float tEnter = 0.0f;
+    float tExit = best.distance;
+    float bounds[2][2] = { { field.minX, field.minX + cellsX * field.cellSize },
+                           { field.minZ, field.minZ + cellsZ * field.cellSize } };
+    float origin[2] = { cast.origin.x, cast.origin.z };
+    float direction[2] = { cast.direction.x, cast.direction.z };
+    for (int axis = 0; axis < 2; axis++) {
+        float inverse = safeInverse(direction[axis]);
+        float t0 = (bounds[axis][0] - origin[axis]) * inverse;
+        float t1 = (bounds[axis][1] - origin[axis]) * inverse;
+        if (t0 > t1) std::swap(t0, t1);
+        tEnter = std::max(tEnter, t0);
+        tExit = std::min(tExit, t1);
+    }
+    if (tEnter > tExit) return;
+
+    Vector3 start = cast.origin + cast.direction * tEnter;
+    int x = std::max(0, std::min(cellsX - 1, (int)std::floor((start.x - field.minX) / field.cellSize)));
+    int z = std::max(0, std::min(cellsZ - 1, (int)std::floor((start.z - field.minZ) / field.cellSize)));
+
+    int stepX = cast.direction.x > 0.0f ? 1 : -1;
+    int stepZ = cast.direction.z > 0.0f ? 1 : -1;
+    float infinity = std::numeric_limits<float>::infinity();
+    float deltaX = cast.direction.x != 0.0f ? field.cellSize / std::fabs(cast.direction.x) : infinity;
+    float deltaZ = cast.direction.z != 0.0f ? field.cellSize / std::fabs(cast.direction.z) : infinity;
+    float nextX = cast.direction.x != 0.0f
+        ? (field.minX + (x + (stepX > 0 ? 1 : 0)) * field.cellSize - cast.origin.x) / cast.direction.x : infinity;
+    float nextZ = cast.direction.z != 0.0f
+        ? (field.minZ + (z + (stepZ > 0 ? 1 : 0)) * field.cellSize - cast.origin.z) / cast.direction.z : infinity;
+
+    while (x >= 0 && x < cellsX && z >= 0 && z < cellsZ) {
+        castCell(x, z);
+
+        // Nothing in later cells can beat a hit before this cell's exit
+        if (best.distance <= std::min(nextX, nextZ)) break;
+
+        if (nextX < nextZ) {
+            x += stepX;
+            nextX += deltaX;
+        } else {
+            z += stepZ;
+            nextZ += deltaZ;
+        }
+    }
+}
+
+void GroundQuery::castGroundPlane(const Cast& cast, Hit& best) const {
+    if (!hasGroundPlane) return;
+
+    const Vector3& normal = groundPlaneNormal;
+    float offset = normal.y * groundPlaneHeight;
+    float startDistance = normal.dot(cast.origin) - offset;
+    float approach = cast.direction.dot(normal);
+
+    // Anything that starts touching or below the floor is pushed out at once
+    float t = 0.0f;
+    if (startDistance > cast.radius) {
+        if (approach >= 0.0f) return;
+        t = (startDistance - cast.radius) / -approach;
+    }
+    if (t >= best.distance - GroundPlaneBias) return;
+
+    Vector3 center = cast.origin + cast.direction * t;
+    best.point = center - normal * (normal.dot(center) - offset);
+    best.normal = normal;
+    best.distance = t;
+    best.material = groundPlaneMaterial;
+    best.hit = true;
+}
+
+bool GroundQuery::castTriangle(const Cast& cast, const Triangle& triangle, Hit& best) const {
+    const Vector3& direction = cast.direction;
+
+    // Surfaces are two-sided; report the normal facing back along the cast
+    Vector3 normal = direction.dot(triangle.normal) > 0.0f ? -triangle.normal : triangle.normal;
+
+    if (cast.radius <= 0.0f) {
+        Vector3 p = direction.cross(triangle.edge2);
+        float determinant = triangle.edge1.dot(p);
+        if (std::fabs(determinant) < 1e-12f) return false;
+
+        float inverse = 1.0f / determinant;
+        Vector3 s = cast.origin - triangle.v0;
+        float u = s.dot(p) * inverse;
+        if (u < 0.0f || u > 1.0f) return false;
+
+        Vector3 q = s.cross(triangle.edge1);
+        float v = direction.dot(q) * inverse;
+        if (v < 0.0f || u + v > 1.0f) return false;
+
+        float t = triangle.edge2.dot(q) * inverse;
+        if (t < 0.0f || t >= best.distance) return false;
+
+        best.point = cast.origin + direction * t;
+        best.normal = normal;
+        best.distance = t;
+        best.material = triangle.material;
+        best.hit = true;
+        return true;
+    }
+
+    // Swept sphere against the face: find where the sphere first touches
+    // the plane, then check the touch point lies on the triangle. Edges are
+    // covered by the neighbouring faces of a continuous surface.
+    float startDistance = (cast.origin - triangle.v0).dot(normal);
+    if (startDistance < -cast.radius) return false;
+
+    float t = 0.0f;
+    if (startDistance > cast.radius) {
+        float approach = direction.dot(normal);
+        if (approach >= -1e-8f) return false;
+        t = (startDistance - cast.radius) / -approach;
+    }
+    if (t >= best.distance) return false;
+
+    Vector3 center = cast.origin + direction * t;
+    Vector3 contact = center - normal * (center - triangle.v0).dot(normal);
+
+    Vector3 w = contact - triangle.v0;
+    float d00 = triangle.edge1.dot(triangle.edge1);
+    float d01 = triangle.edge1.dot(triangle.edge2);
+    float d11 = triangle.edge2.dot(triangle.edge2);
+    float d20 = w.dot(triangle.edge1);
+    float d21 = w.dot(triangle.edge2);
+    float denominator = d00 * d11 - d01 * d01;
+    if (std::fabs(denominator) < 1e-12f) return false;
+
+    float v = (d11 * d20 - d01 * d21) / denominator;
+    float u = (d00 * d21 - d01 * d20) / denominator;
+    if (v < 0.0f || u < 0.0f || u + v > 1.0f) return false;
+
+    best.point = contact;
+    best.normal = normal;
+    best.distance = t;
+    best.material = triangle.material;
+    best.hit = true;
+    return true;
+}
+
+bool GroundQuery::castBounds(const Cast& cast, const Vector3& inverseDirection, const Node& node, float maxDistance) const {
+    float tMin = 0.0f;
+    float tMax = maxDistance;
+
+    for (int axis = 0; axis < 3; axis++) {
+        float origin = component(cast.origin, axis);
+        float inverse = component(inverseDirection, axis);
+        float t0 = (node.boundsMin[axis] - cast.radius - origin) * inverse;
+        float t1 = (node.boundsMax[axis] + cast.radius - origin) * inverse;
+        if (t0 > t1) std::swap(t0, t1);
+
+        tMin = std::max(tMin, t0);
+        tMax = std::min(tMax, t1);
+        if (tMin > tMax) return false;
+    }
+    return true;
+}
+
+GroundQuery::Triangle GroundQuery::makeTriangle(const Vector3& a, const Vector3& b, const Vector3& c, int source, SurfaceMaterial material) const {
+    Triangle triangle;
+    triangle.v0 = a;
+    triangle.edge1 = b - a;
+    triangle.edge2 = c - a;
+
+    Vector3 normal = triangle.edge1.cross(triangle.edge2);
+    triangle.normal = normal.lengthSquared() > 0.0f ? normal.normalized() : Vector3::up();
+    triangle.source = source;
+    triangle.material = material;
+    return triangle;
+}
+
+GroundQuery::Triangle GroundQuery::makeTrackTriangle(const Track& track, int source) const {
+    ArrayView<TrackVertex> vertices = track.getTrackVertices();
+    ArrayView<unsigned int> indices = track.getTrackIndices();
+    ArrayView<Track::TrackPoint> points = track.getTrackPoints();
+    Vector3 origin = track.getOrigin();
+    size_t i = (size_t)source * 3;
+
+    // Two triangles per segment, and segment i starts at track point i
+    SurfaceMaterial material = points[std::min((size_t)source / 2, points.size() - 1)].surface;
+    return makeTriangle(vertexPosition(vertices[indices[i]]) - origin,
+                        vertexPosition(vertices[indices[i + 1]]) - origin,
+                        vertexPosition(vertices[indices[i + 2]]) - origin,
+                        source, material);
+}
@@ -0,0 +1,141 @@
+#pragma once
+#include "../Math/Vector3.h"
+#include "../World/TrackFormat.h"
+#include "SurfaceMaterial.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Track;
+
+// Answers ray and sphere casts against everything cars can drive on: the
+// track surface mesh (in a BVH, or one per resident chunk of a streamed
+// track), an optional heightfield terrain, and a ground plane underneath
+// both. Casts are issued in batches, one call per physics step for every
+// wheel of every car.
+class GroundQuery {
+public:
+    // A ray when radius is 0, otherwise a swept sphere
+    struct Cast {
+        Vector3 origin;
+        Vector3 direction;  // Unit length
+        float maxDistance;
+        float radius;
+    };
+
+    struct Hit {
+        Vector3 point;   // Contact point on the surface
+        Vector3 normal;  // Facing back along the cast
+        float distance;  // How far the origin travelled before contact
+        SurfaceMaterial material;
+        bool hit;
+    };
+
+private:
+    // Precomputed for Moller-Trumbore; 'source' is the index of the
+    // triangle in the track's index buffer, used to refit after edits
+    struct Triangle {
+        Vector3 v0, edge1, edge2;
+        Vector3 normal;
+        int source;
+        SurfaceMaterial material;
+    };
+
+    // Flattened pre-order BVH. An interior node's left child follows it;
+    // 'first' is its right child. A leaf holds 'count' triangles from 'first'.
+    struct Node {
+        float boundsMin[3];
+        float boundsMax[3];
+        int first;
+        int count;
+    };
+    static constexpr int MaxLeafTriangles = 4;
+    static constexpr int MaxDepth = 64;
+
+    struct Bvh {
+        std::vector<Triangle> triangles;
+        std::vector<Node> nodes;
+    };
+    Bvh trackBvh;
+
+    // Streamed track: chunk index to its BVH, empty while not resident
+    std::vector<Bvh> chunkBvhs;
+
+    // Track the BVH was built from, to rebuild or refit after edits
+    const Track* sourceTrack;
+    uint32_t sourceGeometryVersion;
+    uint32_t sourceLayoutVersion;
+
+    // Heightfield terrain: width x depth height samples on an XZ grid.
+    // Cells take 'material' unless per-cell materials are set.
+    struct Heightfield {
+        float minX, minZ;
+        float cellSize;
+        int width, depth;
+        std::vector<float> heights;
+        std::vector<SurfaceMaterial> cellMaterials;
+        SurfaceMaterial material;
+    };
+    Heightfield heightfield;
+
+    // Infinite floor under everything else
+    bool hasGroundPlane;
+    Vector3 groundPlaneNormal;
+    float groundPlaneHeight;
+    SurfaceMaterial groundPlaneMaterial;
+
+public:
+    GroundQuery();
+
+    // Track surface; triangles take the surface of their track segment.
+    // syncWithTrack is cheap when nothing changed, refits the BVH after
+    // in-place edits and rebuilds it after layout changes.
+    void buildFromTrack(const Track& track);
+    void syncWithTrack(const Track& track);
+    void clearTrack();
+
+    // Streamed track (see TrackStreamer), in place of the above: a BVH per
+    // resident chunk, built from its local geometry when it arrives and
+    // dropped when it is evicted. Segment i takes surfaces[i], and covers
+    // indices 6i to 6i + 5.
+    void setTrackChunk(int index, const TrackVertex* vertices, const unsigned int* indices, size_t indexCount,
+                       const SurfaceMaterial* surfaces);
+    void removeTrackChunk(int index);
+    void clearTrackChunks();
+
+    // Terrain and floor
+    void setHeightfield(float minX, float minZ, float cellSize, int width, int depth,
+                        const std::vector<float>& heights, SurfaceMaterial material = SurfaceMaterial::Grass);
+    void setHeightfieldMaterials(const std::vector<SurfaceMaterial>& cellMaterials);  // (width - 1) * (depth - 1)
+    void clearHeightfield();
+    void setGroundPlane(bool enabled, float height = 0.0f, const Vector3& normal = Vector3::up(),
+                        SurfaceMaterial material = SurfaceMaterial::Grass);
+
+    // Floating origin: moves the terrain, floor and track chunks by -shift
+    // and rebuilds the track triangles against the track's origin, which
+    // the caller has already moved (see Track::setOrigin)
+    void shiftOrigin(const Vector3& shift);
+
+    // Queries
+    Hit cast(const Cast& cast) const;
+    void castBatch(const Cast* casts, Hit* hits, size_t count) const;
+    Hit raycast(const Vector3& origin, const Vector3& direction, float maxDistance) const;
+    Hit sphereCast(const Vector3& origin, const Vector3& direction, float maxDistance, float radius) const;
+
+    size_t getTriangleCount() const;
+    size_t getNodeCount() const;
+
+private:
+    void buildBvh(Bvh& bvh);
+    void buildNode(Bvh& bvh, int nodeIndex, int first, int count, int depth);
+    void computeBounds(const Bvh& bvh, Node& node, int first, int count) const;
+    void refit(const Track& track);
+    void castTrack(const Cast& cast, Hit& best) const;
+    void castBvh(const Cast& cast, const Vector3& inverseDirection, const Bvh& bvh, Hit& best) const;
+    void castHeightfield(const Cast& cast, Hit& best) const;
+    void castGroundPlane(const Cast& cast, Hit& best) const;
+    bool castTriangle(const Cast& cast, const Triangle& triangle, Hit& best) const;
+    bool castBounds(const Cast& cast, const Vector3& inverseDirection, const Node& node, float maxDistance) const;
+    Triangle makeTriangle(const Vector3& a, const Vector3& b, const Vector3& c, int source, SurfaceMaterial material) const;
+    Triangle makeTrackTriangle(const Track& track, int source) const;
+};
@@ -47,10 +47,12 @@ void PhysicsEngine::setGroundFriction(float friction) {
 
 void PhysicsEngine::setGroundHeight(float height) {
     groundHeight = height;
+    groundQuery.setGroundPlane(true, groundHeight, groundNormal);
 }
 
 void PhysicsEngine::setGroundNormal(const Vector3& normal) {
     groundNormal = normal.normalized();
+    groundQuery.setGroundPlane(true, groundHeight, groundNormal);
 }
 
 void PhysicsEngine::setEnableCollisions(bool enable) {
@@ -82,9 +84,19 @@ void PhysicsEngine::update(float deltaTime) {
         remainingTime -= currentTimeStep;
         substeps++;
     }
+    
+    // Boost and visual effects once, over the time the steps covered
+    float simulatedTime = deltaTime - std::max(0.0f, remainingTime);
+    for (Car* car : cars) {
+        if (car != nullptr) {
+            car->updateEffects(simulatedTime);
+        }
+    }
 }
 
 void PhysicsEngine::updateCars(float deltaTime) {
+    updateWheelContacts();
+    
     for (Car* car : cars) {
         if (car != nullptr) {
             updateGroundCollision(car);
@@ -93,6 +105,43 @@ void PhysicsEngine::updateCars(float deltaTime) {
     }
 }
 
+void PhysicsEngine::updateWheelContacts() {
+    wheelRotations.clear();
+    wheelOffsets.clear();
+    for (Car* car : cars) {
+        if (car == nullptr) continue;
+        Quaternion rotation = car->getRotation();
+        for (int i = 0; i < 4; i++) {
+            wheelRotations.push_back(rotation);
+            wheelOffsets.push_back(car->getWheelMountOffset(i));
+        }
+        wheelRotations.push_back(rotation);
+        wheelOffsets.push_back(Vector3::up());
+    }
+    TransformBatch::rotateVectors(wheelRotations, wheelOffsets, wheelDirections);
+    
+    wheelCasts.clear();
+    size_t next = 0;
+    for (Car* car : cars) {
+        if (car == nullptr) continue;
+        Vector3 up = wheelDirections.get(next + 4);
+        for (int i = 0; i < 4; i++) {
+            wheelCasts.push_back(car->getWheelCast(i, wheelDirections.get(next + i), up));
+        }
+        next += 5;
+    }
+    
+    wheelHits.resize(wheelCasts.size());
+    groundQuery.castBatch(wheelCasts.data(), wheelHits.data(), wheelCasts.size());
+    
+    next = 0;
+    for (Car* car : cars) {
+        if (car == nullptr) continue;
+        car->setWheelContacts(&wheelHits[next]);
+        next += 4;
+    }
+}
+
 void PhysicsEngine::updateCollisions() {
     // Simple collision detection between cars
     for (size_t i = 0; i < cars.size(); i++) {
@@ -101,10 +150,13 @@ void PhysicsEngine::updateCollisions() {
                 Vector3 pos1 = cars[i]->getPosition();
                 Vector3 pos2 = cars[j]->getPosition();
                 
-                float distance = (pos1 - pos2).length();
                 float collisionRadius = 2.0f; // Car collision radius
+                float distanceSq = (pos1 - pos2).lengthSquared();
                 
-                if (distance < collisionRadius * 2.0f) {
+                // Only pairs that touch pay for the square root
+                if (distanceSq < collisionRadius * collisionRadius * 4.0f) {
+                    float distance = std::sqrt(distanceSq);
+                    
                     // Simple collision response
                     Vector3 collisionVector = (pos1 - pos2).normalized();
                     float overlap = collisionRadius * 2.0f - distance;
@@ -128,29 +180,52 @@ void PhysicsEngine::updateCollisions() {
 }
 
 void PhysicsEngine::updateGroundCollision(Car* car) {
-    if (car == nullptr) return;
+    if (car == nullptr || !car->getHasGroundContact()) return;
     
     Vector3 carPos = car->getPosition();
+    float height = car->getGroundHeight();
+    Vector3 normal = car->getGroundNormal();
     
-    // Simple ground plane collision
-    if (carPos.y <= groundHeight) {
-        car->setPosition(Vector3(carPos.x, groundHeight, carPos.z));
+    // Ground under the car, from its wheel contacts
+    if (carPos.y <= height) {
+        car->setPosition(Vector3(carPos.x, height, carPos.z));
         
         // Apply ground friction and normal force
         Vector3 velocity = car->getVelocity();
-        if (velocity.y < 0.0f) {
-            velocity.y = 0.0f; // Stop downward velocity
+        float intoGround = velocity.dot(normal);
+        if (intoGround < 0.0f) {
+            velocity -= normal * intoGround; // Stop velocity into the ground
         }
         
         // Apply ground friction
-        Vector3 horizontalVelocity = Vector3(velocity.x, 0.0f, velocity.z);
-        Vector3 frictionForce = -horizontalVelocity * groundFriction;
+        Vector3 tangentVelocity = velocity - normal * velocity.dot(normal);
+        Vector3 frictionForce = -tangentVelocity * (groundFriction * car->getGroundRollingResistance() * RollingResistanceScale);
         velocity += frictionForce * 0.016f; // Assuming 60 FPS
         
         car->setVelocity(velocity);
     }
 }
 
+void PhysicsEngine::shiftOrigin(const Vector3& shift) {
+    for (Car* car : cars) {
+        car->shiftOrigin(shift);
+    }
+    groundQuery.shiftOrigin(shift);
+    
+    // Kept in step with the query's floor, which passes through (0, height, 0)
+    if (groundNormal.y != 0.0f) {
+        groundHeight -= groundNormal.dot(shift) / groundNormal.y;
+    }
+}
+
+uint64_t PhysicsEngine::computeStateHash() const {
+    StateHash hash;
+    for (const Car* car : cars) {
+        car->hashState(hash);
+    }
+    return hash.get();
+}
+
 void PhysicsEngine::debugDraw() const {
     // This would be implemented with a debug rendering system
     // For now, it's a placeholder
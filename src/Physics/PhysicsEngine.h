@@ -1,6 +1,9 @@
 #pragma once
 #include "Car.h"
+#include "GroundQuery.h"
 #include "../Math/Vector3.h"
+#include "../Math/TransformBatch.h"
+#include <cstdint>
 #include <vector>
 
 class PhysicsEngine {
@@ -14,6 +17,15 @@ private:
     // Ground properties
     float groundHeight;
     Vector3 groundNormal;
+    GroundQuery groundQuery;
+    
+    // Wheel probes for every car, cast together each step. The mount
+    // offsets and up vectors (five per car) are rotated in one batch first.
+    std::vector<GroundQuery::Cast> wheelCasts;
+    std::vector<GroundQuery::Hit> wheelHits;
+    TransformBatch::QuaternionArrays wheelRotations;
+    TransformBatch::Vector3Arrays wheelOffsets;
+    TransformBatch::Vector3Arrays wheelDirections;
     
     // Performance settings
     int maxSubsteps;
@@ -41,6 +53,7 @@ public:
     // Physics update
     void update(float deltaTime);
     void updateCars(float deltaTime);
+    void updateWheelContacts();
     void updateCollisions();
     void updateGroundCollision(Car* car);
     
@@ -49,6 +62,16 @@ public:
     float getAirDensity() const { return airDensity; }
     float getGroundFriction() const { return groundFriction; }
     bool getEnableCollisions() const { return enableCollisions; }
+    GroundQuery& getGroundQuery() { return groundQuery; }
+    const GroundQuery& getGroundQuery() const { return groundQuery; }
+    
+    // Floating origin: moves the cars and the ground by -shift. The track's
+    // origin must already have moved (see WorldOrigin).
+    void shiftOrigin(const Vector3& shift);
+    
+    // Hash of every car's simulation state, in the order they were added.
+    // Log it each tick to check two runs stay bit-identical.
+    uint64_t computeStateHash() const;
     
     // Debug
     void debugDraw() const;
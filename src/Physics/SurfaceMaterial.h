@@ -0,0 +1,37 @@
+#pragma once
+#include <cstdint>
+
+// Compact surface id carried by ground contacts
+enum class SurfaceMaterial : uint8_t {
+    Asphalt,
+    Kerb,
+    Grass,
+    Gravel,
+    Ice,
+    Count
+};
+
+// What a surface does to tires and which effects it plays
+struct SurfaceProperties {
+    float friction;           // Grip: resists sliding and limits traction
+    float rollingResistance;  // Drag along the heading, relative to asphalt
+    uint8_t soundId;          // Rolling sound loop
+    uint8_t particleId;       // Wheel dust/spray effect, 0 for none
+};
+
+// Asphalt's rolling resistance against its sideways grip. Tires roll far
+// more easily than they slide; at 1 a car could not pass walking pace.
+constexpr float RollingResistanceScale = 0.01f;
+
+// One small table indexed by id, so every wheel takes the same path
+// whatever it is driving on; going off track is just a different row
+inline const SurfaceProperties& getSurfaceProperties(SurfaceMaterial material) {
+    static const SurfaceProperties table[(int)SurfaceMaterial::Count] = {
+        { 1.00f, 1.00f, 0, 0 },  // Asphalt
+        { 0.90f, 1.30f, 1, 0 },  // Kerb
+        { 0.60f, 3.00f, 2, 1 },  // Grass
+        { 0.50f, 6.00f, 3, 2 },  // Gravel
+        { 0.10f, 0.30f, 4, 3 }   // Ice
+    };
+    return table[(int)material];
+}
@@ -31,6 +31,9 @@ Renderer::Renderer()
     viewMatrix = Matrix4::identity();
     projectionMatrix = Matrix4::identity();
     cameraPosition = Vector3::zero();
+    worldOrigin = Vector3::zero();
+    
+    trackBuffers = { 0, 0, 0, 0, false, Vector3::zero() };
 }
 
 Renderer::~Renderer() {
@@ -80,6 +83,8 @@ bool Renderer::initialize(int width, int height) {
 }
 
 void Renderer::shutdown() {
+    releaseTrackBuffers(trackBuffers);
+    releaseTrackChunks();
     basicShader.reset();
     carShader.reset();
     trackShader.reset();
@@ -172,6 +177,131 @@ void Renderer::renderTrack(const std::vector<Vector3>& vertices, const std::vect
     drawCalls++;
 }
 
+void Renderer::uploadTrackGeometry(const TrackVertex* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount) {
+    uploadTrackBuffers(trackBuffers, vertices, vertexCount, indices, indexCount);
+    trackBuffers.origin = Vector3::zero();  // The track's own vertices are in track space
+}
+
+void Renderer::updateTrackGeometry(const TrackVertex* vertices, size_t firstVertex, size_t vertexCount) {
+    if (!trackBuffers.isInitialized || vertexCount == 0) return;
+    
+#if !PLATFORM_IOS
+    // Patch the edited range in place; indices are unchanged by edits
+    glBindBuffer(GL_ARRAY_BUFFER, trackBuffers.VBO);
+    glBufferSubData(GL_ARRAY_BUFFER, firstVertex * sizeof(TrackVertex), vertexCount * sizeof(TrackVertex), vertices);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+#endif
+}
+
+void Renderer::renderTrackGeometry() {
+    if (!trackShader || !trackBuffers.isInitialized || trackBuffers.indexCount == 0) return;
+    
+    trackShader->use();
+    setupMatrices(trackShader.get(), Matrix4::translation(trackBuffers.origin - worldOrigin));
+    trackShader->setVec3("color", 0.3f, 0.3f, 0.3f);
+    setupLighting(trackShader.get());
+    
+    drawTrackBuffers(trackBuffers);
+}
+
+void Renderer::uploadTrackChunk(int chunk, const TrackVertex* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount) {
+    auto it = trackChunkBuffers.find(chunk);
+    if (it == trackChunkBuffers.end()) {
+        it = trackChunkBuffers.emplace(chunk, TrackBuffers{ 0, 0, 0, 0, false, Vector3::zero() }).first;
+    }
+    uploadTrackBuffers(it->second, vertices, vertexCount, indices, indexCount);
+    it->second.origin = worldOrigin;  // Streamed chunks arrive in local space
+}
+
+void Renderer::releaseTrackChunk(int chunk) {
+    auto it = trackChunkBuffers.find(chunk);
+    if (it == trackChunkBuffers.end()) return;
+    
+    releaseTrackBuffers(it->second);
+    trackChunkBuffers.erase(it);
+}
+
+void Renderer::releaseTrackChunks() {
+    for (auto& entry : trackChunkBuffers) {
+        releaseTrackBuffers(entry.second);
+    }
+    trackChunkBuffers.clear();
+}
+
+void Renderer::renderTrackChunks() {
+    if (!trackShader || trackChunkBuffers.empty()) return;
+    
+    trackShader->use();
+    trackShader->setVec3("color", 0.3f, 0.3f, 0.3f);
+    setupLighting(trackShader.get());
+    
+    // Chunks uploaded before a rebase are drawn offset by the shifts since
+    for (const auto& entry : trackChunkBuffers) {
+        setupMatrices(trackShader.get(), Matrix4::translation(entry.second.origin - worldOrigin));
+        drawTrackBuffers(entry.second);
+    }
+}
+
+void Renderer::uploadTrackBuffers(TrackBuffers& buffers, const TrackVertex* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount) {
+#if PLATFORM_IOS
+    // Metal buffer upload would go here
+    buffers.isInitialized = true;
+#else
+    if (!buffers.isInitialized) {
+        glGenVertexArrays(1, &buffers.VAO);
+        glGenBuffers(1, &buffers.VBO);
+        glGenBuffers(1, &buffers.EBO);
+        buffers.isInitialized = true;
+    }
+    
+    glBindVertexArray(buffers.VAO);
+    
+    // TrackVertex is already interleaved for the GPU; upload it as-is
+    glBindBuffer(GL_ARRAY_BUFFER, buffers.VBO);
+    glBufferData(GL_ARRAY_BUFFER, vertexCount * sizeof(TrackVertex), vertices, GL_STATIC_DRAW);
+    
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers.EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount * sizeof(unsigned int), indices, GL_STATIC_DRAW);
+    
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(TrackVertex), (void*)offsetof(TrackVertex, position));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(TrackVertex), (void*)offsetof(TrackVertex, normal));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, sizeof(TrackVertex), (void*)offsetof(TrackVertex, uv));
+    glEnableVertexAttribArray(3);
+    
+    // No per-vertex color; the shader's color uniform tints the road
+    glDisableVertexAttribArray(2);
+    glVertexAttrib3f(2, 1.0f, 1.0f, 1.0f);
+    
+    glBindVertexArray(0);
+#endif
+    buffers.indexCount = indexCount;
+}
+
+void Renderer::drawTrackBuffers(const TrackBuffers& buffers) {
+    if (!buffers.isInitialized || buffers.indexCount == 0) return;
+    
+#if !PLATFORM_IOS
+    glBindVertexArray(buffers.VAO);
+    glDrawElements(GL_TRIANGLES, (GLsizei)buffers.indexCount, GL_UNSIGNED_INT, 0);
+    glBindVertexArray(0);
+#endif
+    drawCalls++;
+    trianglesRendered += buffers.indexCount / 3;
+}
+
+void Renderer::releaseTrackBuffers(TrackBuffers& buffers) {
+    if (!buffers.isInitialized) return;
+    
+#if !PLATFORM_IOS
+    glDeleteVertexArrays(1, &buffers.VAO);
+    glDeleteBuffers(1, &buffers.VBO);
+    glDeleteBuffers(1, &buffers.EBO);
+#endif
+    buffers = { 0, 0, 0, 0, false, Vector3::zero() };
+}
+
 void Renderer::renderSkybox() {
     if (!skyboxShader) return;
     
@@ -605,6 +735,8 @@ void Renderer::setupMatrices(Shader* shader, const Matrix4& modelMatrix) {
     if (!shader) return;
     
     shader->setMat4("model", modelMatrix.m);
+    // Once per object here instead of a 4x4 inverse per vertex in the shader
+    shader->setMat4("normalMatrix", modelMatrix.normalMatrix().m);
     shader->setMat4("view", viewMatrix.m);
     shader->setMat4("projection", projectionMatrix.m);
     shader->setVec3("cameraPosition", cameraPosition.x, cameraPosition.y, cameraPosition.z);
@@ -629,12 +761,13 @@ std::string Renderer::getVertexShaderSource() {
         out vec3 TexCoord;
         
         uniform mat4 model;
+        uniform mat4 normalMatrix;
         uniform mat4 view;
         uniform mat4 projection;
         
         void main() {
             FragPos = vec3(model * vec4(aPos, 1.0));
-            Normal = mat3(transpose(inverse(model))) * aNormal;
+            Normal = mat3(normalMatrix) * aNormal;
             Color = aColor;
             TexCoord = aTexCoord;
             
@@ -2,8 +2,10 @@
 #include "../Math/Vector3.h"
 #include "../Math/Matrix4.h"
 #include "../Utils/Shader.h"
+#include "../World/TrackFormat.h"
 #include <vector>
 #include <memory>
+#include <unordered_map>
 
 class Renderer {
 public:
@@ -66,6 +68,23 @@ private:
     int drawCalls;
     int trianglesRendered;
     float frameTime;
+    
+    // Track geometry stays resident; re-uploaded only when the track changes.
+    // 'origin' is the track-space point the vertices are relative to: zero
+    // for the whole track, the world origin at upload time for chunks.
+    struct TrackBuffers {
+        unsigned int VAO, VBO, EBO;
+        size_t indexCount;
+        bool isInitialized;
+        Vector3 origin;
+    };
+    TrackBuffers trackBuffers;
+    
+    // Streamed tracks keep one set of buffers per resident chunk
+    std::unordered_map<int, TrackBuffers> trackChunkBuffers;
+    
+    // Track-space position of the local origin everything else is drawn in
+    Vector3 worldOrigin;
 
 public:
     Renderer();
@@ -85,12 +104,22 @@ public:
     void setViewMatrix(const Matrix4& view);
     void setProjectionMatrix(const Matrix4& projection);
     void setCameraPosition(const Vector3& position);
+    // Floating origin (see WorldOrigin). Track buffers are drawn offset
+    // from where they were uploaded instead of being re-uploaded.
+    void setWorldOrigin(const Vector3& trackSpaceOrigin) { worldOrigin = trackSpaceOrigin; }
     void updateMatrices();
     
     // Rendering
     void renderMesh(const Mesh& mesh, const Matrix4& modelMatrix, const Vector3& color = Vector3(1.0f, 1.0f, 1.0f));
     void renderCar(const Matrix4& modelMatrix, const Vector3& color = Vector3(1.0f, 0.0f, 0.0f));
     void renderTrack(const std::vector<Vector3>& vertices, const std::vector<unsigned int>& indices);
+    void uploadTrackGeometry(const TrackVertex* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount);
+    void updateTrackGeometry(const TrackVertex* vertices, size_t firstVertex, size_t vertexCount);
+    void renderTrackGeometry();
+    void uploadTrackChunk(int chunk, const TrackVertex* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount);
+    void releaseTrackChunk(int chunk);
+    void releaseTrackChunks();
+    void renderTrackChunks();
     void renderSkybox();
     void renderUI();
     
@@ -152,6 +181,9 @@ private:
     void setupMesh(Mesh& mesh);
     void cleanupMesh(Mesh& mesh);
     void renderMeshInternal(const Mesh& mesh);
+    void uploadTrackBuffers(TrackBuffers& buffers, const TrackVertex* vertices, size_t vertexCount, const unsigned int* indices, size_t indexCount);
+    void drawTrackBuffers(const TrackBuffers& buffers);
+    void releaseTrackBuffers(TrackBuffers& buffers);
     void setupLighting(Shader* shader);
     void setupMatrices(Shader* shader, const Matrix4& modelMatrix);
     std::string getVertexShaderSource();
@@ -0,0 +1,29 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// Read-only pointer + count over contiguous elements.
+// Lets the same query code run over owned vectors or over data that lives
+// elsewhere (e.g. a memory-mapped file) without copying.
+template <typename T>
+class ArrayView {
+private:
+    const T* items;
+    size_t count;
+
+public:
+    ArrayView() : items(nullptr), count(0) {}
+    ArrayView(const T* data, size_t size) : items(data), count(size) {}
+    ArrayView(const std::vector<T>& vector) : items(vector.data()), count(vector.size()) {}
+
+    const T& operator[](size_t index) const { return items[index]; }
+    const T& front() const { return items[0]; }
+    const T& back() const { return items[count - 1]; }
+
+    const T* data() const { return items; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    const T* begin() const { return items; }
+    const T* end() const { return items + count; }
+};
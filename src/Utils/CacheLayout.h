@@ -0,0 +1,85 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Cache-line layout of the structs the simulation walks every tick.
+// Car and Player keep the fields their update touches together in blocks
+// that start on a cache line, away from tuning and presentation state the
+// step never reads, so each object costs as few lines per tick as it can.
+// A Report records where every field landed; tools/LayoutReport prints
+// them and counts the lines the hot fields cover.
+namespace CacheLayout {
+    // 64 bytes on the x86-64 and ARM cores we ship on. Not
+    // std::hardware_destructive_interference_size: some of our toolchains
+    // lack it, and GCC gives 256 on AArch64.
+    constexpr size_t LineSize = 64;
+
+    struct Field {
+        std::string name;
+        size_t offset;
+        size_t size;
+        bool hot;  // Touched by every update
+    };
+
+    class Report {
+    private:
+        std::string typeName;
+        size_t size;
+        size_t alignment;
+        std::vector<Field> fields;
+
+    public:
+        Report(const std::string& typeName, size_t size, size_t alignment)
+            : typeName(typeName), size(size), alignment(alignment) {}
+
+        // 'field' must be a member of 'owner'. Measured on a live object
+        // rather than with offsetof, which is only defined for
+        // standard-layout types.
+        template<typename Owner, typename T>
+        void add(const std::string& name, const Owner& owner, const T& field, bool hot) {
+            size_t offset = reinterpret_cast<const char*>(&field) - reinterpret_cast<const char*>(&owner);
+            fields.push_back({ name, offset, sizeof(T), hot });
+        }
+
+        const std::string& getTypeName() const { return typeName; }
+        size_t getSize() const { return size; }
+        size_t getAlignment() const { return alignment; }
+        const std::vector<Field>& getFields() const { return fields; }
+
+        // Bytes not covered by any field (alignment gaps, tail padding)
+        size_t getPaddingBytes() const {
+            size_t used = 0;
+            for (const Field& field : fields) used += field.size;
+            return used < size ? size - used : 0;
+        }
+
+        size_t getHotBytes() const {
+            size_t bytes = 0;
+            for (const Field& field : fields) {
+                if (field.hot) bytes += field.size;
+            }
+            return bytes;
+        }
+
+        // Distinct lines holding hot fields, for an object that starts on
+        // a line. An object aligned below LineSize may straddle one more.
+        size_t getHotLines() const {
+            std::vector<bool> touched((size + LineSize - 1) / LineSize, false);
+            for (const Field& field : fields) {
+                if (!field.hot || field.size == 0) continue;
+                for (size_t line = field.offset / LineSize; line <= (field.offset + field.size - 1) / LineSize; line++) {
+                    touched[line] = true;
+                }
+            }
+            size_t count = 0;
+            for (bool line : touched) count += line ? 1 : 0;
+            return count;
+        }
+
+        // The fewest lines the hot fields could fit in
+        size_t getMinimumHotLines() const {
+            return (getHotBytes() + LineSize - 1) / LineSize;
+        }
+    };
+}
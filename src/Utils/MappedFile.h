@@ -0,0 +1,31 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+// Read-only memory-mapped file. The mapping stays valid until close() or
+// destruction; pages are faulted in by the OS on first touch.
+class MappedFile {
+private:
+    const unsigned char* mappedData;
+    size_t mappedSize;
+#if defined(_WIN32)
+    void* fileHandle;
+    void* mappingHandle;
+#else
+    int fileDescriptor;
+#endif
+
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return mappedData != nullptr; }
+    const unsigned char* data() const { return mappedData; }
+    size_t size() const { return mappedSize; }
+};
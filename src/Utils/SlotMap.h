@@ -0,0 +1,157 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Slot map with generational handles.
+// Values are stored densely (swap-remove on erase) so iteration is a plain
+// array walk, while handles stay stable across removals. A handle packs a
+// slot index and the slot's generation; removing a value bumps the
+// generation, so stale handles resolve to nullptr instead of a reused slot.
+// Handles fit in a positive int, which lets them double as entity IDs.
+//
+// Freed slots are reused oldest first, so churn spreads over every free
+// slot rather than cycling one slot's generations. A slot whose generation
+// runs out is retired instead of wrapping, so no handle ever matches a
+// later occupant; that costs one slot per 2047 reuses of it.
+template <typename T>
+class SlotMap {
+public:
+    using Handle = uint32_t;
+    static constexpr Handle InvalidHandle = 0;
+
+private:
+    static constexpr uint32_t IndexBits = 20;
+    static constexpr uint32_t IndexMask = (1u << IndexBits) - 1;
+    static constexpr uint32_t MaxGeneration = (1u << 11) - 1;  // Keeps handles below 2^31
+    static constexpr uint32_t NullSlot = 0xFFFFFFFFu;
+
+    struct Slot {
+        uint32_t denseIndex;  // Next free slot while unoccupied
+        uint32_t generation;
+        bool occupied;
+    };
+
+    std::vector<Slot> slots;
+    std::vector<T> values;
+    std::vector<uint32_t> denseToSlot;
+
+    // FIFO free list: reuse from the head, free onto the tail
+    uint32_t freeHead = NullSlot;
+    uint32_t freeTail = NullSlot;
+
+public:
+    // Handle the next insert() will return
+    Handle nextHandle() const {
+        if (freeHead != NullSlot) {
+            return makeHandle(freeHead, slots[freeHead].generation);
+        }
+        return makeHandle(static_cast<uint32_t>(slots.size()), 1);
+    }
+
+    Handle insert(T value) {
+        uint32_t slotIndex;
+        if (freeHead != NullSlot) {
+            slotIndex = freeHead;
+            freeHead = slots[slotIndex].denseIndex;
+            if (freeHead == NullSlot) {
+                freeTail = NullSlot;
+            }
+        } else {
+            if (slots.size() > IndexMask) return InvalidHandle;
+            slotIndex = static_cast<uint32_t>(slots.size());
+            slots.push_back({ NullSlot, 1, false });
+        }
+
+        Slot& slot = slots[slotIndex];
+        slot.denseIndex = static_cast<uint32_t>(values.size());
+        slot.occupied = true;
+        values.push_back(std::move(value));
+        denseToSlot.push_back(slotIndex);
+
+        return makeHandle(slotIndex, slot.generation);
+    }
+
+    bool remove(Handle handle) {
+        if (!contains(handle)) return false;
+
+        uint32_t slotIndex = handle & IndexMask;
+        Slot& slot = slots[slotIndex];
+        uint32_t denseIndex = slot.denseIndex;
+        uint32_t lastIndex = static_cast<uint32_t>(values.size() - 1);
+
+        // Move the last value into the hole and repoint its slot
+        if (denseIndex != lastIndex) {
+            values[denseIndex] = std::move(values[lastIndex]);
+            denseToSlot[denseIndex] = denseToSlot[lastIndex];
+            slots[denseToSlot[denseIndex]].denseIndex = denseIndex;
+        }
+        values.pop_back();
+        denseToSlot.pop_back();
+
+        slot.occupied = false;
+        slot.denseIndex = NullSlot;
+        if (slot.generation >= MaxGeneration) {
+            return true;  // Retired: never handed out again
+        }
+        slot.generation++;
+
+        if (freeTail == NullSlot) {
+            freeHead = slotIndex;
+        } else {
+            slots[freeTail].denseIndex = slotIndex;
+        }
+        freeTail = slotIndex;
+        return true;
+    }
+
+    void clear() {
+        while (!denseToSlot.empty()) {
+            uint32_t slotIndex = denseToSlot.back();
+            remove(makeHandle(slotIndex, slots[slotIndex].generation));
+        }
+    }
+
+    bool contains(Handle handle) const {
+        uint32_t slotIndex = handle & IndexMask;
+        if (slotIndex >= slots.size()) return false;
+
+        const Slot& slot = slots[slotIndex];
+        return slot.occupied && slot.generation == (handle >> IndexBits);
+    }
+
+    T* get(Handle handle) {
+        return contains(handle) ? &values[slots[handle & IndexMask].denseIndex] : nullptr;
+    }
+
+    const T* get(Handle handle) const {
+        return contains(handle) ? &values[slots[handle & IndexMask].denseIndex] : nullptr;
+    }
+
+    // Dense index of a live handle, or -1
+    int indexOf(Handle handle) const {
+        return contains(handle) ? static_cast<int>(slots[handle & IndexMask].denseIndex) : -1;
+    }
+
+    // Dense access
+    Handle handleAt(size_t denseIndex) const {
+        uint32_t slotIndex = denseToSlot[denseIndex];
+        return makeHandle(slotIndex, slots[slotIndex].generation);
+    }
+    T& operator[](size_t denseIndex) { return values[denseIndex]; }
+    const T& operator[](size_t denseIndex) const { return values[denseIndex]; }
+
+    size_t size() const { return values.size(); }
+    bool empty() const { return values.empty(); }
+
+    typename std::vector<T>::iterator begin() { return values.begin(); }
+    typename std::vector<T>::iterator end() { return values.end(); }
+    typename std::vector<T>::const_iterator begin() const { return values.begin(); }
+    typename std::vector<T>::const_iterator end() const { return values.end(); }
+
+private:
+    static Handle makeHandle(uint32_t slotIndex, uint32_t generation) {
+        return (generation << IndexBits) | slotIndex;
+    }
+};
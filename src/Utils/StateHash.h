@@ -0,0 +1,52 @@
+#pragma once
+#include "../Math/Vector3.h"
+#include "../Math/Quaternion.h"
+#include <cstdint>
+#include <cstring>
+
+// FNV-1a hash over the exact bit patterns of simulation state.
+// Two runs that hash the same state to the same value every tick are
+// bit-identical, so comparing per-tick hashes finds the first tick where
+// two builds or platforms diverge. Floats are hashed by their bits, so
+// 0.0 and -0.0 (and different NaNs) count as different states.
+class StateHash {
+private:
+    uint64_t value;
+
+public:
+    StateHash() : value(14695981039346656037ull) {}
+
+    void addBytes(const void* data, size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; i++) {
+            value ^= bytes[i];
+            value *= 1099511628211ull;
+        }
+    }
+
+    void add(float v) {
+        uint32_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        addBytes(&bits, sizeof(bits));
+    }
+
+    void add(bool v) {
+        unsigned char byte = v ? 1 : 0;
+        addBytes(&byte, 1);
+    }
+
+    void add(const Vector3& v) {
+        add(v.x);
+        add(v.y);
+        add(v.z);
+    }
+
+    void add(const Quaternion& q) {
+        add(q.x);
+        add(q.y);
+        add(q.z);
+        add(q.w);
+    }
+
+    uint64_t get() const { return value; }
+};
@@ -0,0 +1,188 @@
+#include "TimerWheel.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace {
+    constexpr uint16_t MaxGeneration = (1u << 12) - 1;  // Bits left in a TimerId
+}
+
+TimerWheel::TimerWheel(float tick)
+    : freeHead(NullNode)
+    , freeTail(NullNode)
+    , tickDuration(std::max(0.001f, tick))
+    , accumulator(0.0f)
+    , currentTick(0)
+    , pendingCount(0) {
+    std::fill(std::begin(slots), std::end(slots), NullNode);
+}
+
+TimerWheel::TimerId TimerWheel::schedule(float delay, uint8_t kind, int target) {
+    uint32_t index;
+    if (freeHead != NullNode) {
+        index = freeHead;
+        freeHead = nodes[index].next;
+        if (freeHead == NullNode) {
+            freeTail = NullNode;
+        }
+    } else {
+        if (nodes.size() > IndexMask) return InvalidTimer;
+        index = static_cast<uint32_t>(nodes.size());
+        nodes.push_back(Node());
+        nodes.back().generation = 1;
+    }
+
+    // Round up so a timer never fires early; always at least one tick out
+    uint64_t ticks = static_cast<uint64_t>(std::ceil(std::max(0.0f, delay + accumulator) / tickDuration));
+
+    // Keep the expiry inside the top level's horizon
+    const uint64_t maxTicks = (1ull << (SlotBits * Levels)) - (1ull << (SlotBits * (Levels - 1)));
+    ticks = std::clamp<uint64_t>(ticks, 1, maxTicks);
+
+    Node& node = nodes[index];
+    node.expiresTick = currentTick + ticks;
+    node.kind = kind;
+    node.target = target;
+    node.pending = true;
+    insert(index);
+    pendingCount++;
+
+    return (static_cast<TimerId>(node.generation) << IndexBits) | index;
+}
+
+bool TimerWheel::cancel(TimerId id) {
+    if (!resolve(id)) return false;
+
+    uint32_t index = id & IndexMask;
+    unlink(index);
+    release(index);
+    return true;
+}
+
+void TimerWheel::clear() {
+    for (uint32_t i = 0; i < nodes.size(); i++) {
+        if (nodes[i].pending) {
+            release(i);
+        }
+    }
+    std::fill(std::begin(slots), std::end(slots), NullNode);
+}
+
+void TimerWheel::advance(float deltaTime, std::vector<FiredTimer>& fired) {
+    accumulator += deltaTime;
+    while (accumulator >= tickDuration) {
+        accumulator -= tickDuration;
+        tick(fired);
+    }
+}
+
+bool TimerWheel::isPending(TimerId id) const {
+    return resolve(id) != nullptr;
+}
+
+float TimerWheel::getRemaining(TimerId id) const {
+    const Node* node = resolve(id);
+    if (!node) return 0.0f;
+    return std::max(0.0f, (node->expiresTick - currentTick) * tickDuration - accumulator);
+}
+
+void TimerWheel::tick(std::vector<FiredTimer>& fired) {
+    currentTick++;
+
+    // Pull coarser slots down whenever a finer level wraps
+    for (int level = 1; level < Levels; level++) {
+        if ((currentTick & ((1ull << (SlotBits * level)) - 1)) != 0) break;
+        cascade(level);
+    }
+
+    // Everything left in this level-0 slot expires now
+    uint32_t& head = slots[currentTick & (SlotCount - 1)];
+    uint32_t index = head;
+    head = NullNode;
+
+    while (index != NullNode) {
+        Node& node = nodes[index];
+        uint32_t next = node.next;
+
+        fired.push_back({ (static_cast<TimerId>(node.generation) << IndexBits) | index, node.kind, node.target });
+        release(index);
+
+        index = next;
+    }
+}
+
+void TimerWheel::cascade(int level) {
+    int slot = static_cast<int>((currentTick >> (SlotBits * level)) & (SlotCount - 1));
+    uint32_t& head = slots[level * SlotCount + slot];
+    uint32_t index = head;
+    head = NullNode;
+
+    while (index != NullNode) {
+        uint32_t next = nodes[index].next;
+        insert(index);
+        index = next;
+    }
+}
+
+void TimerWheel::insert(uint32_t index) {
+    Node& node = nodes[index];
+
+    // Lowest level whose block still contains both now and the expiry
+    uint64_t diff = node.expiresTick ^ currentTick;
+    int level = 0;
+    while (level < Levels - 1 && (diff >> (SlotBits * (level + 1))) != 0) {
+        level++;
+    }
+
+    int slot = static_cast<int>((node.expiresTick >> (SlotBits * level)) & (SlotCount - 1));
+    node.slot = static_cast<uint16_t>(level * SlotCount + slot);
+
+    uint32_t& head = slots[node.slot];
+    node.prev = NullNode;
+    node.next = head;
+    if (head != NullNode) {
+        nodes[head].prev = index;
+    }
+    head = index;
+}
+
+void TimerWheel::unlink(uint32_t index) {
+    Node& node = nodes[index];
+
+    if (node.prev != NullNode) {
+        nodes[node.prev].next = node.next;
+    } else {
+        slots[node.slot] = node.next;
+    }
+
+    if (node.next != NullNode) {
+        nodes[node.next].prev = node.prev;
+    }
+}
+
+void TimerWheel::release(uint32_t index) {
+    Node& node = nodes[index];
+    node.pending = false;
+    pendingCount--;
+    if (node.generation >= MaxGeneration) {
+        return;  // Retired: never handed out again
+    }
+    node.generation++;
+
+    node.next = NullNode;
+    if (freeTail == NullNode) {
+        freeHead = index;
+    } else {
+        nodes[freeTail].next = index;
+    }
+    freeTail = index;
+}
+
+const TimerWheel::Node* TimerWheel::resolve(TimerId id) const {
+    uint32_t index = id & IndexMask;
+    if (id == InvalidTimer || index >= nodes.size()) return nullptr;
+
+    const Node& node = nodes[index];
+    if (!node.pending || node.generation != (id >> IndexBits)) return nullptr;
+    return &node;
+}
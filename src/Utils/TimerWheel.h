@@ -0,0 +1,82 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// Hierarchical timer wheel.
+// Scheduling and cancelling are O(1); advancing only touches the slot for the
+// current tick (plus an occasional cascade from a coarser level), so idle
+// timers cost nothing per tick. Timers carry a small (kind, target) payload
+// instead of a callback; the owner dispatches fired timers with a switch.
+//
+// Released nodes are reused oldest first, so a busy owner doesn't cycle one
+// node's generations, and a node whose generation runs out is retired
+// rather than wrapping: a stale TimerId never matches a later timer.
+class TimerWheel {
+public:
+    using TimerId = uint32_t;
+    static constexpr TimerId InvalidTimer = 0;
+
+    struct FiredTimer {
+        TimerId id;
+        uint8_t kind;
+        int target;
+    };
+
+private:
+    static constexpr int SlotBits = 6;
+    static constexpr int SlotCount = 1 << SlotBits;
+    static constexpr int Levels = 4;
+    static constexpr uint32_t IndexBits = 20;
+    static constexpr uint32_t IndexMask = (1u << IndexBits) - 1;
+    static constexpr uint32_t NullNode = 0xFFFFFFFFu;
+
+    struct Node {
+        uint64_t expiresTick;
+        uint32_t next;
+        uint32_t prev;
+        uint16_t slot;        // level * SlotCount + slot, for O(1) unlink
+        uint16_t generation;
+        uint8_t kind;
+        bool pending;
+        int target;
+    };
+
+    std::vector<Node> nodes;
+
+    // FIFO free list through Node::next: reuse from the head, release onto
+    // the tail
+    uint32_t freeHead;
+    uint32_t freeTail;
+    uint32_t slots[Levels * SlotCount];
+
+    float tickDuration;
+    float accumulator;
+    uint64_t currentTick;
+    int pendingCount;
+
+public:
+    explicit TimerWheel(float tickDuration = 1.0f / 60.0f);
+
+    // Scheduling
+    TimerId schedule(float delay, uint8_t kind, int target);
+    bool cancel(TimerId id);
+    void clear();
+
+    // Advance time, appending every timer that expires to 'fired'
+    void advance(float deltaTime, std::vector<FiredTimer>& fired);
+
+    // Queries
+    bool isPending(TimerId id) const;
+    float getRemaining(TimerId id) const;
+    int getPendingCount() const { return pendingCount; }
+    float getTickDuration() const { return tickDuration; }
+    float getTime() const { return currentTick * tickDuration + accumulator; }
+
+private:
+    void tick(std::vector<FiredTimer>& fired);
+    void cascade(int level);
+    void insert(uint32_t index);
+    void unlink(uint32_t index);
+    void release(uint32_t index);
+    const Node* resolve(TimerId id) const;
+};
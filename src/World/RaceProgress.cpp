@@ -0,0 +1,156 @@
+#include "RaceProgress.h"
+#include <cmath>
+#include <algorithm>
+
+RaceProgress::RaceProgress(int totalLaps)
+    : totalLaps(totalLaps) {
+    reset();
+}
+
+void RaceProgress::reset() {
+    lap = 0;
+    nextCheckpoint = 1;  // Cars start on the start/finish line
+    segment = -1;
+    started = false;
+    finished = false;
+    previousPosition = Vector3::zero();
+    distanceAlongTrack = 0.0f;
+    raceDistance = 0.0f;
+    raceTime = 0.0f;
+    lapStartTime = 0.0f;
+    lastLapTime = 0.0f;
+    bestLapTime = 0.0f;
+    finishTime = 0.0f;
+}
+
+void RaceProgress::update(const Track& track, const Vector3& position, float deltaTime) {
+    if (finished) return;
+    
+    if (!started) {
+        started = true;
+        previousPosition = position;
+    }
+    
+    raceTime += deltaTime;
+    
+    ArrayView<Track::Checkpoint> checkpoints = track.getCheckpoints();
+    int count = (int)checkpoints.size();
+    if (count > 0) {
+        nextCheckpoint %= count;
+        Vector3 origin = track.getOrigin();
+        
+        // One tick of motion can clear several gates
+        float fraction;
+        for (int gates = 0; gates < count; gates++) {
+            if (!crossesCheckpoint(checkpoints[nextCheckpoint], origin, previousPosition, position, fraction)) break;
+            
+            if (checkpoints[nextCheckpoint].isStartFinish) {
+                completeLap(raceTime - deltaTime * (1.0f - fraction));
+                if (finished) break;
+            }
+            nextCheckpoint = (nextCheckpoint + 1) % count;
+        }
+    }
+    
+    Track::TrackProjection projection = track.getTrackProjection(position, segment);
+    if (projection.segment >= 0) {
+        segment = projection.segment;
+        distanceAlongTrack = projection.distanceAlongTrack;
+        
+        // Past the gate we still need means the projection wrapped around the
+        // start line (e.g. lined up just behind it); count it as last lap
+        float length = track.getTrackLength();
+        float gateDistance = length;
+        float slack = 0.0f;
+        if (count > 0 && nextCheckpoint != 0) {
+            gateDistance = checkpoints[nextCheckpoint].distanceAlongTrack;
+            slack = checkpoints[nextCheckpoint].width;
+        }
+        
+        float along = distanceAlongTrack;
+        if (along > gateDistance + slack) {
+            along -= length;
+        }
+        
+        raceDistance = lap * length + along;
+    }
+    
+    previousPosition = position;
+}
+
+bool RaceProgress::isAheadOf(const RaceProgress& other) const {
+    if (finished != other.finished) return finished;
+    if (finished) return finishTime < other.finishTime;
+    return raceDistance > other.raceDistance;
+}
+
+void RaceProgress::completeLap(float crossingTime) {
+    lastLapTime = crossingTime - lapStartTime;
+    if (bestLapTime <= 0.0f || lastLapTime < bestLapTime) {
+        bestLapTime = lastLapTime;
+    }
+    lapStartTime = crossingTime;
+    lap++;
+    
+    if (lap >= totalLaps) {
+        finished = true;
+        finishTime = crossingTime;
+    }
+}
+
+bool RaceProgress::crossesCheckpoint(const Track::Checkpoint& checkpoint, const Vector3& origin,
+                                     const Vector3& from, const Vector3& to, float& fraction) {
+    Vector3 gate = checkpoint.position - origin;
+    
+    // Forward crossings only: behind the plane before, on or past it after
+    float before = (from - gate).dot(checkpoint.direction);
+    float after = (to - gate).dot(checkpoint.direction);
+    if (before >= 0.0f || after < 0.0f) return false;
+    
+    fraction = before / (before - after);
+    Vector3 offset = Vector3::lerpUnclamped(from, to, fraction) - gate;
+    
+    // Must pass between the gate posts and under the banner
+    Vector3 side = Vector3::up().cross(checkpoint.direction).normalized();
+    if (std::fabs(offset.dot(side)) > checkpoint.width * 0.5f) return false;
+    if (std::fabs(offset.y) > checkpoint.height) return false;
+    
+    return true;
+}
+
+void RaceStandings::update(const std::vector<RaceProgress>& progress) {
+    int count = (int)progress.size();
+    
+    if ((int)order.size() != count) {
+        order.resize(count);
+        for (int i = 0; i < count; i++) {
+            order[i] = i;
+        }
+    }
+    
+    // Insertion sort from last tick's order; only overtakes move anything
+    for (int i = 1; i < count; i++) {
+        int car = order[i];
+        int j = i - 1;
+        while (j >= 0 && progress[car].isAheadOf(progress[order[j]])) {
+            order[j + 1] = order[j];
+            j--;
+        }
+        order[j + 1] = car;
+    }
+    
+    positions.resize(count);
+    for (int i = 0; i < count; i++) {
+        positions[order[i]] = i + 1;
+    }
+}
+
+void RaceStandings::clear() {
+    order.clear();
+    positions.clear();
+}
+
+int RaceStandings::getPosition(int car) const {
+    if (car < 0 || car >= (int)positions.size()) return 0;
+    return positions[car];
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include "../Math/Vector3.h"
+#include "Track.h"
+#include <vector>
+
+// Lap and checkpoint progress for a single car.
+// Checkpoints are gates: the car's motion since the last update is swept
+// against the next gate's plane, so a fast car can't skip one between
+// ticks. Race distance is continuous, taken from the car's projection onto
+// the nearest track segment (warm-started from the previous update).
+class RaceProgress {
+private:
+    int totalLaps;
+    int lap;
+    int nextCheckpoint;
+    int segment;
+    bool started;
+    bool finished;
+    
+    Vector3 previousPosition;
+    float distanceAlongTrack;
+    float raceDistance;
+    
+    // Timing
+    float raceTime;
+    float lapStartTime;
+    float lastLapTime;
+    float bestLapTime;
+    float finishTime;
+
+public:
+    explicit RaceProgress(int totalLaps = 3);
+    
+    void reset();
+    void update(const Track& track, const Vector3& position, float deltaTime);
+    void shiftOrigin(const Vector3& shift) { previousPosition -= shift; }
+    
+    // Progress
+    int getLap() const { return lap; }
+    int getNextCheckpoint() const { return nextCheckpoint; }
+    int getSegment() const { return segment; }
+    bool hasFinished() const { return finished; }
+    float getDistanceAlongTrack() const { return distanceAlongTrack; }
+    float getRaceDistance() const { return raceDistance; }
+    
+    // Timing
+    float getRaceTime() const { return raceTime; }
+    float getCurrentLapTime() const { return raceTime - lapStartTime; }
+    float getLastLapTime() const { return lastLapTime; }
+    float getBestLapTime() const { return bestLapTime; }
+    float getFinishTime() const { return finishTime; }
+    
+    // Ordering: finishers by finish time, then everyone else by distance
+    bool isAheadOf(const RaceProgress& other) const;
+
+private:
+    void completeLap(float crossingTime);
+    // 'origin' is the track's, as checkpoints are stored in track space
+    static bool crossesCheckpoint(const Track::Checkpoint& checkpoint, const Vector3& origin,
+                                  const Vector3& from, const Vector3& to, float& fraction);
+};
+
+// Running order of a set of cars, indexed the same as their RaceProgress.
+// The order barely changes between ticks, so an insertion sort seeded with
+// last tick's order is effectively linear.
+class RaceStandings {
+private:
+    std::vector<int> order;
+    std::vector<int> positions;
+
+public:
+    void update(const std::vector<RaceProgress>& progress);
+    void clear();
+    
+    const std::vector<int>& getOrder() const { return order; }
+    int getPosition(int car) const;  // 1 for the leader, 0 if unknown
+    int getLeader() const { return order.empty() ? -1 : order.front(); }
+};
@@ -0,0 +1,224 @@
+#include "RacingLine.h"
+#include <algorithm>
+#include <cmath>
+
+RacingLine::Parameters::Parameters()
+    : edgeMargin(1.0f)
+    , solverSpacing(4.0f)
+    , iterations(200)
+    , maxSpeed(50.0f)
+    , lateralAcceleration(12.0f)
+    , maxAcceleration(8.0f)
+    , maxDeceleration(15.0f) {
+}
+
+RacingLine::RacingLine()
+    : trackLength(0.0f)
+    , spacing(0.0f)
+    , sourceTrack(nullptr)
+    , sourceGeometryVersion(0) {
+}
+
+void RacingLine::build(const Track& track) {
+    samples.clear();
+    sourceTrack = &track;
+    sourceGeometryVersion = track.getGeometryVersion();
+
+    ArrayView<Track::TrackPoint> points = track.getTrackPoints();
+    int count = (int)points.size();
+    trackLength = track.getTrackLength();
+    if (count < 3 || trackLength <= 0.0f) return;
+    spacing = trackLength / count;
+
+    // Solve on coarse stations, then resample onto every track point
+    int stations = std::max(8, std::min(count, (int)(trackLength / parameters.solverSpacing)));
+    std::vector<float> stationOffsets;
+    solveOffsets(track, stationOffsets, stations);
+
+    // Positions are local like the track's queries; the points aren't
+    Vector3 origin = track.getOrigin();
+    samples.resize(count);
+    for (int i = 0; i < count; i++) {
+        float position = (float)i * stations / count;
+        int station = std::min((int)position, stations - 1);
+        float fraction = position - station;
+        float offset = stationOffsets[station] + (stationOffsets[(station + 1) % stations] - stationOffsets[station]) * fraction;
+
+        // Widths can change between stations; stay on this point's road
+        const Track::TrackPoint& point = points[i];
+        float limit = std::max(0.0f, point.width * 0.5f - parameters.edgeMargin);
+        offset = std::max(-limit, std::min(limit, offset));
+
+        samples[i].position = (point.position - origin) + point.normal * offset;
+        samples[i].normal = point.normal;
+        samples[i].offset = offset;
+        samples[i].room = limit;
+    }
+
+    computeCurvature();
+    computeSpeedProfile(track);
+}
+
+void RacingLine::shiftOrigin(const Vector3& shift) {
+    for (Sample& sample : samples) {
+        sample.position -= shift;
+    }
+}
+
+void RacingLine::clear() {
+    samples.clear();
+    sourceTrack = nullptr;
+}
+
+bool RacingLine::isBuiltFor(const Track& track) const {
+    return sourceTrack == &track && sourceGeometryVersion == track.getGeometryVersion();
+}
+
+RacingLine::Sample RacingLine::sample(float distance) const {
+    if (samples.empty()) {
+        Sample empty = { Vector3::zero(), Vector3::zero(), 0.0f, 0.0f, 0.0f, 0.0f };
+        return empty;
+    }
+
+    distance = std::fmod(distance, trackLength);
+    if (distance < 0.0f) distance += trackLength;
+
+    int count = (int)samples.size();
+    float position = distance / spacing;
+    int i = std::min((int)position, count - 1);
+    float fraction = position - i;
+
+    const Sample& a = samples[i];
+    const Sample& b = samples[(i + 1) % count];
+
+    Sample result;
+    result.position = Vector3::lerpUnclamped(a.position, b.position, fraction);
+    result.normal = Vector3::lerpUnclamped(a.normal, b.normal, fraction);
+    result.offset = a.offset + (b.offset - a.offset) * fraction;
+    result.room = a.room + (b.room - a.room) * fraction;
+    result.curvature = a.curvature + (b.curvature - a.curvature) * fraction;
+    result.targetSpeed = a.targetSpeed + (b.targetSpeed - a.targetSpeed) * fraction;
+    return result;
+}
+
+float RacingLine::getIdealLapTime() const {
+    float time = 0.0f;
+    int count = (int)samples.size();
+    for (int i = 0; i < count; i++) {
+        const Sample& a = samples[i];
+        const Sample& b = samples[(i + 1) % count];
+        float speed = (a.targetSpeed + b.targetSpeed) * 0.5f;
+        if (speed > 0.0f) {
+            time += (b.position - a.position).length() / speed;
+        }
+    }
+    return time;
+}
+
+void RacingLine::solveOffsets(const Track& track, std::vector<float>& stationOffsets, int stations) const {
+    // Long-wavelength bends barely move under local smoothing, so solve
+    // coarse to fine: halve the station spacing each level, starting from
+    // the previous level's offsets
+    int levels = 1;
+    while ((stations >> levels) >= 16 && levels < 8) levels++;
+
+    std::vector<float> coarseOffsets;
+    for (int level = levels - 1; level >= 0; level--) {
+        int levelStations = level == 0 ? stations : (stations >> level);
+
+        std::vector<float> levelOffsets(levelStations, 0.0f);
+        if (!coarseOffsets.empty()) {
+            int coarseStations = (int)coarseOffsets.size();
+            for (int j = 0; j < levelStations; j++) {
+                float position = (float)j * coarseStations / levelStations;
+                int station = std::min((int)position, coarseStations - 1);
+                float fraction = position - station;
+                levelOffsets[j] = coarseOffsets[station] + (coarseOffsets[(station + 1) % coarseStations] - coarseOffsets[station]) * fraction;
+            }
+        }
+
+        smoothOffsets(track, levelOffsets);
+        coarseOffsets.swap(levelOffsets);
+    }
+
+    stationOffsets.swap(coarseOffsets);
+}
+
+void RacingLine::smoothOffsets(const Track& track, std::vector<float>& offsets) const {
+    int stations = (int)offsets.size();
+    std::vector<Vector3> centres(stations);
+    std::vector<Vector3> normals(stations);
+    std::vector<float> limits(stations);
+    for (int j = 0; j < stations; j++) {
+        Track::TrackPoint point = track.getTrackPointAtDistance(trackLength * j / stations);
+        centres[j] = point.position;
+        normals[j] = point.normal;
+        limits[j] = std::max(0.0f, point.width * 0.5f - parameters.edgeMargin);
+    }
+
+    // Minimum curvature: minimise the summed squared second difference of
+    // the line, moving each station only along its normal and within the
+    // road. Each Gauss-Seidel step solves the biharmonic stencil
+    //   p[j] = (4 (p[j-1] + p[j+1]) - p[j-2] - p[j+2]) / 6
+    // for the station's offset, then clamps it to the track.
+    auto linePoint = [&](int j) {
+        j = (j + stations) % stations;
+        return centres[j] + normals[j] * offsets[j];
+    };
+
+    for (int iteration = 0; iteration < parameters.iterations; iteration++) {
+        for (int j = 0; j < stations; j++) {
+            Vector3 target = ((linePoint(j - 1) + linePoint(j + 1)) * 4.0f - linePoint(j - 2) - linePoint(j + 2)) / 6.0f;
+            float offset = (target - centres[j]).dot(normals[j]);
+            offsets[j] = std::max(-limits[j], std::min(limits[j], offset));
+        }
+    }
+}
+
+void RacingLine::computeCurvature() {
+    int count = (int)samples.size();
+
+    // Measure over a solver station's span so resampling steps don't show
+    int step = std::max(1, (int)std::round(parameters.solverSpacing / spacing));
+    step = std::min(step, std::max(1, (count - 1) / 2));
+
+    for (int i = 0; i < count; i++) {
+        const Vector3& a = samples[(i - step + count) % count].position;
+        const Vector3& b = samples[i].position;
+        const Vector3& c = samples[(i + step) % count].position;
+
+        // Menger curvature: 4 * area / product of the sides
+        float sides = (b - a).length() * (c - b).length() * (a - c).length();
+        samples[i].curvature = sides > 0.0f ? 2.0f * (b - a).cross(c - a).length() / sides : 0.0f;
+    }
+}
+
+void RacingLine::computeSpeedProfile(const Track& track) {
+    ArrayView<Track::TrackPoint> points = track.getTrackPoints();
+    int count = (int)samples.size();
+
+    // Cornering limit from the grip of the surface under each sample
+    for (int i = 0; i < count; i++) {
+        float grip = getSurfaceProperties(points[i].surface).friction;
+        float lateral = parameters.lateralAcceleration * grip;
+        float speed = samples[i].curvature > 1e-6f ? std::sqrt(lateral / samples[i].curvature) : parameters.maxSpeed;
+        samples[i].targetSpeed = std::min(speed, parameters.maxSpeed);
+    }
+
+    // Brake into corners, then accelerate out of them. Two laps each way
+    // settle the wrap at the start line.
+    for (int k = 0; k < count * 2; k++) {
+        int i = count - 1 - (k % count);
+        const Sample& next = samples[(i + 1) % count];
+        float distance = (next.position - samples[i].position).length();
+        float reachable = std::sqrt(next.targetSpeed * next.targetSpeed + 2.0f * parameters.maxDeceleration * distance);
+        samples[i].targetSpeed = std::min(samples[i].targetSpeed, reachable);
+    }
+    for (int k = 0; k < count * 2; k++) {
+        int i = k % count;
+        Sample& next = samples[(i + 1) % count];
+        float distance = (next.position - samples[i].position).length();
+        float reachable = std::sqrt(samples[i].targetSpeed * samples[i].targetSpeed + 2.0f * parameters.maxAcceleration * distance);
+        next.targetSpeed = std::min(next.targetSpeed, reachable);
+    }
+}
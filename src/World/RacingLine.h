@@ -0,0 +1,76 @@
+#pragma once
+#include "../Math/Vector3.h"
+#include "Track.h"
+#include <cstdint>
+#include <vector>
+
+// Precomputed racing line and target speed profile for a track.
+// Built once when a track loads: the line is solved as a minimum-curvature
+// path across the track width, then a speed profile is laid over it from
+// the grip available at each curvature and the car's acceleration and
+// braking limits. Results are stored per track point (uniform in arc
+// length), so a query is a table read and a lerp.
+class RacingLine {
+public:
+    struct Parameters {
+        float edgeMargin;           // Kept clear of each track edge
+        float solverSpacing;        // Distance between solver stations
+        int iterations;             // Smoothing sweeps per solver level
+        float maxSpeed;
+        float lateralAcceleration;  // On asphalt; scaled by surface grip
+        float maxAcceleration;
+        float maxDeceleration;
+
+        Parameters();
+    };
+
+    struct Sample {
+        Vector3 position;
+        Vector3 normal;     // The track point's, across the road
+        float offset;       // Along the normal, from the centre
+        float room;         // Furthest offset either side the line may use
+        float curvature;
+        float targetSpeed;
+    };
+
+private:
+    Parameters parameters;
+    std::vector<Sample> samples;
+    float trackLength;
+    float spacing;
+
+    // Track the line was solved for, so callers can tell when it's stale
+    const Track* sourceTrack;
+    uint32_t sourceGeometryVersion;
+
+public:
+    RacingLine();
+
+    void setParameters(const Parameters& newParameters) { parameters = newParameters; }
+    const Parameters& getParameters() const { return parameters; }
+
+    void build(const Track& track);
+    void clear();
+    // Sample positions are relative to the track's origin (see
+    // Track::setOrigin); move them with it
+    void shiftOrigin(const Vector3& shift);
+    bool isBuiltFor(const Track& track) const;
+
+    // O(1) lookups by distance along the track (wraps)
+    Sample sample(float distance) const;
+    Vector3 getPosition(float distance) const { return sample(distance).position; }
+    float getTargetSpeed(float distance) const { return sample(distance).targetSpeed; }
+
+    bool empty() const { return samples.empty(); }
+    float getTrackLength() const { return trackLength; }
+    const std::vector<Sample>& getSamples() const { return samples; }
+
+    // Lap time if driven exactly at the target speeds
+    float getIdealLapTime() const;
+
+private:
+    void solveOffsets(const Track& track, std::vector<float>& stationOffsets, int stations) const;
+    void smoothOffsets(const Track& track, std::vector<float>& offsets) const;
+    void computeCurvature();
+    void computeSpeedProfile(const Track& track);
+};
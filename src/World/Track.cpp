@@ -1,136 +1,136 @@
 #include "Track.h"
+#include "../Math/SimMath.h"
 #include <cmath>
 #include <algorithm>
+#include <limits>
+#include <fstream>
+#include <type_traits>
+
+// Track data is read from mapped files in place
+static_assert(std::is_standard_layout<Track::TrackPoint>::value, "TrackPoint must be mappable");
+static_assert(std::is_standard_layout<Track::Checkpoint>::value, "Checkpoint must be mappable");
+static_assert(std::is_trivially_copyable<TrackVertex>::value, "TrackVertex must be mappable");
+static_assert(sizeof(Vector3) == 3 * sizeof(float), "Vector3 must be tightly packed");
+
+namespace {
+    bool isFinitePositive(float value) {
+        return std::isfinite(value) && value > 0.0f;
+    }
+
+    template<typename T>
+    const T* sectionData(const unsigned char* base, const TrackFormat::Header& header, TrackFormat::Section index) {
+        return reinterpret_cast<const T*>(base + header.sections[index].offset);
+    }
+}
 
 Track::Track() 
-    : trackLength(0.0f)
+    : geometryVersion(0)
+    , layoutVersion(0)
+    , dirtyPointFirst(-1)
+    , dirtyPointLast(-1)
+    , sampleDrift(0.0f)
+    , snapshotLayoutVersion(0)
+    , trackLength(0.0f)
     , trackWidth(10.0f)
     , numLaps(3)
-    , currentLap(0)
-    , currentCheckpoint(0)
     , trackResolution(100)
     , trackRadius(50.0f)
     , trackComplexity(0.5f)
     , bankingAmount(0.0f)
     , trackColor(0.3f, 0.3f, 0.3f)
     , trackLineColor(1.0f, 1.0f, 1.0f)
-    , trackLineWidth(0.1f) {
+    , trackLineWidth(0.1f)
+    , origin(0.0f, 0.0f, 0.0f) {
     generateCircularTrack(trackRadius, trackWidth, trackResolution);
 }
 
 Track::Track(float radius, float width, int resolution)
-    : trackLength(0.0f)
+    : geometryVersion(0)
+    , layoutVersion(0)
+    , dirtyPointFirst(-1)
+    , dirtyPointLast(-1)
+    , sampleDrift(0.0f)
+    , snapshotLayoutVersion(0)
+    , trackLength(0.0f)
     , trackWidth(width)
     , numLaps(3)
-    , currentLap(0)
-    , currentCheckpoint(0)
     , trackResolution(resolution)
     , trackRadius(radius)
     , trackComplexity(0.5f)
     , bankingAmount(0.0f)
     , trackColor(0.3f, 0.3f, 0.3f)
     , trackLineColor(1.0f, 1.0f, 1.0f)
-    , trackLineWidth(0.1f) {
+    , trackLineWidth(0.1f)
+    , origin(0.0f, 0.0f, 0.0f) {
     generateCircularTrack(radius, width, resolution);
 }
 
+Track::Track(const std::string& path)
+    : geometryVersion(0)
+    , layoutVersion(0)
+    , dirtyPointFirst(-1)
+    , dirtyPointLast(-1)
+    , sampleDrift(0.0f)
+    , snapshotLayoutVersion(0)
+    , trackLength(0.0f)
+    , trackWidth(10.0f)
+    , numLaps(3)
+    , trackResolution(100)
+    , trackRadius(50.0f)
+    , trackComplexity(0.5f)
+    , bankingAmount(0.0f)
+    , trackColor(0.3f, 0.3f, 0.3f)
+    , trackLineColor(1.0f, 1.0f, 1.0f)
+    , trackLineWidth(0.1f)
+    , origin(0.0f, 0.0f, 0.0f) {
+    if (!loadBinary(path)) {
+        generateCircularTrack(trackRadius, trackWidth, trackResolution);
+    }
+}
+
 void Track::generateCircularTrack(float radius, float width, int resolution) {
-    trackPoints.clear();
-    trackWidth = width;
-    trackResolution = resolution;
+    trackRadius = radius;
     
-    for (int i = 0; i < resolution; i++) {
-        float t = (float)i / (float)resolution;
-        float angle = t * 2.0f * M_PI;
-        
-        TrackPoint point;
-        point.position = Vector3(
-            std::cos(angle) * radius,
-            0.0f,
-            std::sin(angle) * radius
-        );
-        point.tangent = Vector3(
-            -std::sin(angle),
-            0.0f,
-            std::cos(angle)
-        );
-        point.normal = Vector3(
-            std::cos(angle),
-            0.0f,
-            std::sin(angle)
-        );
-        point.binormal = Vector3(0.0f, 1.0f, 0.0f);
-        point.width = width;
-        point.banking = 0.0f;
-        point.curvature = 1.0f / radius;
-        
-        trackPoints.push_back(point);
+    std::vector<Vector3> points;
+    int numControlPoints = 32;
+    for (int i = 0; i < numControlPoints; i++) {
+        float angle = (float)i / (float)numControlPoints * 2.0f * M_PI;
+        points.push_back(Vector3(SimMath::cos(angle) * radius, 0.0f, SimMath::sin(angle) * radius));
     }
     
-    calculateTrackProperties();
-    generateCheckpoints(8);
-    generateTrackGeometry();
+    generateCustomTrack(points, width, resolution);
 }
 
 void Track::generateFigureEightTrack(float radius, float width, int resolution) {
-    trackPoints.clear();
-    trackWidth = width;
-    trackResolution = resolution;
+    trackRadius = radius;
     
-    for (int i = 0; i < resolution; i++) {
-        float t = (float)i / (float)resolution;
-        float angle = t * 4.0f * M_PI; // Two full circles
-        
-        TrackPoint point;
-        float x = std::cos(angle) * radius;
-        float z = std::sin(angle) * radius * std::sin(angle * 0.5f);
-        
-        point.position = Vector3(x, 0.0f, z);
-        
-        // Calculate tangent
-        float nextAngle = (t + 1.0f / resolution) * 4.0f * M_PI;
-        float nextX = std::cos(nextAngle) * radius;
-        float nextZ = std::sin(nextAngle) * radius * std::sin(nextAngle * 0.5f);
-        
-        Vector3 tangent = Vector3(nextX - x, 0.0f, nextZ - z).normalized();
-        point.tangent = tangent;
-        
-        // Calculate normal and binormal
-        point.normal = Vector3(-tangent.z, 0.0f, tangent.x);
-        point.binormal = Vector3(0.0f, 1.0f, 0.0f);
-        point.width = width;
-        point.banking = 0.0f;
-        point.curvature = 0.0f; // Will be calculated later
-        
-        trackPoints.push_back(point);
+    std::vector<Vector3> points;
+    int numControlPoints = 64;
+    for (int i = 0; i < numControlPoints; i++) {
+        float angle = (float)i / (float)numControlPoints * 4.0f * M_PI; // Two full circles
+        float x = SimMath::cos(angle) * radius;
+        float z = SimMath::sin(angle) * radius * SimMath::sin(angle * 0.5f);
+        points.push_back(Vector3(x, 0.0f, z));
     }
     
-    calculateTrackProperties();
-    generateCheckpoints(8);
-    generateTrackGeometry();
+    generateCustomTrack(points, width, resolution);
 }
 
-void Track::generateCustomTrack(const std::vector<Vector3>& controlPoints, float width, int resolution) {
-    trackPoints.clear();
+void Track::generateCustomTrack(const std::vector<Vector3>& points, float width, int resolution) {
     trackWidth = width;
     trackResolution = resolution;
     
-    if (controlPoints.size() < 2) return;
+    if (points.size() < 2) return;
     
-    for (int i = 0; i < resolution; i++) {
-        float t = (float)i / (float)resolution;
-        
-        TrackPoint point;
-        point.position = interpolatePosition(t);
-        point.tangent = interpolateTangent(t);
-        point.normal = interpolateNormal(t);
-        point.binormal = interpolateBinormal(t);
-        point.width = width;
-        point.banking = 0.0f;
-        point.curvature = 0.0f;
-        
-        trackPoints.push_back(point);
-    }
+    // Full rebuild; drop any loaded file
+    storage = Storage();
+    bindStorage();
+    mappedFile.reset();
+    
+    buildSpline(points);
+    buildArcLengthTables();
+    sampleTrackPoints(resolution);
+    buildSegmentGrid();
     
     calculateTrackProperties();
     generateCheckpoints(8);
@@ -138,12 +138,9 @@ void Track::generateCustomTrack(const std::vector<Vector3>& controlPoints, float
 }
 
 void Track::generateRandomTrack(float radius, float width, int resolution, float complexity) {
-    trackPoints.clear();
-    trackWidth = width;
-    trackResolution = resolution;
     trackComplexity = complexity;
     
-    std::vector<Vector3> controlPoints;
+    std::vector<Vector3> points;
     int numControlPoints = 8;
     
     for (int i = 0; i < numControlPoints; i++) {
@@ -152,43 +149,52 @@ void Track::generateRandomTrack(float radius, float width, int resolution, float
         float randomHeight = 2.0f * ((float)rand() / RAND_MAX - 0.5f);
         
         Vector3 point(
-            std::cos(angle) * randomRadius,
+            SimMath::cos(angle) * randomRadius,
             randomHeight,
-            std::sin(angle) * randomRadius
+            SimMath::sin(angle) * randomRadius
         );
-        controlPoints.push_back(point);
+        points.push_back(point);
     }
     
-    generateCustomTrack(controlPoints, width, resolution);
+    generateCustomTrack(points, width, resolution);
 }
 
 Track::TrackPoint Track::getTrackPoint(float t) const {
-    if (trackPoints.empty()) {
+    TrackPoint point = evaluateTrackPoint(t);
+    point.position -= origin;
+    return point;
+}
+
+Track::TrackPoint Track::evaluateTrackPoint(float t) const {
+    if (splineSegments.empty()) {
         TrackPoint empty;
         return empty;
     }
     
-    t = std::fmod(t, 1.0f);
-    if (t < 0.0f) t += 1.0f;
+    Vector3 position, velocity, acceleration;
+    evaluateSpline(t, position, velocity, acceleration);
     
-    float index = t * (trackPoints.size() - 1);
-    int i = (int)index;
-    float fraction = index - i;
+    TrackPoint point;
+    point.position = position;
+    point.tangent = velocity.normalized();
     
-    if (i >= trackPoints.size() - 1) {
-        return trackPoints.back();
+    // Road stays level side to side; the binormal follows the slope
+    point.normal = Vector3::up().cross(point.tangent).normalized();
+    point.binormal = point.tangent.cross(point.normal);
+    point.width = interpolateWidth(t);
+    point.banking = interpolateBanking(t);
+    point.surface = SurfaceMaterial::Asphalt;
+    if (!trackPoints.empty()) {
+        int i, next;
+        float fraction;
+        getSampleSpan(t, i, next, fraction);
+        point.surface = trackPoints[i].surface;
     }
     
-    TrackPoint result;
-    result.position = trackPoints[i].position + (trackPoints[i + 1].position - trackPoints[i].position) * fraction;
-    result.tangent = trackPoints[i].tangent + (trackPoints[i + 1].tangent - trackPoints[i].tangent) * fraction;
-    result.normal = trackPoints[i].normal + (trackPoints[i + 1].normal - trackPoints[i].normal) * fraction;
-    result.binormal = trackPoints[i].binormal + (trackPoints[i + 1].binormal - trackPoints[i].binormal) * fraction;
-    result.width = trackPoints[i].width + (trackPoints[i + 1].width - trackPoints[i].width) * fraction;
-    result.banking = trackPoints[i].banking + (trackPoints[i + 1].banking - trackPoints[i].banking) * fraction;
-    result.curvature = trackPoints[i].curvature + (trackPoints[i + 1].curvature - trackPoints[i].curvature) * fraction;
+    float speed = velocity.length();
+    point.curvature = speed > 0.0f ? velocity.cross(acceleration).length() / (speed * speed * speed) : 0.0f;
     
-    return result;
+    return point;
 }
 
 Track::TrackPoint Track::getTrackPointAtDistance(float distance) const {
@@ -196,6 +202,21 @@ Track::TrackPoint Track::getTrackPointAtDistance(float distance) const {
     return getTrackPoint(t);
 }
 
+Track::TrackPoint Track::getGridSlot(int slot, int columns) const {
+    columns = std::max(1, columns);
+    int row = slot / columns;
+    int column = slot % columns;
+    
+    // Rows are staggered so cars in a row don't start side by side
+    const float rowSpacing = 8.0f;
+    float distance = -rowSpacing * (row + 1) - rowSpacing * column / columns;
+    TrackPoint point = getTrackPointAtDistance(distance);
+    
+    float across = ((column + 0.5f) / columns - 0.5f) * point.width * 0.8f;
+    point.position += point.normal * across;
+    return point;
+}
+
 Vector3 Track::getTrackPosition(float t) const {
     return getTrackPoint(t).position;
 }
@@ -225,128 +246,350 @@ float Track::getTrackCurvature(float t) const {
 }
 
 float Track::getDistanceAlongTrack(const Vector3& position) const {
-    float minDistance = std::numeric_limits<float>::max();
-    float bestT = 0.0f;
+    return getTrackProjection(position).distanceAlongTrack;
+}
+
+float Track::getParameterFromDistance(float distance) const {
+    if (trackLength <= 0.0f || distanceToParameter.size() < 2) return 0.0f;
     
-    for (int i = 0; i < trackPoints.size(); i++) {
-        float t = (float)i / (float)(trackPoints.size() - 1);
-        Vector3 trackPos = getTrackPosition(t);
-        float distance = (position - trackPos).length();
-        
-        if (distance < minDistance) {
-            minDistance = distance;
-            bestT = t;
-        }
-    }
+    distance = std::fmod(distance, trackLength);
+    if (distance < 0.0f) distance += trackLength;
     
-    return bestT * trackLength;
+    int last = (int)distanceToParameter.size() - 1;
+    float index = distance / trackLength * last;
+    int i = std::min((int)index, last - 1);
+    float fraction = index - i;
+    
+    return distanceToParameter[i] + (distanceToParameter[i + 1] - distanceToParameter[i]) * fraction;
 }
 
-float Track::getParameterFromDistance(float distance) const {
-    if (trackLength <= 0.0f) return 0.0f;
-    return std::fmod(distance / trackLength, 1.0f);
+float Track::getDistanceFromParameter(float t) const {
+    if (parameterToDistance.size() < 2) return 0.0f;
+    
+    t = std::fmod(t, 1.0f);
+    if (t < 0.0f) t += 1.0f;
+    
+    int last = (int)parameterToDistance.size() - 1;
+    float index = t * last;
+    int i = std::min((int)index, last - 1);
+    float fraction = index - i;
+    
+    return parameterToDistance[i] + (parameterToDistance[i + 1] - parameterToDistance[i]) * fraction;
 }
 
 float Track::getParameterFromPosition(const Vector3& position) const {
     return getParameterFromDistance(getDistanceAlongTrack(position));
 }
 
+Track::TrackProjection Track::getTrackProjection(const Vector3& localPosition, int segmentHint) const {
+    Vector3 position = localPosition + origin;
+    
+    TrackProjection result;
+    result.point = localPosition;
+    result.segment = -1;
+    result.segmentT = 0.0f;
+    result.distanceAlongTrack = 0.0f;
+    result.distanceToTrack = std::numeric_limits<float>::max();
+    
+    int count = (int)trackPoints.size();
+    if (count < 2) return result;
+    
+    float bestDistance = std::numeric_limits<float>::max();
+    float bestT = 0.0f;
+    int best = -1;
+    
+    // Warm start: walk downhill from the hint, usually zero or one step
+    if (segmentHint >= 0 && segmentHint < count) {
+        best = segmentHint;
+        bestDistance = projectOntoSegment(position, best, bestT);
+        
+        for (int steps = 0; steps < count; steps++) {
+            int prev = (best - 1 + count) % count;
+            int next = (best + 1) % count;
+            float prevT, nextT;
+            float prevDistance = projectOntoSegment(position, prev, prevT);
+            float nextDistance = projectOntoSegment(position, next, nextT);
+            
+            if (nextDistance < bestDistance && nextDistance <= prevDistance) {
+                best = next; bestDistance = nextDistance; bestT = nextT;
+            } else if (prevDistance < bestDistance) {
+                best = prev; bestDistance = prevDistance; bestT = prevT;
+            } else {
+                break;
+            }
+        }
+        
+        // Off the road another stretch could be closer; do a full search
+        if (bestDistance > trackPoints[best].width * 0.5f) {
+            best = -1;
+            bestDistance = std::numeric_limits<float>::max();
+        }
+    }
+    
+    if (best < 0) {
+        const SegmentGrid& grid = segmentGrid;
+        int cellX = std::max(0, std::min(grid.width - 1, (int)std::floor((position.x - grid.minX) / grid.cellSize)));
+        int cellZ = std::max(0, std::min(grid.depth - 1, (int)std::floor((position.z - grid.minZ) / grid.cellSize)));
+        int maxRing = std::max(grid.width, grid.depth);
+        
+        // Search square rings outward until nothing unseen can be closer
+        for (int ring = 0; ring <= maxRing; ring++) {
+            int x0 = cellX - ring, x1 = cellX + ring;
+            int z0 = cellZ - ring, z1 = cellZ + ring;
+            
+            for (int z = std::max(0, z0); z <= std::min(grid.depth - 1, z1); z++) {
+                for (int x = std::max(0, x0); x <= std::min(grid.width - 1, x1); x++) {
+                    if (z != z0 && z != z1 && x != x0 && x != x1) continue;  // Interior already searched
+                    
+                    int cell = z * grid.width + x;
+                    for (int i = grid.cellStart[cell]; i < grid.cellStart[cell + 1]; i++) {
+                        float t;
+                        float distance = projectOntoSegment(position, grid.segments[i], t);
+                        if (distance < bestDistance) {
+                            best = grid.segments[i]; bestDistance = distance; bestT = t;
+                        }
+                    }
+                }
+            }
+            
+            // Unseen segments lie wholly outside the searched square
+            float bound = std::numeric_limits<float>::max();
+            if (x0 > 0) bound = std::min(bound, position.x - (grid.minX + x0 * grid.cellSize));
+            if (x1 < grid.width - 1) bound = std::min(bound, grid.minX + (x1 + 1) * grid.cellSize - position.x);
+            if (z0 > 0) bound = std::min(bound, position.z - (grid.minZ + z0 * grid.cellSize));
+            if (z1 < grid.depth - 1) bound = std::min(bound, grid.minZ + (z1 + 1) * grid.cellSize - position.z);
+            
+            if (bestDistance <= bound) break;
+        }
+    }
+    
+    const Vector3& a = trackPoints[best].position;
+    const Vector3& b = trackPoints[(best + 1) % count].position;
+    float spacing = trackLength / count;
+    
+    result.point = Vector3::lerpUnclamped(a, b, bestT) - origin;
+    result.segment = best;
+    result.segmentT = bestT;
+    result.distanceAlongTrack = (best + bestT) * spacing;
+    result.distanceToTrack = bestDistance;
+    return result;
+}
+
 void Track::generateCheckpoints(int numCheckpoints) {
-    checkpoints.clear();
+    detachFromFile();
+    storage.checkpoints.clear();
     
     for (int i = 0; i < numCheckpoints; i++) {
-        float t = (float)i / (float)numCheckpoints;
-        TrackPoint point = getTrackPoint(t);
+        float distance = trackLength * i / numCheckpoints;
+        TrackPoint point = evaluateTrackPoint(getParameterFromDistance(distance));
         
         Checkpoint checkpoint;
         checkpoint.position = point.position;
+        checkpoint.distanceAlongTrack = distance;
         checkpoint.direction = point.tangent;
         checkpoint.width = point.width;
         checkpoint.height = 3.0f;
         checkpoint.lapNumber = 0;
         checkpoint.isStartFinish = (i == 0);
         
-        checkpoints.push_back(checkpoint);
+        storage.checkpoints.push_back(checkpoint);
     }
+    checkpoints = storage.checkpoints;
 }
 
-bool Track::checkCheckpoint(const Vector3& position, float radius) {
-    if (checkpoints.empty()) return false;
+void Track::generateTrackGeometry() {
+    detachFromFile();
     
-    for (size_t i = 0; i < checkpoints.size(); i++) {
-        float distance = (position - checkpoints[i].position).length();
-        if (distance < radius) {
-            if (i == currentCheckpoint) {
-                currentCheckpoint++;
-                if (currentCheckpoint >= checkpoints.size()) {
-                    currentCheckpoint = 0;
-                    currentLap++;
-                }
-                return true;
-            }
+    std::vector<TrackVertex>& vertices = storage.vertices;
+    std::vector<unsigned int>& indices = storage.indices;
+    vertices.clear();
+    indices.clear();
+    
+    if (!trackPoints.empty()) {
+        int segments = trackPoints.size();
+        vertices.resize(segments * 2);
+        indices.reserve(segments * 6);
+        
+        trackVertices = vertices;
+        writeTrackVertices(0, segments);
+        
+        // Generate indices for quads. The track is closed: the last quad
+        // joins the last point back to the first, across the start line.
+        for (int i = 0; i < segments; i++) {
+            int base = i * 2;
+            int next = (i + 1) % segments * 2;
+            
+            // First triangle
+            indices.push_back(base);
+            indices.push_back(next);
+            indices.push_back(base + 1);
+            
+            // Second triangle
+            indices.push_back(base + 1);
+            indices.push_back(next);
+            indices.push_back(next + 1);
         }
     }
     
-    return false;
+    trackVertices = vertices;
+    trackIndices = indices;
+    geometryVersion++;
+    layoutVersion++;
+    dirtyPointFirst = dirtyPointLast = -1;
 }
 
-void Track::resetLapProgress() {
-    currentLap = 0;
-    currentCheckpoint = 0;
+Track::GeometryRange Track::consumeDirtyGeometry() {
+    GeometryRange range = { 0, 0 };
+    if (dirtyPointFirst >= 0) {
+        range.firstVertex = dirtyPointFirst * 2;
+        range.vertexCount = (dirtyPointLast - dirtyPointFirst + 1) * 2;
+    }
+    dirtyPointFirst = dirtyPointLast = -1;
+    return range;
 }
 
-void Track::generateTrackGeometry() {
-    trackVertices.clear();
-    trackNormals.clear();
-    trackUVs.clear();
-    trackIndices.clear();
-    
-    if (trackPoints.empty()) return;
+std::shared_ptr<const Track::Snapshot> Track::createSnapshot() const {
+    std::shared_ptr<Snapshot> snapshot = std::make_shared<Snapshot>();
+    snapshot->geometryVersion = geometryVersion;
+    snapshot->trackLength = trackLength;
+    snapshot->pointCount = trackPoints.size();
+    snapshot->hasGeometry = trackVertices.size() == trackPoints.size() * 2 &&
+                            trackIndices.size() == trackPoints.size() * 6;
     
-    int segments = trackPoints.size();
-    int verticesPerSegment = 4; // Left, right, left, right (for quads)
+    int blockCount = (snapshot->pointCount + Snapshot::BlockPoints - 1) / Snapshot::BlockPoints;
+    if (layoutVersion != snapshotLayoutVersion || (int)snapshotBlocks.size() != blockCount) {
+        snapshotBlocks.assign(blockCount, nullptr);
+        snapshotLayoutVersion = layoutVersion;
+    }
     
-    for (int i = 0; i < segments; i++) {
-        TrackPoint point = trackPoints[i];
-        float t = (float)i / (float)(segments - 1);
-        
-        Vector3 left = point.position + point.normal * (point.width * 0.5f);
-        Vector3 right = point.position - point.normal * (point.width * 0.5f);
+    // Only blocks edited since the last snapshot are rebuilt. The mapping
+    // is read-only and outlives this track's hold on it, so a loaded
+    // track's blocks view it; anything in 'storage' may be edited, so
+    // those are copied.
+    for (int b = 0; b < blockCount; b++) {
+        if (snapshotBlocks[b]) continue;
         
-        trackVertices.push_back(left);
-        trackVertices.push_back(right);
-        trackNormals.push_back(point.binormal);
-        trackNormals.push_back(point.binormal);
-        trackUVs.push_back(Vector3(t, 0.0f, 0.0f));
-        trackUVs.push_back(Vector3(t, 1.0f, 0.0f));
-    }
-    
-    // Generate indices for quads
-    for (int i = 0; i < segments - 1; i++) {
-        int base = i * 2;
-        int next = (i + 1) * 2;
-        
-        // First triangle
-        trackIndices.push_back(base);
-        trackIndices.push_back(next);
-        trackIndices.push_back(base + 1);
+        size_t first = (size_t)b * Snapshot::BlockPoints;
+        size_t count = std::min((size_t)Snapshot::BlockPoints, trackPoints.size() - first);
+        ArrayView<TrackPoint> points(trackPoints.data() + first, count);
+        ArrayView<TrackVertex> vertices;
+        ArrayView<unsigned int> indices;
+        if (snapshot->hasGeometry) {
+            vertices = ArrayView<TrackVertex>(trackVertices.data() + first * 2, count * 2);
+            indices = ArrayView<unsigned int>(trackIndices.data() + first * 6, count * 6);
+        }
         
-        // Second triangle
-        trackIndices.push_back(base + 1);
-        trackIndices.push_back(next);
-        trackIndices.push_back(next + 1);
+        std::shared_ptr<Snapshot::Block> block = std::make_shared<Snapshot::Block>();
+        if (mappedFile) {
+            block->file = mappedFile;
+            block->points = points;
+            block->vertices = vertices;
+            block->indices = indices;
+        } else {
+            block->pointStorage.assign(points.begin(), points.end());
+            block->vertexStorage.assign(vertices.begin(), vertices.end());
+            block->indexStorage.assign(indices.begin(), indices.end());
+            block->points = block->pointStorage;
+            block->vertices = block->vertexStorage;
+            block->indices = block->indexStorage;
+        }
+        snapshotBlocks[b] = block;
     }
+    
+    snapshot->blocks = snapshotBlocks;
+    return snapshot;
 }
-
+    
 void Track::setTrackWidth(float width) {
     trackWidth = std::max(0.1f, width);
-    generateTrackGeometry();
+    setTrackWidth(trackWidth, 0.0f, trackLength);
 }
 
 void Track::setBankingAmount(float banking) {
     bankingAmount = banking;
     calculateTrackBanking();
-    generateTrackGeometry();
+    writeTrackVertices(0, trackPoints.size());
+}
+
+void Track::setTrackWidth(float width, float fromDistance, float toDistance) {
+    detachFromFile();
+    width = std::max(0.1f, width);
+    
+    int first, count;
+    getPointSpan(fromDistance, toDistance, first, count);
+    int points = storage.trackPoints.size();
+    for (int i = 0; i < count; i++) {
+        storage.trackPoints[(first + i) % points].width = width;
+    }
+    
+    refreshCheckpoints(fromDistance, toDistance);
+    writeTrackVertices(first, count);
+}
+
+void Track::setBankingAmount(float banking, float fromDistance, float toDistance) {
+    detachFromFile();
+    
+    int first, count;
+    getPointSpan(fromDistance, toDistance, first, count);
+    int points = storage.trackPoints.size();
+    for (int i = 0; i < count; i++) {
+        storage.trackPoints[(first + i) % points].banking = banking;
+    }
+    
+    writeTrackVertices(first, count);
+}
+
+void Track::setSurfaceMaterial(SurfaceMaterial surface, float fromDistance, float toDistance) {
+    detachFromFile();
+    
+    int first, count;
+    getPointSpan(fromDistance, toDistance, first, count);
+    int points = storage.trackPoints.size();
+    for (int i = 0; i < count; i++) {
+        storage.trackPoints[(first + i) % points].surface = surface;
+    }
+    
+    // Rewriting the span bumps the geometry version, which is what ground
+    // queries watch to pick up new surfaces
+    writeTrackVertices(first, count);
+}
+
+void Track::setControlPoint(int index, const Vector3& position) {
+    int count = controlPoints.size();
+    if (index < 0 || index >= count) return;
+    
+    detachFromFile();
+    
+    // Segments index-2 to index+1 use this control point, so the edit
+    // reshapes the curve between parameters (index - 2) / count and
+    // (index + 2) / count and nowhere else
+    float spanStart = (float)(index - 2) / count;
+    float spanEnd = (float)(index + 2) / count;
+    float oldLength = trackLength;
+    float oldStart = getDistanceFromParameter(spanStart);
+    float oldEnd = getDistanceFromParameter(spanEnd);
+    
+    storage.controlPoints[index] = position;
+    for (int i = index - 2; i <= index + 1; i++) {
+        buildSplineSegment((i + count) % count);
+    }
+    buildArcLengthTables();
+    
+    // The track length changes, so every evenly spaced sample slides along
+    // the curve. Small changes only move the edited arc's samples; larger
+    // ones, or edits across the start line, re-evaluate them all in place,
+    // widths and banking kept.
+    if (spanStart <= 0.0f || spanEnd >= 1.0f ||
+        !resampleEditedSpan(oldStart, oldEnd, oldLength)) {
+        sampleDrift = 0.0f;
+        updateTrackPointFrames();
+        buildSegmentGrid();
+        writeTrackVertices(0, trackPoints.size());
+    }
+    
+    // Only a handful of checkpoints; cheaper to refresh them all than to
+    // work out which moved
+    refreshCheckpoints(0.0f, trackLength);
 }
 
 void Track::setTrackColor(const Vector3& color) {
@@ -362,26 +605,232 @@ void Track::setTrackLineWidth(float width) {
 }
 
 Vector3 Track::getClosestPointOnTrack(const Vector3& position) const {
-    float minDistance = std::numeric_limits<float>::max();
-    Vector3 closestPoint;
+    return getTrackProjection(position).point;
+}
+
+float Track::getDistanceToTrack(const Vector3& position) const {
+    return getTrackProjection(position).distanceToTrack;
+}
+
+bool Track::isPositionOnTrack(const Vector3& position, float tolerance) const {
+    return getDistanceToTrack(position) <= tolerance;
+}
+
+bool Track::saveBinary(const std::string& path) const {
+    using namespace TrackFormat;
     
-    for (const TrackPoint& point : trackPoints) {
-        float distance = (position - point.position).length();
-        if (distance < minDistance) {
-            minDistance = distance;
-            closestPoint = point.position;
+    Header header = {};
+    header.magic = Magic;
+    header.version = Version;
+    header.headerSize = sizeof(Header);
+    header.sectionCount = SectionCount;
+    header.trackLength = trackLength;
+    header.trackWidth = trackWidth;
+    header.bankingAmount = bankingAmount;
+    header.resolution = trackResolution;
+    header.gridMinX = segmentGrid.minX;
+    header.gridMinZ = segmentGrid.minZ;
+    header.gridCellSize = segmentGrid.cellSize;
+    header.gridWidth = segmentGrid.width;
+    header.gridDepth = segmentGrid.depth;
+    
+    struct SectionSource {
+        const void* data;
+        uint64_t count;
+        uint32_t elementSize;
+    };
+    SectionSource sources[SectionCount];
+    sources[ControlPoints] = { controlPoints.data(), controlPoints.size(), sizeof(Vector3) };
+    sources[SplineSegments] = { splineSegments.data(), splineSegments.size(), sizeof(SplineSegment) };
+    sources[ParameterToDistance] = { parameterToDistance.data(), parameterToDistance.size(), sizeof(float) };
+    sources[DistanceToParameter] = { distanceToParameter.data(), distanceToParameter.size(), sizeof(float) };
+    sources[TrackPoints] = { trackPoints.data(), trackPoints.size(), sizeof(TrackPoint) };
+    sources[Checkpoints] = { checkpoints.data(), checkpoints.size(), sizeof(Checkpoint) };
+    sources[GridCells] = { segmentGrid.cellStart.data(), segmentGrid.cellStart.size(), sizeof(int) };
+    sources[GridSegments] = { segmentGrid.segments.data(), segmentGrid.segments.size(), sizeof(int) };
+    sources[Vertices] = { trackVertices.data(), trackVertices.size(), sizeof(TrackVertex) };
+    sources[Indices] = { trackIndices.data(), trackIndices.size(), sizeof(unsigned int) };
+    
+    uint64_t offset = sizeof(Header);
+    for (uint32_t i = 0; i < SectionCount; i++) {
+        offset = (offset + SectionAlignment - 1) & ~(SectionAlignment - 1);
+        header.sections[i] = { offset, sources[i].count, sources[i].elementSize, 0 };
+        offset += sources[i].count * sources[i].elementSize;
+    }
+    
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) return false;
+    
+    file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+    uint64_t written = sizeof(Header);
+    
+    static const char padding[SectionAlignment] = {};
+    for (uint32_t i = 0; i < SectionCount; i++) {
+        uint64_t bytes = sources[i].count * sources[i].elementSize;
+        file.write(padding, header.sections[i].offset - written);
+        if (bytes > 0) {
+            file.write(static_cast<const char*>(sources[i].data), bytes);
         }
+        written = header.sections[i].offset + bytes;
     }
     
-    return closestPoint;
+    return file.good();
 }
 
-float Track::getDistanceToTrack(const Vector3& position) const {
-    return (position - getClosestPointOnTrack(position)).length();
+// Everything a query, the renderer or the streamer indexes with, checked
+// against what generation writes, so a damaged file fails to load
+// instead of reading out of bounds later. Point positions and the like
+// are left alone: wrong values there look wrong but stay in bounds.
+bool Track::hasValidContents(const unsigned char* base, const TrackFormat::Header& header) {
+    using namespace TrackFormat;
+    auto count = [&](Section index) { return header.sections[index].count; };
+    
+    if (!isFinitePositive(header.trackLength) || !isFinitePositive(header.gridCellSize) ||
+        !std::isfinite(header.gridMinX) || !std::isfinite(header.gridMinZ)) {
+        return false;
+    }
+    
+    // Closed spline: one segment per control point, arc-length tables
+    // sampled evenly over all of them
+    uint64_t segments = count(SplineSegments);
+    uint64_t arcSamples = segments * ArcSamplesPerSegment + 1;
+    if (segments < 4 || count(ControlPoints) != segments ||
+        count(ParameterToDistance) != arcSamples || count(DistanceToParameter) != arcSamples) {
+        return false;
+    }
+    const float* toDistance = sectionData<float>(base, header, ParameterToDistance);
+    const float* toParameter = sectionData<float>(base, header, DistanceToParameter);
+    for (uint64_t i = 0; i < arcSamples; i++) {
+        if (!(toDistance[i] >= 0.0f && toDistance[i] <= header.trackLength) ||
+            !(toParameter[i] >= 0.0f && toParameter[i] <= 1.0f)) {
+            return false;
+        }
+    }
+    
+    uint64_t points = count(TrackPoints);
+    if (points < 2 || points > (uint64_t)std::numeric_limits<int>::max() / 6) return false;
+    
+    // Grid: ascending offsets into the segment list, segments in range
+    uint64_t cells = (uint64_t)header.gridWidth * (uint64_t)header.gridDepth;
+    if (cells >= (uint64_t)std::numeric_limits<int>::max()) return false;
+    const int* cellStart = sectionData<int>(base, header, GridCells);
+    if (cellStart[0] != 0 || (uint64_t)cellStart[cells] != count(GridSegments)) return false;
+    for (uint64_t c = 0; c < cells; c++) {
+        if (cellStart[c + 1] < cellStart[c]) return false;
+    }
+    const int* gridSegments = sectionData<int>(base, header, GridSegments);
+    for (uint64_t i = 0; i < count(GridSegments); i++) {
+        if (gridSegments[i] < 0 || (uint64_t)gridSegments[i] >= points) return false;
+    }
+    
+    // Geometry: two vertices per point and one quad per segment, the
+    // last closing the loop; the streamer cuts chunks on that layout
+    if (count(Vertices) != points * 2 || count(Indices) != points * 6) return false;
+    const unsigned int* indices = sectionData<unsigned int>(base, header, Indices);
+    for (uint64_t i = 0; i < points; i++) {
+        unsigned int start = (unsigned int)(i * 2);
+        unsigned int next = (unsigned int)((i + 1) % points * 2);
+        const unsigned int quad[6] = { start, next, start + 1, start + 1, next, next + 1 };
+        if (!std::equal(quad, quad + 6, indices + i * 6)) return false;
+    }
+    return true;
 }
 
-bool Track::isPositionOnTrack(const Vector3& position, float tolerance) const {
-    return getDistanceToTrack(position) <= tolerance;
+bool Track::loadBinary(const std::string& path) {
+    using namespace TrackFormat;
+    
+    std::unique_ptr<MappedFile> file = std::make_unique<MappedFile>();
+    if (!file->open(path) || file->size() < sizeof(Header)) return false;
+    
+    const unsigned char* base = file->data();
+    const Header& header = *reinterpret_cast<const Header*>(base);
+    if (header.magic != Magic || header.version != Version ||
+        header.headerSize != sizeof(Header) || header.sectionCount != SectionCount) {
+        return false;
+    }
+    
+    static const uint32_t elementSizes[SectionCount] = {
+        sizeof(Vector3), sizeof(SplineSegment), sizeof(float), sizeof(float), sizeof(TrackPoint),
+        sizeof(Checkpoint), sizeof(int), sizeof(int), sizeof(TrackVertex), sizeof(unsigned int)
+    };
+    for (uint32_t i = 0; i < SectionCount; i++) {
+        const SectionEntry& section = header.sections[i];
+        if (section.elementSize != elementSizes[i] || section.offset % SectionAlignment != 0 ||
+            section.offset > file->size() || section.count > (file->size() - section.offset) / section.elementSize) {
+            return false;
+        }
+    }
+    
+    uint64_t gridCells = (uint64_t)header.gridWidth * (uint64_t)header.gridDepth + 1;
+    if (header.gridWidth <= 0 || header.gridDepth <= 0 || header.sections[GridCells].count != gridCells ||
+        !hasValidContents(base, header)) {
+        return false;
+    }
+    
+    // Point every view into the mapping; nothing is parsed or copied
+    auto section = [&](Section index) { return base + header.sections[index].offset; };
+    auto count = [&](Section index) { return (size_t)header.sections[index].count; };
+    
+    storage = Storage();
+    controlPoints = ArrayView<Vector3>(reinterpret_cast<const Vector3*>(section(ControlPoints)), count(ControlPoints));
+    splineSegments = ArrayView<SplineSegment>(reinterpret_cast<const SplineSegment*>(section(SplineSegments)), count(SplineSegments));
+    parameterToDistance = ArrayView<float>(reinterpret_cast<const float*>(section(ParameterToDistance)), count(ParameterToDistance));
+    distanceToParameter = ArrayView<float>(reinterpret_cast<const float*>(section(DistanceToParameter)), count(DistanceToParameter));
+    trackPoints = ArrayView<TrackPoint>(reinterpret_cast<const TrackPoint*>(section(TrackPoints)), count(TrackPoints));
+    checkpoints = ArrayView<Checkpoint>(reinterpret_cast<const Checkpoint*>(section(Checkpoints)), count(Checkpoints));
+    segmentGrid.cellStart = ArrayView<int>(reinterpret_cast<const int*>(section(GridCells)), count(GridCells));
+    segmentGrid.segments = ArrayView<int>(reinterpret_cast<const int*>(section(GridSegments)), count(GridSegments));
+    trackVertices = ArrayView<TrackVertex>(reinterpret_cast<const TrackVertex*>(section(Vertices)), count(Vertices));
+    trackIndices = ArrayView<unsigned int>(reinterpret_cast<const unsigned int*>(section(Indices)), count(Indices));
+    
+    segmentGrid.minX = header.gridMinX;
+    segmentGrid.minZ = header.gridMinZ;
+    segmentGrid.cellSize = header.gridCellSize;
+    segmentGrid.width = header.gridWidth;
+    segmentGrid.depth = header.gridDepth;
+    
+    trackLength = header.trackLength;
+    trackWidth = header.trackWidth;
+    bankingAmount = header.bankingAmount;
+    trackResolution = header.resolution;
+    
+    mappedFile = std::move(file);
+    geometryVersion++;
+    layoutVersion++;
+    dirtyPointFirst = dirtyPointLast = -1;
+    sampleDrift = 0.0f;
+    return true;
+}
+
+void Track::bindStorage() {
+    controlPoints = storage.controlPoints;
+    splineSegments = storage.splineSegments;
+    parameterToDistance = storage.parameterToDistance;
+    distanceToParameter = storage.distanceToParameter;
+    trackPoints = storage.trackPoints;
+    checkpoints = storage.checkpoints;
+    segmentGrid.cellStart = storage.gridCells;
+    segmentGrid.segments = storage.gridSegments;
+    trackVertices = storage.vertices;
+    trackIndices = storage.indices;
+}
+
+void Track::detachFromFile() {
+    if (!mappedFile) return;
+    
+    storage.controlPoints.assign(controlPoints.begin(), controlPoints.end());
+    storage.splineSegments.assign(splineSegments.begin(), splineSegments.end());
+    storage.parameterToDistance.assign(parameterToDistance.begin(), parameterToDistance.end());
+    storage.distanceToParameter.assign(distanceToParameter.begin(), distanceToParameter.end());
+    storage.trackPoints.assign(trackPoints.begin(), trackPoints.end());
+    storage.checkpoints.assign(checkpoints.begin(), checkpoints.end());
+    storage.gridCells.assign(segmentGrid.cellStart.begin(), segmentGrid.cellStart.end());
+    storage.gridSegments.assign(segmentGrid.segments.begin(), segmentGrid.segments.end());
+    storage.vertices.assign(trackVertices.begin(), trackVertices.end());
+    storage.indices.assign(trackIndices.begin(), trackIndices.end());
+    
+    bindStorage();
+    mappedFile.reset();
 }
 
 void Track::debugDraw() const {
@@ -389,20 +838,390 @@ void Track::debugDraw() const {
     // For now, it's a placeholder
 }
 
-void Track::calculateTrackProperties() {
-    if (trackPoints.empty()) {
-        trackLength = 0.0f;
-        return;
+void Track::buildSpline(const std::vector<Vector3>& points) {
+    storage.controlPoints = points;
+    storage.splineSegments.resize(points.size());
+    controlPoints = storage.controlPoints;
+    splineSegments = storage.splineSegments;
+    
+    for (int i = 0; i < (int)points.size(); i++) {
+        buildSplineSegment(i);
     }
+}
+
+void Track::buildSplineSegment(int index) {
+    const std::vector<Vector3>& points = storage.controlPoints;
+    int count = (int)points.size();
+    const float minKnotSpacing = 1e-4f;
     
+    const Vector3& p0 = points[(index - 1 + count) % count];
+    const Vector3& p1 = points[index];
+    const Vector3& p2 = points[(index + 1) % count];
+    const Vector3& p3 = points[(index + 2) % count];
+    
+    // Centripetal knot spacing (alpha = 0.5) avoids cusps and loops
+    float t01 = std::max(minKnotSpacing, std::sqrt((p1 - p0).length()));
+    float t12 = std::max(minKnotSpacing, std::sqrt((p2 - p1).length()));
+    float t23 = std::max(minKnotSpacing, std::sqrt((p3 - p2).length()));
+    
+    Vector3 m1 = (p2 - p1) + ((p1 - p0) / t01 - (p2 - p0) / (t01 + t12)) * t12;
+    Vector3 m2 = (p2 - p1) + ((p3 - p2) / t23 - (p3 - p1) / (t12 + t23)) * t12;
+    
+    SplineSegment& segment = storage.splineSegments[index];
+    segment.a = (p1 - p2) * 2.0f + m1 + m2;
+    segment.b = (p1 - p2) * -3.0f - m1 * 2.0f - m2;
+    segment.c = m1;
+    segment.d = p1;
+}
+
+void Track::buildArcLengthTables() {
+    std::vector<float>& toDistance = storage.parameterToDistance;
+    std::vector<float>& toParameter = storage.distanceToParameter;
+    toDistance.clear();
+    toParameter.clear();
     trackLength = 0.0f;
-    for (size_t i = 1; i < trackPoints.size(); i++) {
-        float segmentLength = (trackPoints[i].position - trackPoints[i-1].position).length();
-        trackLength += segmentLength;
+    
+    if (!splineSegments.empty()) {
+        int samples = (int)splineSegments.size() * ArcSamplesPerSegment;
+        toDistance.resize(samples + 1);
+        toParameter.resize(samples + 1);
+        
+        Vector3 previous, velocity, acceleration;
+        evaluateSpline(0.0f, previous, velocity, acceleration);
+        toDistance[0] = 0.0f;
+        
+        for (int i = 1; i <= samples; i++) {
+            Vector3 position;
+            evaluateSpline((float)i / (float)samples, position, velocity, acceleration);
+            toDistance[i] = toDistance[i - 1] + (position - previous).length();
+            previous = position;
+        }
+        trackLength = toDistance[samples];
+        
+        // Invert with a single sweep; both tables are monotonic
+        int j = 0;
+        for (int i = 0; i <= samples; i++) {
+            float target = trackLength * i / samples;
+            while (j < samples - 1 && toDistance[j + 1] < target) {
+                j++;
+            }
+            
+            float span = toDistance[j + 1] - toDistance[j];
+            float fraction = span > 0.0f ? (target - toDistance[j]) / span : 0.0f;
+            fraction = std::max(0.0f, std::min(1.0f, fraction));
+            toParameter[i] = (j + fraction) / samples;
+        }
+    }
+    
+    parameterToDistance = toDistance;
+    distanceToParameter = toParameter;
+}
+
+void Track::sampleTrackPoints(int resolution) {
+    // Fresh samples take the track-wide width and banking
+    trackPoints = ArrayView<TrackPoint>();
+    storage.trackPoints.clear();
+    sampleDrift = 0.0f;
+    if (resolution > 0 && trackLength > 0.0f) {
+        storage.trackPoints.reserve(resolution);
+        for (int i = 0; i < resolution; i++) {
+            storage.trackPoints.push_back(evaluateTrackPoint(getParameterFromDistance(trackLength * i / resolution)));
+        }
+    }
+    trackPoints = storage.trackPoints;
+}
+
+void Track::updateTrackPointFrames() {
+    std::vector<TrackPoint>& points = storage.trackPoints;
+    int count = points.size();
+    for (int i = 0; i < count; i++) {
+        updateTrackPointFrame(points[i], getParameterFromDistance(trackLength * i / count));
     }
 }
 
+void Track::updateTrackPointFrame(TrackPoint& point, float t) const {
+    // Same frame as evaluateTrackPoint, minus the width and banking lookups
+    Vector3 position, velocity, acceleration;
+    evaluateSpline(t, position, velocity, acceleration);
+    
+    point.position = position;
+    point.tangent = velocity.normalized();
+    point.normal = Vector3::up().cross(point.tangent).normalized();
+    point.binormal = point.tangent.cross(point.normal);
+    
+    float speed = velocity.length();
+    point.curvature = speed > 0.0f ? velocity.cross(acceleration).length() / (speed * speed * speed) : 0.0f;
+}
+
+bool Track::resampleEditedSpan(float oldStart, float oldEnd, float oldLength) {
+    std::vector<TrackPoint>& points = storage.trackPoints;
+    int count = points.size();
+    float lengthChange = trackLength - oldLength;
+    if (count < 4 || oldEnd <= oldStart || oldLength <= 0.0f) return false;
+    
+    // Samples outside the edited arc stay where they are, on unchanged
+    // curve, but each edit moves them up to |lengthChange| off their even
+    // spacing. That adds up across edits until a full resample.
+    float drift = sampleDrift + std::fabs(lengthChange);
+    if (drift > MaxSampleDrift * trackLength / count) return false;
+    
+    // Samples already drifted less than a spacing, so one extra on each
+    // side covers any that sit on the reshaped curve
+    float oldSpacing = oldLength / count;
+    int first = (int)std::ceil(oldStart / oldSpacing) - 1;
+    int last = (int)std::floor(oldEnd / oldSpacing) + 1;
+    if (first < 1 || last > count - 2) return false;
+    
+    // Before the arc distances are unchanged, after it they all move by
+    // lengthChange, and within it they stretch to match
+    float stretch = (oldEnd - oldStart + lengthChange) / (oldEnd - oldStart);
+    
+    // Segments first-1 to last change. The grid can stay if each still
+    // overlaps exactly the cells it did, and nothing left the grid.
+    const SegmentGrid& grid = segmentGrid;
+    float gridMaxX = grid.minX + grid.width * grid.cellSize;
+    float gridMaxZ = grid.minZ + grid.depth * grid.cellSize;
+    bool gridValid = true;
+    Vector3 previousOld = points[first - 1].position;
+    for (int i = first; i <= last + 1; i++) {
+        TrackPoint& point = points[i];
+        Vector3 oldPosition = point.position;
+        
+        if (i <= last) {
+            float distance = oldLength * i / count;
+            if (distance > oldEnd) {
+                distance += lengthChange;
+            } else if (distance > oldStart) {
+                distance = oldStart + (distance - oldStart) * stretch;
+            }
+            updateTrackPointFrame(point, getParameterFromDistance(distance));
+            
+            const Vector3& p = point.position;
+            gridValid = gridValid && p.x >= grid.minX && p.x < gridMaxX && p.z >= grid.minZ && p.z < gridMaxZ;
+        }
+        
+        if (gridValid) {
+            int oldCells[4], newCells[4];
+            getSegmentCells(previousOld, oldPosition, oldCells);
+            getSegmentCells(points[i - 1].position, point.position, newCells);
+            gridValid = std::equal(oldCells, oldCells + 4, newCells);
+        }
+        previousOld = oldPosition;
+    }
+    
+    sampleDrift = drift;
+    if (!gridValid) {
+        buildSegmentGrid();
+    }
+    writeTrackVertices(first, last - first + 1);
+    return true;
+}
+
+void Track::getPointSpan(float fromDistance, float toDistance, int& first, int& count) const {
+    first = 0;
+    count = 0;
+    
+    int points = trackPoints.size();
+    if (points == 0 || trackLength <= 0.0f) return;
+    
+    float span = toDistance - fromDistance;
+    if (span >= trackLength) {
+        count = points;
+        return;
+    }
+    
+    fromDistance = std::fmod(fromDistance, trackLength);
+    if (fromDistance < 0.0f) fromDistance += trackLength;
+    span = std::fmod(span, trackLength);
+    if (span < 0.0f) span += trackLength;
+    
+    float spacing = trackLength / points;
+    int begin = (int)std::ceil(fromDistance / spacing);
+    int end = (int)std::floor((fromDistance + span) / spacing);
+    
+    first = begin % points;
+    count = std::max(0, std::min(points, end - begin + 1));
+}
+
+void Track::refreshCheckpoints(float fromDistance, float toDistance) {
+    if (checkpoints.empty() || trackLength <= 0.0f) return;
+    
+    float span = toDistance - fromDistance;
+    if (span < trackLength) {
+        span = std::fmod(span, trackLength);
+        if (span < 0.0f) span += trackLength;
+    }
+    
+    int count = storage.checkpoints.size();
+    for (int i = 0; i < count; i++) {
+        Checkpoint& checkpoint = storage.checkpoints[i];
+        float distance = trackLength * i / count;
+        
+        float offset = std::fmod(distance - fromDistance, trackLength);
+        if (offset < 0.0f) offset += trackLength;
+        if (offset > span) continue;
+        
+        TrackPoint point = evaluateTrackPoint(getParameterFromDistance(distance));
+        checkpoint.position = point.position;
+        checkpoint.distanceAlongTrack = distance;
+        checkpoint.direction = point.tangent;
+        checkpoint.width = point.width;
+    }
+}
+
+void Track::writeTrackVertices(int first, int count) {
+    int segments = storage.trackPoints.size();
+    if (segments == 0 || count <= 0 || storage.vertices.size() != (size_t)segments * 2) return;
+    
+    for (int k = 0; k < count; k++) {
+        int i = (first + k) % segments;
+        const TrackPoint& point = storage.trackPoints[i];
+        float t = (float)i / (float)(segments - 1);
+        
+        // Banking rolls the cross-section about the tangent
+        float cosBank = SimMath::cos(point.banking);
+        float sinBank = SimMath::sin(point.banking);
+        Vector3 side = point.normal * cosBank + point.binormal * sinBank;
+        Vector3 up = point.binormal * cosBank - point.normal * sinBank;
+        
+        Vector3 left = point.position + side * (point.width * 0.5f);
+        Vector3 right = point.position - side * (point.width * 0.5f);
+        
+        storage.vertices[i * 2] = { { left.x, left.y, left.z }, { up.x, up.y, up.z }, { t, 0.0f } };
+        storage.vertices[i * 2 + 1] = { { right.x, right.y, right.z }, { up.x, up.y, up.z }, { t, 1.0f } };
+    }
+    
+    // A span that wraps past the start dirties both ends
+    int last = first + count - 1;
+    int wrapped = last - segments;
+    last = std::min(last, segments - 1);
+    dirtyPointFirst = dirtyPointFirst < 0 ? first : std::min(dirtyPointFirst, first);
+    dirtyPointLast = std::max(dirtyPointLast, last);
+    if (wrapped >= 0) {
+        dirtyPointFirst = 0;
+    }
+    geometryVersion++;
+    
+    // The next snapshot copies these points' blocks again
+    if (snapshotBlocks.size() == (size_t)(segments + Snapshot::BlockPoints - 1) / Snapshot::BlockPoints) {
+        for (int k = 0; k < count; k++) {
+            snapshotBlocks[(first + k) % segments / Snapshot::BlockPoints].reset();
+        }
+    }
+}
+
+void Track::buildSegmentGrid() {
+    SegmentGrid& grid = segmentGrid;
+    std::vector<int>& cellStart = storage.gridCells;
+    std::vector<int>& segments = storage.gridSegments;
+    cellStart.clear();
+    segments.clear();
+    
+    int count = (int)trackPoints.size();
+    if (count < 2) {
+        grid.minX = grid.minZ = 0.0f;
+        grid.cellSize = 1.0f;
+        grid.width = grid.depth = 1;
+        cellStart.assign(2, 0);
+        grid.cellStart = cellStart;
+        grid.segments = segments;
+        return;
+    }
+    
+    float minX = trackPoints[0].position.x, maxX = minX;
+    float minZ = trackPoints[0].position.z, maxZ = minZ;
+    for (const TrackPoint& point : trackPoints) {
+        minX = std::min(minX, point.position.x);
+        maxX = std::max(maxX, point.position.x);
+        minZ = std::min(minZ, point.position.z);
+        maxZ = std::max(maxZ, point.position.z);
+    }
+    
+    // A few segments per cell; capped so huge tracks don't explode the grid
+    const int maxCellsPerAxis = 512;
+    float spacing = trackLength / count;
+    grid.cellSize = std::max({ spacing * 2.0f, trackWidth, 1.0f,
+                               (maxX - minX) / maxCellsPerAxis, (maxZ - minZ) / maxCellsPerAxis });
+    grid.minX = minX;
+    grid.minZ = minZ;
+    grid.width = (int)((maxX - minX) / grid.cellSize) + 1;
+    grid.depth = (int)((maxZ - minZ) / grid.cellSize) + 1;
+    
+    // Count, prefix-sum, then fill
+    int cells = grid.width * grid.depth;
+    cellStart.assign(cells + 1, 0);
+    for (int i = 0; i < count; i++) {
+        int range[4];
+        getSegmentCells(trackPoints[i].position, trackPoints[(i + 1) % count].position, range);
+        for (int z = range[2]; z <= range[3]; z++) {
+            for (int x = range[0]; x <= range[1]; x++) {
+                cellStart[z * grid.width + x + 1]++;
+            }
+        }
+    }
+    for (int c = 0; c < cells; c++) {
+        cellStart[c + 1] += cellStart[c];
+    }
+    
+    segments.resize(cellStart[cells]);
+    gridCursor.assign(cellStart.begin(), cellStart.end() - 1);
+    for (int i = 0; i < count; i++) {
+        int range[4];
+        getSegmentCells(trackPoints[i].position, trackPoints[(i + 1) % count].position, range);
+        for (int z = range[2]; z <= range[3]; z++) {
+            for (int x = range[0]; x <= range[1]; x++) {
+                segments[gridCursor[z * grid.width + x]++] = i;
+            }
+        }
+    }
+    
+    grid.cellStart = cellStart;
+    grid.segments = segments;
+}
+
+void Track::getSegmentCells(const Vector3& a, const Vector3& b, int range[4]) const {
+    const SegmentGrid& grid = segmentGrid;
+    range[0] = std::min(grid.width - 1, (int)((std::min(a.x, b.x) - grid.minX) / grid.cellSize));
+    range[1] = std::min(grid.width - 1, (int)((std::max(a.x, b.x) - grid.minX) / grid.cellSize));
+    range[2] = std::min(grid.depth - 1, (int)((std::min(a.z, b.z) - grid.minZ) / grid.cellSize));
+    range[3] = std::min(grid.depth - 1, (int)((std::max(a.z, b.z) - grid.minZ) / grid.cellSize));
+}
+
+float Track::projectOntoSegment(const Vector3& position, int segment, float& segmentT) const {
+    const Vector3& a = trackPoints[segment].position;
+    const Vector3& b = trackPoints[(segment + 1) % trackPoints.size()].position;
+    
+    Vector3 ab = b - a;
+    float lengthSquared = ab.lengthSquared();
+    segmentT = lengthSquared > 0.0f ? std::max(0.0f, std::min(1.0f, (position - a).dot(ab) / lengthSquared)) : 0.0f;
+    
+    return (position - (a + ab * segmentT)).length();
+}
+
+void Track::evaluateSpline(float t, Vector3& position, Vector3& velocity, Vector3& acceleration) const {
+    t = std::fmod(t, 1.0f);
+    if (t < 0.0f) t += 1.0f;
+    
+    int count = (int)splineSegments.size();
+    float scaled = t * count;
+    int i = std::min((int)scaled, count - 1);
+    float u = scaled - i;
+    
+    const SplineSegment& segment = splineSegments[i];
+    position = ((segment.a * u + segment.b) * u + segment.c) * u + segment.d;
+    
+    // Derivatives with respect to t rather than the local u
+    velocity = ((segment.a * (3.0f * u) + segment.b * 2.0f) * u + segment.c) * (float)count;
+    acceleration = (segment.a * (6.0f * u) + segment.b * 2.0f) * (float)(count * count);
+}
+
+void Track::calculateTrackProperties() {
+    trackLength = parameterToDistance.empty() ? 0.0f : parameterToDistance.back();
+}
+
 void Track::calculateTrackNormals() {
+    detachFromFile();
+    std::vector<TrackPoint>& trackPoints = storage.trackPoints;
     for (size_t i = 0; i < trackPoints.size(); i++) {
         Vector3 tangent = trackPoints[i].tangent;
         trackPoints[i].normal = Vector3(-tangent.z, 0.0f, tangent.x);
@@ -411,13 +1230,17 @@ void Track::calculateTrackNormals() {
 }
 
 void Track::calculateTrackBanking() {
+    detachFromFile();
+    std::vector<TrackPoint>& trackPoints = storage.trackPoints;
     for (size_t i = 0; i < trackPoints.size(); i++) {
-        float t = (float)i / (float)(trackPoints.size() - 1);
-        trackPoints[i].banking = std::sin(t * 2.0f * M_PI) * bankingAmount;
+        float t = (float)i / (float)trackPoints.size();
+        trackPoints[i].banking = SimMath::sin(static_cast<float>(t * 2.0f * M_PI)) * bankingAmount;
     }
 }
 
 void Track::calculateTrackCurvature() {
+    detachFromFile();
+    std::vector<TrackPoint>& trackPoints = storage.trackPoints;
     for (size_t i = 0; i < trackPoints.size(); i++) {
         int prev = (i - 1 + trackPoints.size()) % trackPoints.size();
         int next = (i + 1) % trackPoints.size();
@@ -435,36 +1258,65 @@ void Track::calculateTrackCurvature() {
 }
 
 Vector3 Track::interpolatePosition(float t) const {
-    // This would implement proper spline interpolation
-    // For now, return a simple circular position
-    float angle = t * 2.0f * M_PI;
-    return Vector3(std::cos(angle) * trackRadius, 0.0f, std::sin(angle) * trackRadius);
+    if (splineSegments.empty()) return Vector3::zero();
+    
+    Vector3 position, velocity, acceleration;
+    evaluateSpline(t, position, velocity, acceleration);
+    return position;
 }
 
 Vector3 Track::interpolateTangent(float t) const {
-    // This would implement proper spline tangent calculation
-    float angle = t * 2.0f * M_PI;
-    return Vector3(-std::sin(angle), 0.0f, std::cos(angle));
+    if (splineSegments.empty()) return Vector3::forward();
+    
+    Vector3 position, velocity, acceleration;
+    evaluateSpline(t, position, velocity, acceleration);
+    return velocity.normalized();
 }
 
 Vector3 Track::interpolateNormal(float t) const {
-    // This would implement proper spline normal calculation
-    float angle = t * 2.0f * M_PI;
-    return Vector3(std::cos(angle), 0.0f, std::sin(angle));
+    return Vector3::up().cross(interpolateTangent(t)).normalized();
 }
 
 Vector3 Track::interpolateBinormal(float t) const {
-    return Vector3(0.0f, 1.0f, 0.0f);
+    Vector3 tangent = interpolateTangent(t);
+    return tangent.cross(Vector3::up().cross(tangent).normalized());
 }
 
 float Track::interpolateWidth(float t) const {
-    return trackWidth;
+    if (trackPoints.empty()) return trackWidth;
+    
+    int i, next;
+    float fraction;
+    getSampleSpan(t, i, next, fraction);
+    return trackPoints[i].width + (trackPoints[next].width - trackPoints[i].width) * fraction;
 }
 
 float Track::interpolateBanking(float t) const {
-    return 0.0f;
+    if (trackLength <= 0.0f) return 0.0f;
+    if (trackPoints.empty()) {
+        return SimMath::sin(static_cast<float>(getDistanceFromParameter(t) / trackLength * 2.0f * M_PI)) * bankingAmount;
+    }
+    
+    int i, next;
+    float fraction;
+    getSampleSpan(t, i, next, fraction);
+    return trackPoints[i].banking + (trackPoints[next].banking - trackPoints[i].banking) * fraction;
+}
+
+void Track::getSampleSpan(float t, int& index, int& next, float& fraction) const {
+    int count = trackPoints.size();
+    float position = getDistanceFromParameter(t) / trackLength * count;
+    
+    index = std::min((int)position, count - 1);
+    next = (index + 1) % count;
+    fraction = position - index;
 }
 
 float Track::interpolateCurvature(float t) const {
-    return 1.0f / trackRadius;
+    if (splineSegments.empty()) return 0.0f;
+    
+    Vector3 position, velocity, acceleration;
+    evaluateSpline(t, position, velocity, acceleration);
+    float speed = velocity.length();
+    return speed > 0.0f ? velocity.cross(acceleration).length() / (speed * speed * speed) : 0.0f;
 }
\ No newline at end of file
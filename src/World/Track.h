@@ -1,6 +1,13 @@
 #pragma once
 #include "../Math/Vector3.h"
 #include "../Math/Matrix4.h"
+#include "../Physics/SurfaceMaterial.h"
+#include "../Utils/ArrayView.h"
+#include "../Utils/MappedFile.h"
+#include "TrackFormat.h"
+#include <cstdint>
+#include <memory>
+#include <string>
 #include <vector>
 
 class Track {
@@ -13,6 +20,7 @@ public:
         float width;
         float banking;
         float curvature;
+        SurfaceMaterial surface;  // Of the segment starting here
     };
 
     struct Checkpoint {
@@ -20,23 +28,138 @@ public:
         Vector3 direction;
         float width;
         float height;
+        float distanceAlongTrack;
         int lapNumber;
         bool isStartFinish;
     };
+    
+    // Exact projection onto the polyline through the track points.
+    // Segment i runs from trackPoints[i] to trackPoints[i + 1], wrapping.
+    struct TrackProjection {
+        Vector3 point;
+        int segment;
+        float segmentT;
+        float distanceAlongTrack;
+        float distanceToTrack;
+    };
+    
+    // Vertices rewritten by edits since the renderer last synced
+    struct GeometryRange {
+        int firstVertex;
+        int vertexCount;
+    };
+
+    // Frozen copy of the track points and render geometry, for readers on
+    // other threads (TrackStreamer) while this track keeps being edited.
+    // It is split into blocks of BlockPoints points that snapshots share
+    // until an edit touches them, so a new snapshot only copies the blocks
+    // edited since the last one. A mapped track's blocks view its file.
+    struct Snapshot {
+        static constexpr int BlockPoints = 256;
+        
+        struct Block {
+            ArrayView<TrackPoint> points;     // In track space
+            ArrayView<TrackVertex> vertices;  // Two per point, if hasGeometry
+            ArrayView<unsigned int> indices;  // Six per point, into the whole track's vertices
+            
+            // What the views point into
+            std::shared_ptr<const MappedFile> file;
+            std::vector<TrackPoint> pointStorage;
+            std::vector<TrackVertex> vertexStorage;
+            std::vector<unsigned int> indexStorage;
+        };
+        
+        uint32_t geometryVersion;
+        float trackLength;
+        int pointCount;
+        bool hasGeometry;  // Two vertices and six indices per track point
+        std::vector<std::shared_ptr<const Block>> blocks;
+        
+        const TrackPoint& getPoint(int index) const {
+            return blocks[index / BlockPoints]->points[index % BlockPoints];
+        }
+        const TrackVertex& getVertex(int index) const {
+            return blocks[index / (BlockPoints * 2)]->vertices[index % (BlockPoints * 2)];
+        }
+        unsigned int getIndex(int index) const {
+            return blocks[index / (BlockPoints * 6)]->indices[index % (BlockPoints * 6)];
+        }
+    };
 
 private:
-    std::vector<TrackPoint> trackPoints;
-    std::vector<Checkpoint> checkpoints;
-    std::vector<Vector3> trackVertices;
-    std::vector<Vector3> trackNormals;
-    std::vector<Vector3> trackUVs;
-    std::vector<unsigned int> trackIndices;
+    // Closed centripetal Catmull-Rom spline through the control points,
+    // stored per segment as a cubic a*u^3 + b*u^2 + c*u + d
+    struct SplineSegment {
+        Vector3 a, b, c, d;
+    };
+    static constexpr int ArcSamplesPerSegment = 32;
+    
+    // Queries only read through these views. They point into 'storage' for
+    // generated tracks, or straight into 'mappedFile' for loaded ones.
+    ArrayView<Vector3> controlPoints;
+    ArrayView<SplineSegment> splineSegments;
+    
+    // Arc-length tables: distance at uniform parameter steps, and parameter
+    // at uniform distance steps, so conversions are a table read and a lerp
+    ArrayView<float> parameterToDistance;
+    ArrayView<float> distanceToParameter;
+    
+    // Samples spaced evenly along the arc length
+    ArrayView<TrackPoint> trackPoints;
+    
+    // Uniform XZ grid over track segments; each cell lists every segment
+    // whose bounds overlap it, packed as offsets + indices
+    struct SegmentGrid {
+        float minX, minZ;
+        float cellSize;
+        int width, depth;
+        ArrayView<int> cellStart;
+        ArrayView<int> segments;
+    };
+    SegmentGrid segmentGrid;
+    ArrayView<Checkpoint> checkpoints;
+    
+    // Interleaved render geometry. geometryVersion changes on every edit,
+    // layoutVersion only when vertex or index counts change. Edits in
+    // between record the touched track points so consumers can patch.
+    ArrayView<TrackVertex> trackVertices;
+    ArrayView<unsigned int> trackIndices;
+    uint32_t geometryVersion;
+    uint32_t layoutVersion;
+    int dirtyPointFirst;
+    int dirtyPointLast;
+    
+    // Control point edits only resample the reshaped arc, which leaves the
+    // samples past it off their even spacing by the change in length. Once
+    // the total passes this fraction of a spacing, the next edit resamples
+    // the whole track.
+    static constexpr float MaxSampleDrift = 0.25f;
+    float sampleDrift;
+    
+    struct Storage {
+        std::vector<Vector3> controlPoints;
+        std::vector<SplineSegment> splineSegments;
+        std::vector<float> parameterToDistance;
+        std::vector<float> distanceToParameter;
+        std::vector<TrackPoint> trackPoints;
+        std::vector<int> gridCells;
+        std::vector<int> gridSegments;
+        std::vector<Checkpoint> checkpoints;
+        std::vector<TrackVertex> vertices;
+        std::vector<unsigned int> indices;
+    };
+    Storage storage;
+    std::shared_ptr<const MappedFile> mappedFile;  // Shared with snapshots
+    
+    // Snapshot blocks still matching the track, reused by the next
+    // snapshot. Edits drop the blocks they touch; layout changes drop all.
+    mutable std::vector<std::shared_ptr<const Snapshot::Block>> snapshotBlocks;
+    mutable uint32_t snapshotLayoutVersion;
+    std::vector<int> gridCursor;  // buildSegmentGrid scratch, kept between rebuilds
     
     float trackLength;
     float trackWidth;
     int numLaps;
-    int currentLap;
-    int currentCheckpoint;
     
     // Track generation parameters
     int trackResolution;
@@ -49,9 +172,15 @@ private:
     Vector3 trackLineColor;
     float trackLineWidth;
     
+    // Track-space position of the simulation's local origin (see
+    // WorldOrigin). Stored data stays in track space; the queries below
+    // take and return positions relative to this.
+    Vector3 origin;
+    
 public:
     Track();
     Track(float radius, float width, int resolution);
+    explicit Track(const std::string& path);  // Generates the default track if loading fails
     
     // Track generation
     void generateCircularTrack(float radius, float width, int resolution);
@@ -59,9 +188,21 @@ public:
     void generateCustomTrack(const std::vector<Vector3>& controlPoints, float width, int resolution);
     void generateRandomTrack(float radius, float width, int resolution, float complexity);
     
+    // Floating origin. Positions passed to and returned from the queries
+    // are relative to it; the raw arrays (points, checkpoints, vertices,
+    // control points) and the editing calls stay in track space, so
+    // subtract getOrigin() from those. It is a WorldOrigin cell corner,
+    // so around the focus the subtraction is exact.
+    void setOrigin(const Vector3& trackSpaceOrigin) { origin = trackSpaceOrigin; }
+    Vector3 getOrigin() const { return origin; }
+    
     // Track queries
     TrackPoint getTrackPoint(float t) const;
     TrackPoint getTrackPointAtDistance(float distance) const;
+    
+    // Starting grid behind the start line, 'columns' abreast with slot 0 on
+    // pole. The point is moved across the track to the slot's position.
+    TrackPoint getGridSlot(int slot, int columns = 2) const;
     Vector3 getTrackPosition(float t) const;
     Vector3 getTrackTangent(float t) const;
     Vector3 getTrackNormal(float t) const;
@@ -74,25 +215,51 @@ public:
     float getTrackLength() const { return trackLength; }
     float getDistanceAlongTrack(const Vector3& position) const;
     float getParameterFromDistance(float distance) const;
+    float getDistanceFromParameter(float t) const;
     float getParameterFromPosition(const Vector3& position) const;
     
-    // Checkpoint system
+    // Nearest point on track. Pass the segment from the previous query to
+    // warm-start; it falls back to the grid once the hint walks off the road.
+    TrackProjection getTrackProjection(const Vector3& localPosition, int segmentHint = -1) const;
+    
+    // Checkpoint gates; per-car progress lives in RaceProgress
     void generateCheckpoints(int numCheckpoints);
-    bool checkCheckpoint(const Vector3& position, float radius);
-    int getCurrentLap() const { return currentLap; }
-    int getCurrentCheckpoint() const { return currentCheckpoint; }
-    void resetLapProgress();
+    ArrayView<Checkpoint> getCheckpoints() const { return checkpoints; }
     
     // Track geometry
     void generateTrackGeometry();
-    const std::vector<Vector3>& getTrackVertices() const { return trackVertices; }
-    const std::vector<Vector3>& getTrackNormals() const { return trackNormals; }
-    const std::vector<Vector3>& getTrackUVs() const { return trackUVs; }
-    const std::vector<unsigned int>& getTrackIndices() const { return trackIndices; }
+    ArrayView<Vector3> getControlPoints() const { return controlPoints; }
+    ArrayView<TrackPoint> getTrackPoints() const { return trackPoints; }
+    ArrayView<TrackVertex> getTrackVertices() const { return trackVertices; }
+    ArrayView<unsigned int> getTrackIndices() const { return trackIndices; }
+    uint32_t getGeometryVersion() const { return geometryVersion; }
+    uint32_t getLayoutVersion() const { return layoutVersion; }
+    GeometryRange consumeDirtyGeometry();
+    
+    // Frozen copy for readers on other threads (see Snapshot)
+    std::shared_ptr<const Snapshot> createSnapshot() const;
+    
+    // Precompiled tracks (see TrackFormat.h). Loading maps the file and
+    // reads it in place; editing a loaded track copies it into memory first.
+    bool saveBinary(const std::string& path) const;
+    bool loadBinary(const std::string& path);
+    bool isMapped() const { return mappedFile != nullptr; }
     
     // Track properties
     void setTrackWidth(float width);
     void setBankingAmount(float banking);
+    
+    // Editing. Spans run forward from 'fromDistance' to 'toDistance' and
+    // may wrap past the start line. Only affected track points, checkpoints
+    // and vertices are rewritten in place, never reallocated.
+    // setControlPoint changes the track length, so it rewrites the samples
+    // on the reshaped arc while the drift that leaves elsewhere stays small,
+    // and every sample otherwise; the segment grid is rebuilt (reusing its
+    // buffers) only when a moved segment changes cells.
+    void setTrackWidth(float width, float fromDistance, float toDistance);
+    void setBankingAmount(float banking, float fromDistance, float toDistance);
+    void setControlPoint(int index, const Vector3& position);
+    void setSurfaceMaterial(SurfaceMaterial surface, float fromDistance, float toDistance);
     void setTrackColor(const Vector3& color);
     void setTrackLineColor(const Vector3& color);
     void setTrackLineWidth(float width);
@@ -106,6 +273,25 @@ public:
     void debugDraw() const;
     
 private:
+    void bindStorage();
+    void detachFromFile();
+    static bool hasValidContents(const unsigned char* base, const TrackFormat::Header& header);
+    void buildSpline(const std::vector<Vector3>& points);
+    void buildSplineSegment(int index);
+    void buildArcLengthTables();
+    void sampleTrackPoints(int resolution);
+    void updateTrackPointFrames();
+    void updateTrackPointFrame(TrackPoint& point, float t) const;
+    bool resampleEditedSpan(float oldStart, float oldEnd, float oldLength);
+    void getPointSpan(float fromDistance, float toDistance, int& first, int& count) const;
+    void refreshCheckpoints(float fromDistance, float toDistance);
+    void writeTrackVertices(int first, int count);
+    void getSampleSpan(float t, int& index, int& next, float& fraction) const;
+    TrackPoint evaluateTrackPoint(float t) const;  // In track space
+    void buildSegmentGrid();
+    void getSegmentCells(const Vector3& a, const Vector3& b, int range[4]) const;  // Clamped x0, x1, z0, z1
+    float projectOntoSegment(const Vector3& position, int segment, float& segmentT) const;
+    void evaluateSpline(float t, Vector3& position, Vector3& velocity, Vector3& acceleration) const;
     void calculateTrackProperties();
     void calculateTrackNormals();
     void calculateTrackBanking();
@@ -0,0 +1,64 @@
+#pragma once
+#include <cstdint>
+
+// Interleaved track vertex; the layout the renderer uploads as-is
+struct TrackVertex {
+    float position[3];
+    float normal[3];
+    float uv[2];
+};
+
+// On-disk layout of precompiled tracks (.trk).
+// A file is a Header followed by 16-byte aligned sections. Each section is a
+// raw array in the engine's in-memory layout, so a loaded Track reads
+// straight out of the mapped file. The version and the per-section element
+// sizes reject files written by a build with different struct layouts.
+namespace TrackFormat {
+    constexpr uint32_t Magic = 0x314B5254;  // "TRK1", little-endian
+    constexpr uint32_t Version = 3;  // 3: index buffer closes the loop
+    constexpr uint64_t SectionAlignment = 16;
+
+    enum Section : uint32_t {
+        ControlPoints,
+        SplineSegments,
+        ParameterToDistance,
+        DistanceToParameter,
+        TrackPoints,
+        Checkpoints,
+        GridCells,
+        GridSegments,
+        Vertices,
+        Indices,
+        SectionCount
+    };
+
+    struct SectionEntry {
+        uint64_t offset;
+        uint64_t count;
+        uint32_t elementSize;
+        uint32_t reserved;
+    };
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t headerSize;
+        uint32_t sectionCount;
+
+        // Track properties
+        float trackLength;
+        float trackWidth;
+        float bankingAmount;
+        int32_t resolution;
+
+        // Segment grid
+        float gridMinX;
+        float gridMinZ;
+        float gridCellSize;
+        int32_t gridWidth;
+        int32_t gridDepth;
+        uint32_t reserved;
+
+        SectionEntry sections[SectionCount];
+    };
+}
@@ -0,0 +1,377 @@
+#include "TrackStreamer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    void shiftChunk(TrackStreamer::Chunk& chunk, const Vector3& shift) {
+        for (Track::TrackPoint& point : chunk.points) {
+            point.position -= shift;
+        }
+        for (TrackVertex& vertex : chunk.vertices) {
+            vertex.position[0] -= shift.x;
+            vertex.position[1] -= shift.y;
+            vertex.position[2] -= shift.z;
+        }
+    }
+}
+
+size_t TrackStreamer::Chunk::getMemoryUsage() const {
+    return sizeof(Chunk)
+        + points.capacity() * sizeof(Track::TrackPoint)
+        + vertices.capacity() * sizeof(TrackVertex)
+        + indices.capacity() * sizeof(unsigned int);
+}
+
+TrackStreamer::TrackStreamer(const Track& track, float chunkLength, size_t memoryCeiling)
+    : track(track)
+    , chunkLength(std::max(1.0f, chunkLength))
+    , chunkCount(1)
+    , memoryCeiling(memoryCeiling)
+    , lookAhead(this->chunkLength * 2.0f)
+    , lookBehind(this->chunkLength)
+    , residentBytes(0)
+    , evictions(0)
+    , misses(0)
+    , origin(track.getOrigin())
+    , loadsCompleted(0)
+    , totalLoadMs(0.0)
+    , lastLoadMs(0.0f)
+    , maxLoadMs(0.0f)
+    , snapshot(track.createSnapshot())
+    , stopping(false) {
+
+    chunkCount = std::max(1, (int)std::ceil(snapshot->trackLength / this->chunkLength));
+    chunks.resize(chunkCount);
+    states.assign(chunkCount, ChunkState::Unloaded);
+    chunkVersions.assign(chunkCount, 0);
+    wanted.assign(chunkCount, 0);
+
+    worker = std::thread(&TrackStreamer::workerLoop, this);
+}
+
+TrackStreamer::~TrackStreamer() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueSignal.notify_all();
+
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+void TrackStreamer::update(float furthestAhead, float furthestBehind) {
+    loadedThisUpdate.clear();
+    evictedThisUpdate.clear();
+
+    syncSnapshot();
+    uint32_t version = snapshot->geometryVersion;
+
+    // Hand finished loads over; only pointers move under the lock
+    std::vector<Completion> finished;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        finished.swap(completions);
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    for (Completion& completion : finished) {
+        int index = completion.chunk->index;
+
+        // Loaded from a snapshot an edit has since replaced; requested
+        // again below if still wanted
+        if (completion.version != version) {
+            states[index] = states[index] == ChunkState::Reloading ? ChunkState::Resident : ChunkState::Unloaded;
+            continue;
+        }
+
+        float loadMs = std::chrono::duration<float, std::milli>(now - completion.requested).count();
+        loadsCompleted++;
+        totalLoadMs += loadMs;
+        lastLoadMs = loadMs;
+        maxLoadMs = std::max(maxLoadMs, loadMs);
+
+        // Loaded in track space; from here on chunks are local
+        shiftChunk(*completion.chunk, origin);
+        if (states[index] == ChunkState::Reloading) {
+            residentBytes -= chunks[index]->getMemoryUsage();
+        }
+        residentBytes += completion.chunk->getMemoryUsage();
+        chunks[index] = std::move(completion.chunk);
+        states[index] = ChunkState::Resident;
+        chunkVersions[index] = version;
+        loadedThisUpdate.push_back(index);
+    }
+
+    // Mark what the field needs: where cars are, then ahead, then behind,
+    // which is also the order loads are queued in
+    std::fill(wanted.begin(), wanted.end(), 0);
+    std::vector<int> newRequests;
+    auto requestWindow = [&](float from, float to) {
+        size_t first = newRequests.size();
+        markWindow(from, to);
+        for (int i = 0; i < chunkCount; i++) {
+            if (!wanted[i]) continue;
+
+            if (states[i] == ChunkState::Unloaded) {
+                states[i] = ChunkState::Pending;
+                newRequests.push_back(i);
+            } else if (states[i] == ChunkState::Resident && chunkVersions[i] != version) {
+                states[i] = ChunkState::Reloading;
+                newRequests.push_back(i);
+            }
+        }
+
+        // Within a window, load in driving order
+        std::sort(newRequests.begin() + first, newRequests.end(), [&](int a, int b) {
+            float length = snapshot->trackLength;
+            float da = std::fmod(a * chunkLength - from, length);
+            float db = std::fmod(b * chunkLength - from, length);
+            if (da < 0.0f) da += length;
+            if (db < 0.0f) db += length;
+            return da < db;
+        });
+    };
+    requestWindow(furthestBehind, furthestAhead);
+    requestWindow(furthestAhead, furthestAhead + lookAhead);
+    requestWindow(furthestBehind - lookBehind, furthestBehind);
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+
+        // Drop queued loads the field has moved away from
+        for (auto it = requests.begin(); it != requests.end();) {
+            if (!wanted[it->index]) {
+                ChunkState& state = states[it->index];
+                state = state == ChunkState::Reloading ? ChunkState::Resident : ChunkState::Unloaded;
+                it = requests.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        for (int index : newRequests) {
+            requests.push_back({ index, now });
+        }
+    }
+    if (!newRequests.empty()) {
+        queueSignal.notify_one();
+    }
+
+    // Out-of-date chunks the field doesn't need aren't worth reloading
+    for (int i = 0; i < chunkCount; i++) {
+        if (states[i] == ChunkState::Resident && !wanted[i] && chunkVersions[i] != version) {
+            evictChunk(i);
+        }
+    }
+
+    evictToCeiling(furthestAhead, furthestBehind);
+}
+
+void TrackStreamer::shiftOrigin(const Vector3& shift) {
+    origin += shift;
+    for (int i = 0; i < chunkCount; i++) {
+        if (states[i] == ChunkState::Resident || states[i] == ChunkState::Reloading) {
+            shiftChunk(*chunks[i], shift);
+        }
+    }
+}
+
+const TrackStreamer::Chunk* TrackStreamer::getChunk(int index) const {
+    if (index < 0 || index >= chunkCount) return nullptr;
+
+    if (states[index] != ChunkState::Resident && states[index] != ChunkState::Reloading) {
+        if (wanted[index]) {
+            misses++;
+        }
+        return nullptr;
+    }
+    return chunks[index].get();
+}
+
+const TrackStreamer::Chunk* TrackStreamer::getChunkAtDistance(float distance) const {
+    return getChunk(getChunkIndex(distance));
+}
+
+int TrackStreamer::getChunkIndex(float distance) const {
+    float length = snapshot->trackLength;
+    if (length <= 0.0f) return 0;
+
+    distance = std::fmod(distance, length);
+    if (distance < 0.0f) distance += length;
+    return std::min(chunkCount - 1, (int)(distance / chunkLength));
+}
+
+TrackStreamer::Stats TrackStreamer::getStats() const {
+    Stats stats;
+    stats.chunkCount = chunkCount;
+    stats.residentChunks = 0;
+    stats.pendingChunks = 0;
+    for (ChunkState state : states) {
+        if (state == ChunkState::Resident || state == ChunkState::Reloading) stats.residentChunks++;
+        if (state == ChunkState::Pending || state == ChunkState::Reloading) stats.pendingChunks++;
+    }
+    stats.residentBytes = residentBytes;
+    stats.memoryCeiling = memoryCeiling;
+    stats.loadsCompleted = loadsCompleted;
+    stats.evictions = evictions;
+    stats.misses = misses;
+    stats.lastLoadMs = lastLoadMs;
+    stats.averageLoadMs = loadsCompleted > 0 ? (float)(totalLoadMs / loadsCompleted) : 0.0f;
+    stats.maxLoadMs = maxLoadMs;
+    return stats;
+}
+
+void TrackStreamer::syncSnapshot() {
+    if (track.getGeometryVersion() == snapshot->geometryVersion) return;
+
+    // Taken here on the main thread, between edits. The old one is freed
+    // outside the lock, or by the worker if it is still loading from it.
+    std::shared_ptr<const Track::Snapshot> latest = track.createSnapshot();
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        snapshot.swap(latest);
+    }
+}
+
+void TrackStreamer::workerLoop() {
+    while (true) {
+        Request request;
+        std::shared_ptr<const Track::Snapshot> source;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueSignal.wait(lock, [this] { return stopping || !requests.empty(); });
+            if (stopping) return;
+
+            request = requests.front();
+            requests.pop_front();
+            source = snapshot;
+        }
+
+        std::unique_ptr<Chunk> chunk = loadChunk(request.index, *source);
+
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            completions.push_back({ std::move(chunk), source->geometryVersion, request.requested });
+        }
+    }
+}
+
+std::unique_ptr<TrackStreamer::Chunk> TrackStreamer::loadChunk(int index, const Track::Snapshot& source) const {
+    // Edits may have changed the length since the chunks were laid out;
+    // the last chunk takes up the difference
+    float length = source.trackLength;
+    std::unique_ptr<Chunk> chunk = std::make_unique<Chunk>();
+    chunk->index = index;
+    chunk->startDistance = std::min(length, index * chunkLength);
+    chunk->endDistance = index == chunkCount - 1 ? length : std::min(length, (index + 1) * chunkLength);
+    chunk->firstPoint = 0;
+
+    int count = source.pointCount;
+    if (count < 2) return chunk;
+
+    // One point of overlap so neighbouring chunks share an edge
+    float spacing = length / count;
+    int first = std::min(count - 1, (int)(chunk->startDistance / spacing));
+    int last = std::min(count - 1, (int)std::ceil(chunk->endDistance / spacing));
+
+    chunk->firstPoint = first;
+    chunk->points.reserve(last - first + 2);
+    for (int i = first; i <= last; i++) {
+        chunk->points.push_back(source.getPoint(i));
+    }
+
+    // The last chunk also carries the segment that closes the loop, with
+    // the first point appended as its far edge
+    bool closesLoop = last == count - 1 && chunk->endDistance >= length;
+    if (closesLoop) {
+        chunk->points.push_back(source.getPoint(0));
+    }
+
+    // Track geometry is two vertices per point and six indices per segment
+    if (source.hasGeometry) {
+        chunk->vertices.reserve((last - first + 2) * 2);
+        for (int i = first * 2; i < (last + 1) * 2; i++) {
+            chunk->vertices.push_back(source.getVertex(i));
+        }
+
+        unsigned int base = first * 2;
+        chunk->indices.reserve((last - first + (closesLoop ? 1 : 0)) * 6);
+        for (int i = first * 6; i < last * 6; i++) {
+            chunk->indices.push_back(source.getIndex(i) - base);
+        }
+
+        if (closesLoop) {
+            chunk->vertices.push_back(source.getVertex(0));
+            chunk->vertices.push_back(source.getVertex(1));
+
+            unsigned int end = (last - first) * 2;
+            unsigned int wrap = end + 2;
+            const unsigned int quad[6] = { end, wrap, end + 1, end + 1, wrap, wrap + 1 };
+            chunk->indices.insert(chunk->indices.end(), quad, quad + 6);
+        }
+    }
+
+    return chunk;
+}
+
+void TrackStreamer::markWindow(float from, float to) {
+    float length = snapshot->trackLength;
+    if (to - from >= length) {
+        std::fill(wanted.begin(), wanted.end(), 1);
+        return;
+    }
+
+    // Walk chunk indices rather than distances: the last chunk is usually
+    // shorter than the rest, and stepping a window across the start line
+    // by chunkLength would skip it
+    int first = getChunkIndex(from);
+    int last = getChunkIndex(to);
+    if (first == last && to - from > chunkLength) {
+        std::fill(wanted.begin(), wanted.end(), 1);
+        return;
+    }
+
+    for (int i = first;; i = (i + 1) % chunkCount) {
+        wanted[i] = 1;
+        if (i == last) break;
+    }
+}
+
+void TrackStreamer::evictToCeiling(float furthestAhead, float furthestBehind) {
+    while (residentBytes > memoryCeiling) {
+        // Furthest unneeded chunk goes first; needed chunks are never evicted
+        int victim = -1;
+        float victimDistance = -1.0f;
+        for (int i = 0; i < chunkCount; i++) {
+            if (states[i] != ChunkState::Resident || wanted[i]) continue;
+
+            float distance = distanceToWindow(i, furthestAhead, furthestBehind);
+            if (distance > victimDistance) {
+                victim = i;
+                victimDistance = distance;
+            }
+        }
+        if (victim < 0) break;
+
+        evictChunk(victim);
+    }
+}
+
+void TrackStreamer::evictChunk(int index) {
+    residentBytes -= chunks[index]->getMemoryUsage();
+    chunks[index].reset();
+    states[index] = ChunkState::Unloaded;
+    evictions++;
+    evictedThisUpdate.push_back(index);
+}
+
+float TrackStreamer::distanceToWindow(int index, float furthestAhead, float furthestBehind) const {
+    float length = snapshot->trackLength;
+    float center = (index + 0.5f) * chunkLength;
+
+    float toAhead = std::fabs(std::remainder(center - furthestAhead, length));
+    float toBehind = std::fabs(std::remainder(center - furthestBehind, length));
+    return std::min(toAhead, toBehind);
+}
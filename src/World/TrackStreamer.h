@@ -0,0 +1,157 @@
+#pragma once
+#include "Track.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Streams a long track in chunks keyed by distance along the track.
+// Chunks covering the field (furthest-behind to furthest-ahead car, plus
+// margins) are loaded on a background I/O thread. For a memory-mapped track
+// that is where the pages are faulted in. Finished chunks are handed over
+// in update(), and lookups never block. Chunks outside the window are
+// evicted when the resident set exceeds the memory ceiling.
+//
+// The ceiling covers the chunk copies, which are what the renderer and the
+// ground query build from (see getLoadedChunks). It does not cover the
+// track: a loaded track's arrays are a read-only mapping the OS pages in
+// and out, and a generated track is held in memory as the editable source.
+//
+// Resident chunks are local to the track's origin: loads happen in track
+// space and are moved at handover, and shiftOrigin moves the resident set.
+//
+// The I/O thread never reads the track itself, only an immutable snapshot
+// of it (Track::Snapshot) handed over under the queue lock, so the track
+// may be edited while it streams. update() takes a new snapshot when the
+// geometry version changes, which shares the blocks the edit didn't touch
+// with the last one, and reloads the chunks the field needs; the old
+// copies stay resident until their replacements arrive. The chunk count is
+// fixed at creation and the last chunk absorbs length changes, so recreate
+// the streamer when the track is regenerated or replaced. The track must
+// outlive the streamer.
+class TrackStreamer {
+public:
+    struct Chunk {
+        int index;
+        float startDistance;
+        float endDistance;
+        int firstPoint;  // Track point index of points[0]; the last chunk wraps round to point 0
+        std::vector<Track::TrackPoint> points;
+        std::vector<TrackVertex> vertices;
+        std::vector<unsigned int> indices;  // Relative to this chunk's vertices
+
+        size_t getMemoryUsage() const;
+    };
+
+    struct Stats {
+        int chunkCount;
+        int residentChunks;
+        int pendingChunks;
+        size_t residentBytes;
+        size_t memoryCeiling;
+        int loadsCompleted;
+        int evictions;
+        int misses;  // Lookups of in-window chunks that weren't resident yet
+        float lastLoadMs;
+        float averageLoadMs;
+        float maxLoadMs;
+    };
+
+private:
+    enum class ChunkState : uint8_t {
+        Unloaded,
+        Pending,
+        Resident,
+        Reloading  // Resident, with a load from a newer snapshot queued
+    };
+
+    const Track& track;
+    float chunkLength;
+    int chunkCount;
+    size_t memoryCeiling;
+    float lookAhead;
+    float lookBehind;
+
+    // Main-thread state
+    std::vector<std::unique_ptr<Chunk>> chunks;
+    std::vector<ChunkState> states;
+    std::vector<uint32_t> chunkVersions;  // Snapshot each resident chunk was loaded from
+    std::vector<uint8_t> wanted;
+    std::vector<int> loadedThisUpdate;
+    std::vector<int> evictedThisUpdate;
+    size_t residentBytes;
+    int evictions;
+    mutable int misses;
+    Vector3 origin;  // Track-space origin the resident chunks are relative to
+
+    // Load latency (request to handover), in milliseconds
+    int loadsCompleted;
+    double totalLoadMs;
+    float lastLoadMs;
+    float maxLoadMs;
+
+    // Shared with the I/O thread
+    struct Request {
+        int index;
+        std::chrono::steady_clock::time_point requested;
+    };
+    struct Completion {
+        std::unique_ptr<Chunk> chunk;
+        uint32_t version;  // Of the snapshot it was loaded from
+        std::chrono::steady_clock::time_point requested;
+    };
+    std::shared_ptr<const Track::Snapshot> snapshot;  // Replaced under queueMutex, only by the main thread
+    std::mutex queueMutex;
+    std::condition_variable queueSignal;
+    std::deque<Request> requests;
+    std::vector<Completion> completions;
+    std::atomic<bool> stopping;
+    std::thread worker;
+
+public:
+    TrackStreamer(const Track& track, float chunkLength = 250.0f, size_t memoryCeiling = 64 * 1024 * 1024);
+    ~TrackStreamer();
+
+    TrackStreamer(const TrackStreamer&) = delete;
+    TrackStreamer& operator=(const TrackStreamer&) = delete;
+
+    // Settings
+    void setMemoryCeiling(size_t bytes) { memoryCeiling = bytes; }
+    void setLookAhead(float ahead, float behind) { lookAhead = ahead; lookBehind = behind; }
+
+    // Call once per tick with race distances (they may exceed one lap)
+    void update(float furthestAhead, float furthestBehind);
+
+    // Floating origin: moves resident chunks by -shift, in step with the
+    // track's origin. Chunks already on the GPU keep their upload-time
+    // coordinates (see Renderer::setWorldOrigin).
+    void shiftOrigin(const Vector3& shift);
+
+    // Non-blocking lookups; nullptr until the chunk is resident
+    const Chunk* getChunk(int index) const;
+    const Chunk* getChunkAtDistance(float distance) const;
+    int getChunkIndex(float distance) const;
+    int getChunkCount() const { return chunkCount; }
+    float getChunkLength() const { return chunkLength; }
+
+    // Chunks that became resident / were evicted in the last update, so
+    // renderers and the ground query can build or release their copies
+    const std::vector<int>& getLoadedChunks() const { return loadedThisUpdate; }
+    const std::vector<int>& getEvictedChunks() const { return evictedThisUpdate; }
+
+    Stats getStats() const;
+
+private:
+    void workerLoop();
+    void syncSnapshot();
+    std::unique_ptr<Chunk> loadChunk(int index, const Track::Snapshot& source) const;
+    void markWindow(float from, float to);
+    void evictToCeiling(float furthestAhead, float furthestBehind);
+    void evictChunk(int index);
+    float distanceToWindow(int index, float furthestAhead, float furthestBehind) const;
+};
@@ -0,0 +1,56 @@
+#include "WorldOrigin.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // Whole powers of two keep every cell corner exact in float
+    float powerOfTwoAtLeastOne(float size) {
+        return std::exp2(std::round(std::log2(std::max(1.0f, size))));
+    }
+}
+
+WorldOrigin::WorldOrigin(float rebaseDistance, float cellSize)
+    : rebaseDistance(std::max(0.0f, rebaseDistance))
+    , cellSize(powerOfTwoAtLeastOne(cellSize))
+    , rebaseCount(0) {
+}
+
+void WorldOrigin::setRebaseDistance(float distance) {
+    rebaseDistance = std::max(0.0f, distance);
+}
+
+Vector3 WorldOrigin::getTrackSpaceOrigin() const {
+    return Vector3((float)origin.x, (float)origin.y, (float)origin.z);
+}
+
+Vector3 WorldOrigin::toLocal(const WorldPosition& position) const {
+    return Vector3((float)(position.x - origin.x), (float)(position.y - origin.y), (float)(position.z - origin.z));
+}
+
+WorldPosition WorldOrigin::toWorld(const Vector3& local) const {
+    return WorldPosition(origin.x + local.x, origin.y + local.y, origin.z + local.z);
+}
+
+bool WorldOrigin::update(const Vector3& focus, Vector3& shift) {
+    if (rebaseDistance <= 0.0f || focus.lengthSquared() <= rebaseDistance * rebaseDistance) {
+        return false;
+    }
+
+    // Under half a cell out the nearest corner is still this one
+    shift = moveTo(toWorld(focus));
+    return shift.x != 0.0f || shift.y != 0.0f || shift.z != 0.0f;
+}
+
+Vector3 WorldOrigin::moveTo(const WorldPosition& position) {
+    WorldPosition target(snap(position.x), snap(position.y), snap(position.z));
+    Vector3 shift((float)(target.x - origin.x), (float)(target.y - origin.y), (float)(target.z - origin.z));
+    if (shift.x != 0.0f || shift.y != 0.0f || shift.z != 0.0f) {
+        origin = target;
+        rebaseCount++;
+    }
+    return shift;
+}
+
+double WorldOrigin::snap(double value) const {
+    return std::round(value / cellSize) * cellSize;
+}
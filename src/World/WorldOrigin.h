@@ -0,0 +1,66 @@
+#pragma once
+#include "../Math/Vector3.h"
+
+// A position anywhere in the world, at double precision (sub-micrometre
+// out to thousands of kilometres). World coordinates are the track's.
+// For anything that must outlive a rebase or leave the local frame:
+// saves, replication, streaming keys.
+struct WorldPosition {
+    double x, y, z;
+
+    constexpr WorldPosition() : x(0.0), y(0.0), z(0.0) {}
+    constexpr WorldPosition(double x, double y, double z) : x(x), y(y), z(z) {}
+};
+
+// Floating origin for large worlds.
+// Simulation and rendering run in floats relative to a local origin kept
+// near the focus (the player's car, or the local player in PvP). Once the
+// focus drifts past the rebase distance the origin jumps to the cell
+// corner nearest it, and the caller moves everything it owns by the
+// returned shift in one pass between ticks. Floats then never hold
+// coordinates much larger than the rebase distance, wherever on the map
+// the action is.
+//
+// The origin only moves in whole cells (a power of two in metres), so
+// shifts and the track-space origin are exact in float, and subtracting
+// a shift from positions near the focus loses nothing.
+class WorldOrigin {
+public:
+    static constexpr float DefaultRebaseDistance = 1024.0f;
+    static constexpr float DefaultCellSize = 256.0f;
+
+private:
+    WorldPosition origin;
+    float rebaseDistance;
+    float cellSize;
+    int rebaseCount;
+
+public:
+    explicit WorldOrigin(float rebaseDistance = DefaultRebaseDistance, float cellSize = DefaultCellSize);
+
+    // 0 disables rebasing
+    void setRebaseDistance(float distance);
+    float getRebaseDistance() const { return rebaseDistance; }
+    float getCellSize() const { return cellSize; }
+
+    const WorldPosition& getOrigin() const { return origin; }
+    // The origin in the track's float coordinates (see Track::setOrigin)
+    Vector3 getTrackSpaceOrigin() const;
+    int getRebaseCount() const { return rebaseCount; }
+
+    Vector3 toLocal(const WorldPosition& position) const;
+    WorldPosition toWorld(const Vector3& local) const;
+
+    // Recentres on the cell corner nearest 'focus' (a local position) when
+    // it is further than the rebase distance from the origin. Returns true
+    // with the shift to subtract from every local position if it moved.
+    bool update(const Vector3& focus, Vector3& shift);
+
+    // Moves the origin to the cell corner nearest 'position' and returns
+    // the shift
+    Vector3 moveTo(const WorldPosition& position);
+    Vector3 reset() { return moveTo(WorldPosition()); }
+
+private:
+    double snap(double value) const;
+};
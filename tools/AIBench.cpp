@@ -0,0 +1,334 @@
+// Headless AI benchmark.
+// Runs a field of AI cars round a track with physics, race progress and
+// the batched AI driver, but no window or renderer, and reports what the
+// AI costs per tick.
+//
+// Usage:
+//   AIBench [track.trk | --circle R] [--cars N] [--seconds S] [--width W]
+//           [--offset M] [--rebase D] [--check-rebase] [--hash-log FILE]
+//           [--check-hashes FILE]
+//
+// Without a track it drives a built-in circuit long enough to grid the field.
+// --offset moves that circuit M metres out along X and Z, where floats get
+// coarse; --rebase D turns on the floating origin, re-centred on the leader
+// whenever it gets D metres from the origin. --check-rebase runs the field
+// again without rebasing and fails if the leader's race distance differs
+// between the two runs by more than 5%.
+//
+// --hash-log writes the physics state hash after every tick, one per line.
+// --check-hashes runs again and compares against such a log, reporting the
+// first tick that differs. Log on one build or platform and check on
+// another to confirm a DETERMINISTIC_MATH build simulates the same bits.
+#include "AI/DriverAI.h"
+#include "Math/SimMath.h"
+#include "Physics/PhysicsEngine.h"
+#include "World/RaceProgress.h"
+#include "World/RacingLine.h"
+#include "World/Track.h"
+#include "World/WorldOrigin.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+    constexpr float TickRate = 60.0f;
+    constexpr int GridColumns = 4;
+
+    // Largest relative difference --check-rebase accepts in the leader's
+    // race distance
+    constexpr float RebaseTolerance = 0.05f;
+
+    void printUsage() {
+        std::cerr << "Usage: AIBench [track.trk | --circle R] [--cars N] [--seconds S] [--width W]"
+                  << " [--offset M] [--rebase D] [--check-rebase] [--hash-log FILE] [--check-hashes FILE]" << std::endl;
+    }
+
+    bool loadHashes(const std::string& path, std::vector<uint64_t>& hashes) {
+        std::ifstream file(path);
+        if (!file) return false;
+
+        int tick;
+        std::string hash;
+        while (file >> tick >> hash) {
+            hashes.push_back(std::stoull(hash, nullptr, 16));
+        }
+        return true;
+    }
+
+    void buildDefaultTrack(Track& track, float width, float offset) {
+        // A mix of fast sweepers and tighter corners, about 4.5 km round
+        std::vector<Vector3> points = {
+            Vector3(0.0f, 0.0f, 0.0f),
+            Vector3(600.0f, 0.0f, 0.0f),
+            Vector3(900.0f, 0.0f, 250.0f),
+            Vector3(700.0f, 0.0f, 600.0f),
+            Vector3(300.0f, 0.0f, 450.0f),
+            Vector3(0.0f, 0.0f, 700.0f),
+            Vector3(-400.0f, 0.0f, 500.0f),
+            Vector3(-300.0f, 0.0f, 150.0f)
+        };
+        for (Vector3& point : points) {
+            point += Vector3(offset, 0.0f, offset);
+        }
+        track.generateCustomTrack(points, width, 4000);
+    }
+
+    struct FieldResult {
+        float leaderDistance;
+        float lastDistance;
+        float averageSpeed;
+        int offTrack;
+        double physicsMs;    // Per tick
+        double progressMs;   // Per tick
+        DriverAI::Stats aiStats;
+        int rebaseCount;
+        WorldPosition origin;
+        uint64_t stateHash;
+        int divergedTick;    // -1 if every tick matched 'expectedHashes'
+    };
+
+    // One run of the field from the grid. 'line' is taken by value: the
+    // run shifts it with the origin.
+    FieldResult runField(Track& track, RacingLine line, int carCount, float seconds, float rebaseDistance,
+                         std::ofstream* hashLog, const std::vector<uint64_t>& expectedHashes) {
+        track.setOrigin(Vector3::zero());
+
+        // Field on the grid, facing down the track
+        PhysicsEngine physics;
+        physics.getGroundQuery().buildFromTrack(track);
+
+        std::vector<std::unique_ptr<Car>> cars;
+        std::vector<RaceProgress> progress;
+        for (int i = 0; i < carCount; i++) {
+            Track::TrackPoint slot = track.getGridSlot(i, GridColumns);
+            auto car = std::make_unique<Car>(slot.position);
+            car->setRotation(Quaternion::fromAxisAngle(Vector3::up(), SimMath::atan2(-slot.tangent.x, -slot.tangent.z)));
+            physics.addCar(car.get());
+            cars.push_back(std::move(car));
+            progress.emplace_back(1000);
+        }
+
+        RaceStandings standings;
+        DriverAI driverAI;
+
+        // Everything the benchmark keeps positions in moves in one pass
+        WorldOrigin worldOrigin(rebaseDistance);
+        auto updateOrigin = [&](const Vector3& focus) {
+            Vector3 shift;
+            if (!worldOrigin.update(focus, shift)) return;
+
+            track.setOrigin(worldOrigin.getTrackSpaceOrigin());
+            physics.shiftOrigin(shift);
+            line.shiftOrigin(shift);
+            for (RaceProgress& carProgress : progress) {
+                carProgress.shiftOrigin(shift);
+            }
+        };
+        updateOrigin(cars[0]->getPosition());
+
+        float deltaTime = 1.0f / TickRate;
+        int ticks = (int)(seconds * TickRate);
+        FieldResult result;
+        result.physicsMs = 0.0;
+        result.progressMs = 0.0;
+        result.divergedTick = -1;
+
+        for (int tick = 0; tick < ticks; tick++) {
+            auto physicsStart = std::chrono::steady_clock::now();
+            physics.update(deltaTime);
+            auto progressStart = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < cars.size(); i++) {
+                progress[i].update(track, cars[i]->getPosition(), deltaTime);
+            }
+            standings.update(progress);
+            auto progressEnd = std::chrono::steady_clock::now();
+
+            driverAI.update(line, cars, progress, nullptr);
+
+            result.physicsMs += std::chrono::duration<double, std::milli>(progressStart - physicsStart).count();
+            result.progressMs += std::chrono::duration<double, std::milli>(progressEnd - progressStart).count();
+
+            if (hashLog != nullptr || !expectedHashes.empty()) {
+                uint64_t hash = physics.computeStateHash();
+                if (hashLog != nullptr) {
+                    *hashLog << tick << " " << std::hex << hash << std::dec << "\n";
+                }
+                if (result.divergedTick < 0 && tick < (int)expectedHashes.size() && hash != expectedHashes[tick]) {
+                    result.divergedTick = tick;
+                }
+            }
+
+            updateOrigin(cars[standings.getLeader()]->getPosition());
+        }
+        result.physicsMs /= ticks;
+        result.progressMs /= ticks;
+
+        // How the field got on: distance covered and who left the road
+        result.leaderDistance = progress[standings.getLeader()].getRaceDistance();
+        result.lastDistance = progress[standings.getOrder().back()].getRaceDistance();
+        result.averageSpeed = 0.0f;
+        result.offTrack = 0;
+        for (size_t i = 0; i < cars.size(); i++) {
+            result.averageSpeed += cars[i]->getSpeed();
+            Track::TrackProjection projection = track.getTrackProjection(cars[i]->getPosition(), progress[i].getSegment());
+            Track::TrackPoint point = track.getTrackPointAtDistance(projection.distanceAlongTrack);
+            if (projection.distanceToTrack > point.width * 0.5f) {
+                result.offTrack++;
+            }
+        }
+        result.averageSpeed /= cars.size();
+
+        result.aiStats = driverAI.getStats();
+        result.rebaseCount = worldOrigin.getRebaseCount();
+        result.origin = worldOrigin.getOrigin();
+        result.stateHash = physics.computeStateHash();
+        return result;
+    }
+
+    // Relative difference, against the larger magnitude
+    float relativeDifference(float a, float b) {
+        float scale = std::max(std::fabs(a), std::fabs(b));
+        return scale > 0.0f ? std::fabs(a - b) / scale : 0.0f;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string source;
+    float circleRadius = 0.0f;
+    float width = 20.0f;
+    int carCount = 500;
+    float seconds = 60.0f;
+    float offset = 0.0f;
+    float rebaseDistance = 0.0f;
+    bool checkRebase = false;
+    std::string hashLogPath;
+    std::string checkHashesPath;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--circle" && hasValue) {
+            source = arg;
+            circleRadius = std::stof(argv[++i]);
+        } else if (arg == "--cars" && hasValue) {
+            carCount = std::stoi(argv[++i]);
+        } else if (arg == "--seconds" && hasValue) {
+            seconds = std::stof(argv[++i]);
+        } else if (arg == "--width" && hasValue) {
+            width = std::stof(argv[++i]);
+        } else if (arg == "--offset" && hasValue) {
+            offset = std::stof(argv[++i]);
+        } else if (arg == "--rebase" && hasValue) {
+            rebaseDistance = std::stof(argv[++i]);
+        } else if (arg == "--check-rebase") {
+            checkRebase = true;
+        } else if (arg == "--hash-log" && hasValue) {
+            hashLogPath = argv[++i];
+        } else if (arg == "--check-hashes" && hasValue) {
+            checkHashesPath = argv[++i];
+        } else if (source.empty()) {
+            source = arg;
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (carCount < 1 || seconds <= 0.0f || rebaseDistance < 0.0f || (checkRebase && rebaseDistance == 0.0f)) {
+        printUsage();
+        return 1;
+    }
+
+    Track track;
+    if (source == "--circle") {
+        track.generateCircularTrack(circleRadius, width, 2000);
+    } else if (!source.empty()) {
+        if (!track.loadBinary(source)) {
+            std::cerr << "Failed to load " << source << std::endl;
+            return 1;
+        }
+    } else {
+        buildDefaultTrack(track, width, offset);
+    }
+
+    std::ofstream hashLog;
+    if (!hashLogPath.empty()) {
+        hashLog.open(hashLogPath);
+        if (!hashLog) {
+            std::cerr << "Failed to open " << hashLogPath << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<uint64_t> expectedHashes;
+    if (!checkHashesPath.empty() && !loadHashes(checkHashesPath, expectedHashes)) {
+        std::cerr << "Failed to load " << checkHashesPath << std::endl;
+        return 1;
+    }
+
+    auto lineStart = std::chrono::steady_clock::now();
+    RacingLine line;
+    line.build(track);
+    std::chrono::duration<double, std::milli> lineTime = std::chrono::steady_clock::now() - lineStart;
+
+    FieldResult result = runField(track, line, carCount, seconds, rebaseDistance,
+                                  hashLog.is_open() ? &hashLog : nullptr, expectedHashes);
+
+    const DriverAI::Stats& stats = result.aiStats;
+    std::cout << "AI benchmark" << std::endl;
+    std::cout << "  Track length:   " << track.getTrackLength() << " m" << std::endl;
+    std::cout << "  Racing line:    " << lineTime.count() << " ms to solve, ideal lap "
+              << line.getIdealLapTime() << " s" << std::endl;
+    std::cout << "  Cars:           " << stats.cars << std::endl;
+    std::cout << "  Ticks:          " << stats.ticks << " (" << seconds << " s at " << TickRate << " Hz)" << std::endl;
+    std::cout << "  AI per tick:    " << stats.averageTickMs << " ms avg, " << stats.maxTickMs << " ms max, "
+              << stats.averageTickMs * 1000.0f / stats.cars << " us per car" << std::endl;
+    std::cout << "  Physics:        " << result.physicsMs << " ms per tick" << std::endl;
+    std::cout << "  Progress:       " << result.progressMs << " ms per tick" << std::endl;
+    std::cout << "  Distance:       " << result.leaderDistance << " m leader, " << result.lastDistance << " m last" << std::endl;
+    std::cout << "  Average speed:  " << result.averageSpeed << " m/s" << std::endl;
+    std::cout << "  Off track:      " << result.offTrack << std::endl;
+    if (rebaseDistance > 0.0f) {
+        std::cout << "  World origin:   " << result.rebaseCount << " rebases, now at ("
+                  << result.origin.x << ", " << result.origin.y << ", " << result.origin.z << ")" << std::endl;
+    }
+    std::cout << "  State hash:     " << std::hex << result.stateHash << std::dec << std::endl;
+
+    if (!checkHashesPath.empty()) {
+        int ticks = stats.ticks;
+        int compared = std::min(ticks, (int)expectedHashes.size());
+        if (result.divergedTick >= 0) {
+            std::cout << "  Determinism:    diverged from " << checkHashesPath << " at tick " << result.divergedTick << std::endl;
+            return 1;
+        }
+        if (compared < ticks) {
+            std::cout << "  Determinism:    " << checkHashesPath << " has only " << compared << " of "
+                      << ticks << " ticks" << std::endl;
+            return 1;
+        }
+        std::cout << "  Determinism:    all " << compared << " ticks match " << checkHashesPath << std::endl;
+    }
+
+    // Rebasing must not change how the field drives. Cars interact, so
+    // float differences grow over a run and the pack behind the leader
+    // sorts itself out differently; the leader's distance has to agree.
+    if (checkRebase) {
+        FieldResult fixed = runField(track, line, carCount, seconds, 0.0f, nullptr, std::vector<uint64_t>());
+        float difference = relativeDifference(result.leaderDistance, fixed.leaderDistance);
+        std::cout << "  Rebase check:   leader at " << fixed.leaderDistance << " m without rebasing, "
+                  << difference * 100.0f << "% apart" << std::endl;
+        if (difference > RebaseTolerance) {
+            std::cout << "  Rebase check:   over the " << RebaseTolerance * 100.0f << "% tolerance" << std::endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,56 @@
+// Struct layout report.
+// Prints the size, alignment and padding of the structs the simulation
+// walks every tick (Car, Player), every member's offset and cache line,
+// and how many lines the hot members (touched by every update) cover
+// against the fewest they could fit in. Run it after adding a member to
+// check it landed in the right block.
+//
+// Usage:
+//   LayoutReport
+#include "Combat/Player.h"
+#include "Physics/Car.h"
+#include "Utils/CacheLayout.h"
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace {
+    void printReport(const CacheLayout::Report& report) {
+        std::cout << report.getTypeName() << ": " << report.getSize() << " bytes, aligned to "
+                  << report.getAlignment() << ", " << report.getPaddingBytes() << " bytes padding" << std::endl;
+
+        for (const CacheLayout::Field& field : report.getFields()) {
+            size_t firstLine = field.offset / CacheLayout::LineSize;
+            size_t lastLine = (field.offset + field.size - 1) / CacheLayout::LineSize;
+            std::string span = std::to_string(firstLine);
+            if (lastLine != firstLine) {
+                span += "-" + std::to_string(lastLine);
+            }
+            std::cout << "  " << std::setw(5) << field.offset << "  " << std::setw(4) << field.size
+                      << "  line " << std::left << std::setw(5) << span << std::right
+                      << (field.hot ? "hot   " : "cold  ") << field.name << std::endl;
+        }
+
+        size_t lines = (report.getSize() + CacheLayout::LineSize - 1) / CacheLayout::LineSize;
+        std::cout << "  Hot: " << report.getHotBytes() << " bytes on " << report.getHotLines() << " of "
+                  << lines << " lines (fits in " << report.getMinimumHotLines() << ")" << std::endl;
+        if (report.getAlignment() < CacheLayout::LineSize) {
+            std::cout << "  Not line-aligned: an object can straddle one more line" << std::endl;
+        }
+        std::cout << std::endl;
+    }
+}
+
+int main() {
+    std::cout << "Cache line: " << CacheLayout::LineSize << " bytes" << std::endl << std::endl;
+
+    Car car;
+    printReport(car.describeLayout());
+
+    Player player(0, "Layout", Vector3::zero());
+    printReport(player.describeLayout());
+
+    std::cout << "Car::Wheel: " << sizeof(Car::Wheel) << " bytes, Car::Engine: " << sizeof(Car::Engine)
+              << " bytes, Player::Stats: " << sizeof(Player::Stats) << " bytes" << std::endl;
+    return 0;
+}
@@ -0,0 +1,710 @@
+// Math library microbenchmarks (Google Benchmark).
+// Covers the Vector3, Matrix4 and Quaternion hot paths, the SIMD products
+// against their *Scalar references, the FastMath approximations against
+// the exact functions, every TransformBatch kernel this CPU can run
+// against the same work done one element at a time, and the Quantize
+// batch conversions against their one-at-a-time versions.
+//
+// Usage:
+//   math_bench [Google Benchmark flags]
+//   math_bench --benchmark_out=math_bench.json --benchmark_out_format=json
+//
+// The math_bench_compare build target runs it and checks the results
+// against tools/baselines/math_bench.json with tools/bench_compare.py.
+#include "Math/FastMath.h"
+#include "Math/Matrix4.h"
+#include "Math/Quaternion.h"
+#include "Math/Quantize.h"
+#include "Math/TransformBatch.h"
+#include "Math/Vector3.h"
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    // Enough distinct inputs that nothing is constant-folded, few enough
+    // to stay in L1 so the numbers measure arithmetic, not memory
+    constexpr size_t InputCount = 256;
+    constexpr size_t InputMask = InputCount - 1;
+
+    struct Inputs {
+        std::vector<Vector3> vectors;
+        std::vector<Vector3> axes;
+        std::vector<Quaternion> rotations;
+        std::vector<Matrix4> matrices;
+        std::vector<Matrix4> affines;
+        std::vector<float> angles;
+        std::vector<float> cosines;
+        std::vector<float> positives;
+
+        Inputs() {
+            std::mt19937 random(12345);
+            std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+            for (size_t i = 0; i < InputCount; i++) {
+                vectors.push_back(Vector3(unit(random), unit(random), unit(random)) * 10.0f);
+                axes.push_back(vectors.back().normalized());
+
+                Quaternion q(unit(random), unit(random), unit(random), unit(random));
+                rotations.push_back(q.normalized());
+
+                Matrix4 general;
+                for (float& element : general.m) {
+                    element = unit(random);
+                }
+                general(0, 0) += 4.0f;  // Keep it comfortably invertible
+                general(1, 1) += 4.0f;
+                general(2, 2) += 4.0f;
+                general(3, 3) += 4.0f;
+                matrices.push_back(general);
+
+                Vector3 scale(1.5f + unit(random), 1.5f + unit(random), 1.5f + unit(random));
+                affines.push_back(Matrix4::translation(vectors.back()) * rotations.back().toMatrix4() * Matrix4::scale(scale));
+                angles.push_back(unit(random) * 3.14159265f);
+                cosines.push_back(unit(random));
+                positives.push_back(std::fabs(unit(random)) * 100.0f + 0.01f);
+            }
+        }
+    };
+
+    const Inputs& inputs() {
+        static const Inputs data;
+        return data;
+    }
+
+    // Vector3
+
+    void Vector3_Arithmetic(benchmark::State& state) {
+        const Inputs& in = inputs();
+        size_t i = 0;
+        for (auto _ : state) {
+            const Vector3& a = in.vectors[i & InputMask];
+            const Vector3& b = in.vectors[(i + 1) & InputMask];
+            Vector3 result = (a + b) * 0.5f - a.cross(b) * a.dot(b);
+            benchmark::DoNotOptimize(result);
+            i++;
+        }
+    }
+    BENCHMARK(Vector3_Arithmetic);
+
+    void Vector3_Normalized(benchmark::State& state) {
+        const Inputs& in = inputs();
+        size_t i = 0;
+        for (auto _ : state) {
+            Vector3 result = in.vectors[i & InputMask].normalized();
+            benchmark::DoNotOptimize(result);
+            i++;
+        }
+    }
+    BENCHMARK(Vector3_Normalized);
+
+    void Vector3_NormalizedFast(benchmark::State& state) {
+        const Inputs& in = inputs();
+        size_t i = 0;
+        for (auto _ : state) {
+            Vector3 result = in.vectors[i & InputMask].normalizedFast();
+            benchmark::DoNotOptimize(result);
+            i++;
+        }
+    }
+    BENCHMARK(Vector3_NormalizedFast);
+
+    // Chains as the gameplay code used to write them against the fused
+    // Vector3 helpers, over a whole array so the loop body's codegen shows
+
+    void Vector3_LerpChain(benchmark::State& state) {
+        const Inputs& in = inputs();
+        std::vector<Vector3> out(InputCount);
+        for (auto _ : state) {
+            for (size_t i = 0; i < InputCount; i++) {
+                float t = in.cosines[i] * 0.5f + 0.5f;
+                out[i] = in.vectors[i] * t + in.axes[i] * (1.0f - t);
+            }
+            benchmark::DoNotOptimize(out.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * InputCount);
+    }
+    BENCHMARK(Vector3_LerpChain);
+
+    void Vector3_Lerp(benchmark::State& state) {
+        const Inputs& in = inputs();
+        std::vector<Vector3> out(InputCount);
+        for (auto _ : state) {
+            for (size_t i = 0; i < InputCount; i++) {
+                float t = in.cosines[i] * 0.5f + 0.5f;
+                out[i] = Vector3::lerpUnclamped(in.axes[i], in.vectors[i], t);
+            }
+            benchmark::DoNotOptimize(out.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * InputCount);
+    }
+    BENCHMARK(Vector3_Lerp);
+
+    void Vector3_SteerChain(benchmark::State& state) {
+        const Inputs& in = inputs();
+        std::vector<Vector3> velocities(in.vectors);
+        for (auto _ : state) {
+            for (size_t i = 0; i < InputCount; i++) {
+                velocities[i] = velocities[i] + (in.axes[i] * 20.0f - velocities[i]) * 0.5f * (1.0f / 60.0f);
+            }
+            benchmark::DoNotOptimize(velocities.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * InputCount);
+    }
+    BENCHMARK(Vector3_SteerChain);
+
+    void Vector3_Steer(benchmark::State& state) {
+        const Inputs& in = inputs();
+        std::vector<Vector3> velocities(in.vectors);
+        for (auto _ : state) {
+            for (size_t i = 0; i < InputCount; i++) {
+                velocities[i] = Vector3::lerpUnclamped(velocities[i], in.axes[i] * 20.0f, 0.5f * (1.0f / 60.0f));
+            }
+            benchmark::DoNotOptimize(velocities.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * InputCount);
+    }
+    BENCHMARK(Vector3_Steer);
+
+    void Vector3_Madd(benchmark::State& state) {
+        const Inputs& in = inputs();
+        std::vector<Vector3> positions(in.vectors);
+        for (auto _ : state) {
+            for (size_t i = 0; i < InputCount; i++) {
+                positions[i] = Vector3::madd(positions[i], in.axes[i], 1.0f / 60.0f);
+            }
+            benchmark::DoNotOptimize(positions.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * InputCount);
+    }
+    BENCHMARK(Vector3_Madd);
+
+    void Vector3_ClampedLength(benchmark::State& state) {
+        const Inputs& in = inputs();
+        std::vector<Vector3> out(InputCount);
+        for (auto _ : state) {
+            for (size_t i = 0; i < InputCount; i++) {
+                out[i] = in.vectors[i].clampedLength(10.0f);
+            }
+            benchmark::DoNotOptimize(out.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * InputCount);
+    }
+    BENCHMARK(Vector3_ClampedLength);
+
+    // Matrix4
+
+    void Matrix4_Multiply(benchmark::State& state) {
+        const Inputs& in = inputs();
+        size_t i = 0;
+        for (auto _ : state) {
+            Matrix4 result = in.matrices[i & InputMask] * in.matrices[(i + 1) & InputMask];
+            benchmark::DoNotOptimize(result);
+            i++;
+        }
+    }
+    BENCHMARK(Matrix4_Multiply);
+
+    void Matrix4_MultiplyScalar(benchmark::State& state) {
+        const Inputs& in = inputs();
+        size_t i = 0;
+        for (auto _ : state) {
+            Matrix4 result = in.matrices[i & InputMask].multiplyScalar(in.matrices[(i + 1) & InputMask]);
+            benchmark::DoNotOptimize(result);
+            i++;
+        }
+    }
+    BENCHMARK(Matrix4_MultiplyScalar);
+
+    void Matrix4_TransformPoint(benchmark::State& state) {
+        const Inputs& in = inputs();
+        size_t i = 0;
+        for (auto _ : state) {
+            Vector3 result = in.affines[i & InputMask] * in.vectors[(i + 1) & InputMask];
+            benchmark::DoNotOptimize(result);
+            i++;
+        }
+    }
+    BENCHMARK(Matrix4_TransformPoint);
+
+    void Matrix4_Inverse(benchmark::State& state) {
+        const Inputs& in = inputs();
+        size_t i = 0;
+        for (auto _ : state) {
+            Matrix4 result = in.matrices[i & InputMask].inverse();
+            benchmark::DoNotOptimize(result);
+            i++;
+        }
+    }
+    BENCHMARK(Matrix4_Inverse);
+
+    void Matrix4_InverseScalar(benchmark::State& state) {
+        const Inputs& in = inputs();
+        size_t i = 0;
+        for (auto _ : state) {
+            Matrix4 result = in.matrices[i & InputMask].inverseScalar();
+            benchmark::DoNotOptimize(result);
+            i++;
+        }
+    }
+    BENCHMARK(Matrix4_InverseScalar);
+
+    void Matrix4_InverseAffine(benchmark::State& state) {
+        const Inputs& in = inputs();
+        size_t i = 0;
+        for (auto _ : state) {
+            Matrix4 result = in.affines[i & InputMask].inverseAffine();
+            benchmark::DoNotOptimize(result);
+            i++;
+        }
+    }
+    BENCHMARK(Matrix4_InverseAffine);
+
+    void Matrix4_InverseRigid(benchmark::State& state) {
+        const Inputs& in = inputs();
+        size_t i = 0;
+        for (auto _ : state) {
+            Matrix4 result = in.affines[i & InputMask].inverseRigid();
+            benchmark::DoNotOptimize(result);
+            i++;
+        }
+    }
+    BENCHMARK(Matrix4_InverseRigid);
+
+    void Matrix4_NormalMatrix(benchmark::State& state) {
+        const Inputs& in = inputs();
+        size_t i = 0;
+        for (auto _ : state) {
+            Matrix4 result = in.affines[i & InputMask].normalMatrix();
+            benchmark::DoNotOptimize(result);
+            i++;
+        }
+    }
+    BENCHMARK(Matrix4_NormalMatrix);
+
+    void Matrix4_LookAt(benchmark::State& state) {
+        const Inputs& in = inputs();
+        size_t i = 0;
+        for (auto _ : state) {
+            Matrix4 result = Matrix4::lookAt(in.vectors[i & InputMask], in.vectors[(i + 1) & InputMask], Vector3::up());
+            benchmark::DoNotOptimize(result);
+            i++;
+        }
+    }
+    BENCHMARK(Matrix4_LookAt);
+
+    void Matrix4_Perspective(benchmark::State& state) {
+        const Inputs& in = inputs();
+        size_t i = 0;
+        for (auto _ : state) {
+            float fov = 0.8f + in.angles[i & InputMask] * 0.1f;
+            Matrix4 result = Matrix4::perspective(fov, 16.0f / 9.0f, 0.1f, 1000.0f);
+            benchmark::DoNotOptimize(result);
+            i++;
+        }
+    }
+    BENCHMARK(Matrix4_Perspective);
+
+    // Quaternion
+
+    void Quaternion_Multiply(benchmark::State& state) {
+        const Inputs& in = inputs();
+        size_t i = 0;
+        for (auto _ : state) {
+            Quaternion result = in.rotations[i & InputMask] * in.rotations[(i + 1) & InputMask];
+            benchmark::DoNotOptimize(result);
+            i++;
+        }
+    }
+    BENCHMARK(Quaternion_Multiply);
+
+    void Quaternion_MultiplyScalar(benchmark::State& state) {
+        const Inputs& in = inputs();
+        size_t i = 0;
+        for (auto _ : state) {
+            Quaternion result = in.rotations[i & InputMask].multiplyScalar(in.rotations[(i + 1) & InputMask]);
+            benchmark::DoNotOptimize(result);
+            i++;
+        }
+    }
+    BENCHMARK(Quaternion_MultiplyScalar);
+
+    void Quaternion_Rotate(benchmark::State& state) {
+        const Inputs& in = inputs();
+        size_t i = 0;
+        for (auto _ : state) {
+            Vector3 result = in.rotations[i & InputMask] * in.vectors[(i + 1) & InputMask];
+            benchmark::DoNotOptimize(result);
+            i++;
+        }
+    }
+    BENCHMARK(Quaternion_Rotate);
+
+    void Quaternion_Slerp(benchmark::State& state) {
+        const Inputs& in = inputs();
+        size_t i = 0;
+        for (auto _ : state) {
+            float t = in.angles[i & InputMask] * 0.15f + 0.5f;
+            Quaternion result = Quaternion::slerp(in.rotations[i & InputMask], in.rotations[(i + 1) & InputMask], t);
+            benchmark::DoNotOptimize(result);
+            i++;
+        }
+    }
+    BENCHMARK(Quaternion_Slerp);
+
+    void Quaternion_ToMatrix4(benchmark::State& state) {
+        const Inputs& in = inputs();
+        size_t i = 0;
+        for (auto _ : state) {
+            Matrix4 result = in.rotations[i & InputMask].toMatrix4();
+            benchmark::DoNotOptimize(result);
+            i++;
+        }
+    }
+    BENCHMARK(Quaternion_ToMatrix4);
+
+    void Quaternion_FromAxisAngle(benchmark::State& state) {
+        const Inputs& in = inputs();
+        size_t i = 0;
+        for (auto _ : state) {
+            Quaternion result = Quaternion::fromAxisAngle(in.vectors[i & InputMask], in.angles[i & InputMask]);
+            benchmark::DoNotOptimize(result);
+            i++;
+        }
+    }
+    BENCHMARK(Quaternion_FromAxisAngle);
+
+    void Quaternion_FromAxisAngleFast(benchmark::State& state) {
+        const Inputs& in = inputs();
+        size_t i = 0;
+        for (auto _ : state) {
+            Quaternion result = Quaternion::fromAxisAngleFast(in.axes[i & InputMask], in.angles[i & InputMask]);
+            benchmark::DoNotOptimize(result);
+            i++;
+        }
+    }
+    BENCHMARK(Quaternion_FromAxisAngleFast);
+
+    // FastMath against the exact functions
+
+    void Trig_SinCos(benchmark::State& state) {
+        const Inputs& in = inputs();
+        size_t i = 0;
+        for (auto _ : state) {
+            float angle = in.angles[i & InputMask];
+            float s = std::sin(angle);
+            float c = std::cos(angle);
+            benchmark::DoNotOptimize(s);
+            benchmark::DoNotOptimize(c);
+            i++;
+        }
+    }
+    BENCHMARK(Trig_SinCos);
+
+    void Trig_SinCosFast(benchmark::State& state) {
+        const Inputs& in = inputs();
+        size_t i = 0;
+        for (auto _ : state) {
+            float s, c;
+            FastMath::sinCos(in.angles[i & InputMask], s, c);
+            benchmark::DoNotOptimize(s);
+            benchmark::DoNotOptimize(c);
+            i++;
+        }
+    }
+    BENCHMARK(Trig_SinCosFast);
+
+    void Trig_Atan(benchmark::State& state) {
+        const Inputs& in = inputs();
+        size_t i = 0;
+        for (auto _ : state) {
+            float result = std::atan(in.vectors[i & InputMask].x);
+            benchmark::DoNotOptimize(result);
+            i++;
+        }
+    }
+    BENCHMARK(Trig_Atan);
+
+    void Trig_AtanFast(benchmark::State& state) {
+        const Inputs& in = inputs();
+        size_t i = 0;
+        for (auto _ : state) {
+            float result = FastMath::atan(in.vectors[i & InputMask].x);
+            benchmark::DoNotOptimize(result);
+            i++;
+        }
+    }
+    BENCHMARK(Trig_AtanFast);
+
+    void Trig_Acos(benchmark::State& state) {
+        const Inputs& in = inputs();
+        size_t i = 0;
+        for (auto _ : state) {
+            float result = std::acos(in.cosines[i & InputMask]);
+            benchmark::DoNotOptimize(result);
+            i++;
+        }
+    }
+    BENCHMARK(Trig_Acos);
+
+    void Trig_AcosFast(benchmark::State& state) {
+        const Inputs& in = inputs();
+        size_t i = 0;
+        for (auto _ : state) {
+            float result = FastMath::acos(in.cosines[i & InputMask]);
+            benchmark::DoNotOptimize(result);
+            i++;
+        }
+    }
+    BENCHMARK(Trig_AcosFast);
+
+    void Sqrt_Rsqrt(benchmark::State& state) {
+        const Inputs& in = inputs();
+        size_t i = 0;
+        for (auto _ : state) {
+            float result = 1.0f / std::sqrt(in.positives[i & InputMask]);
+            benchmark::DoNotOptimize(result);
+            i++;
+        }
+    }
+    BENCHMARK(Sqrt_Rsqrt);
+
+    void Sqrt_RsqrtFast(benchmark::State& state) {
+        const Inputs& in = inputs();
+        size_t i = 0;
+        for (auto _ : state) {
+            float result = FastMath::rsqrt(in.positives[i & InputMask]);
+            benchmark::DoNotOptimize(result);
+            i++;
+        }
+    }
+    BENCHMARK(Sqrt_RsqrtFast);
+
+    // Batches: the same work one element at a time, then through each
+    // TransformBatch kernel
+
+    struct BatchInputs {
+        TransformBatch::Vector3Arrays points;
+        TransformBatch::Vector3Arrays scales;
+        TransformBatch::QuaternionArrays rotations;
+        std::vector<Vector3> pointList;
+        std::vector<Quaternion> rotationList;
+
+        explicit BatchInputs(size_t count) {
+            const Inputs& in = inputs();
+            for (size_t i = 0; i < count; i++) {
+                points.push_back(in.vectors[i & InputMask]);
+                scales.push_back(Vector3(1.0f, 1.0f, 1.0f) + in.vectors[(i + 7) & InputMask] * 0.01f);
+                rotations.push_back(in.rotations[i & InputMask]);
+                pointList.push_back(in.vectors[i & InputMask]);
+                rotationList.push_back(in.rotations[i & InputMask]);
+            }
+        }
+    };
+
+    void Batch_TransformPoints_Single(benchmark::State& state) {
+        BatchInputs batch((size_t)state.range(0));
+        std::vector<Vector3> out(batch.pointList.size());
+        const Matrix4& matrix = inputs().affines[0];
+        for (auto _ : state) {
+            for (size_t i = 0; i < out.size(); i++) {
+                out[i] = matrix * batch.pointList[i];
+            }
+            benchmark::DoNotOptimize(out.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    void Batch_RotateVectors_Single(benchmark::State& state) {
+        BatchInputs batch((size_t)state.range(0));
+        std::vector<Vector3> out(batch.pointList.size());
+        for (auto _ : state) {
+            for (size_t i = 0; i < out.size(); i++) {
+                out[i] = batch.rotationList[i] * batch.pointList[i];
+            }
+            benchmark::DoNotOptimize(out.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    void Batch_ComposeTransforms_Single(benchmark::State& state) {
+        BatchInputs batch((size_t)state.range(0));
+        std::vector<Matrix4> out(batch.pointList.size());
+        for (auto _ : state) {
+            for (size_t i = 0; i < out.size(); i++) {
+                out[i] = Matrix4::translation(batch.pointList[i]) * batch.rotationList[i].toMatrix4();
+            }
+            benchmark::DoNotOptimize(out.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    void Batch_TransformPoints(benchmark::State& state, TransformBatch::Kernel kernel) {
+        TransformBatch::setKernel(kernel);
+        BatchInputs batch((size_t)state.range(0));
+        TransformBatch::Vector3Arrays out;
+        const Matrix4& matrix = inputs().affines[0];
+        for (auto _ : state) {
+            TransformBatch::transformPoints(matrix, batch.points, out);
+            benchmark::DoNotOptimize(out.x.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    void Batch_RotateVectors(benchmark::State& state, TransformBatch::Kernel kernel) {
+        TransformBatch::setKernel(kernel);
+        BatchInputs batch((size_t)state.range(0));
+        TransformBatch::Vector3Arrays out;
+        for (auto _ : state) {
+            TransformBatch::rotateVectors(batch.rotations, batch.points, out);
+            benchmark::DoNotOptimize(out.x.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    void Batch_ComposeTransforms(benchmark::State& state, TransformBatch::Kernel kernel) {
+        TransformBatch::setKernel(kernel);
+        BatchInputs batch((size_t)state.range(0));
+        std::vector<Matrix4> out;
+        for (auto _ : state) {
+            TransformBatch::composeTransforms(batch.points, batch.rotations, out);
+            benchmark::DoNotOptimize(out.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    void Batch_ComposeScaledTransforms(benchmark::State& state, TransformBatch::Kernel kernel) {
+        TransformBatch::setKernel(kernel);
+        BatchInputs batch((size_t)state.range(0));
+        std::vector<Matrix4> out;
+        for (auto _ : state) {
+            TransformBatch::composeTransforms(batch.points, batch.rotations, batch.scales, out);
+            benchmark::DoNotOptimize(out.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    // Quantize: packing transform streams for history and replication
+
+    void Quantize_Halves_Single(benchmark::State& state) {
+        BatchInputs batch((size_t)state.range(0));
+        std::vector<Quantize::HalfVector3> out(batch.pointList.size());
+        for (auto _ : state) {
+            for (size_t i = 0; i < out.size(); i++) {
+                out[i] = Quantize::HalfVector3::encode(batch.pointList[i]);
+            }
+            benchmark::DoNotOptimize(out.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    void Quantize_Halves_Batch(benchmark::State& state) {
+        BatchInputs batch((size_t)state.range(0));
+        Quantize::Packed3Arrays out;
+        for (auto _ : state) {
+            Quantize::encodeHalves(batch.points, out);
+            benchmark::DoNotOptimize(out.x.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    void Quantize_Positions_Single(benchmark::State& state) {
+        BatchInputs batch((size_t)state.range(0));
+        const Quantize::PositionRange range(Vector3(-20.0f, -20.0f, -20.0f), Vector3(20.0f, 20.0f, 20.0f));
+        std::vector<Quantize::PackedPosition> out(batch.pointList.size());
+        for (auto _ : state) {
+            for (size_t i = 0; i < out.size(); i++) {
+                out[i] = range.encode(batch.pointList[i]);
+            }
+            benchmark::DoNotOptimize(out.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    void Quantize_Positions_Batch(benchmark::State& state) {
+        BatchInputs batch((size_t)state.range(0));
+        const Quantize::PositionRange range(Vector3(-20.0f, -20.0f, -20.0f), Vector3(20.0f, 20.0f, 20.0f));
+        Quantize::Packed3Arrays out;
+        for (auto _ : state) {
+            Quantize::encodePositions(range, batch.points, out);
+            benchmark::DoNotOptimize(out.x.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    void Quantize_Rotations(benchmark::State& state) {
+        BatchInputs batch((size_t)state.range(0));
+        std::vector<Quantize::PackedQuaternion> out;
+        for (auto _ : state) {
+            Quantize::encodeRotations(batch.rotations, out);
+            benchmark::DoNotOptimize(out.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+
+    // 64 is a small scene, 1024 fits L1/L2, 16384 spills to L3/memory
+    void batchSizes(benchmark::internal::Benchmark* benchmark) {
+        benchmark->Arg(64)->Arg(1024)->Arg(16384);
+    }
+
+    void registerBatchBenchmarks() {
+        batchSizes(benchmark::RegisterBenchmark("Batch_TransformPoints/Single", Batch_TransformPoints_Single));
+        batchSizes(benchmark::RegisterBenchmark("Batch_RotateVectors/Single", Batch_RotateVectors_Single));
+        batchSizes(benchmark::RegisterBenchmark("Batch_ComposeTransforms/Single", Batch_ComposeTransforms_Single));
+
+        batchSizes(benchmark::RegisterBenchmark("Quantize_Halves/Single", Quantize_Halves_Single));
+        batchSizes(benchmark::RegisterBenchmark("Quantize_Halves/Batch", Quantize_Halves_Batch));
+        batchSizes(benchmark::RegisterBenchmark("Quantize_Positions/Single", Quantize_Positions_Single));
+        batchSizes(benchmark::RegisterBenchmark("Quantize_Positions/Batch", Quantize_Positions_Batch));
+        batchSizes(benchmark::RegisterBenchmark("Quantize_Rotations", Quantize_Rotations));
+
+        // Only kernels this CPU can run, so the set of names (and so the
+        // baseline comparison) depends on the machine
+        const TransformBatch::Kernel kernels[] = {
+            TransformBatch::Kernel::Scalar,
+            TransformBatch::Kernel::SSE,
+            TransformBatch::Kernel::AVX2,
+            TransformBatch::Kernel::NEON
+        };
+        for (TransformBatch::Kernel kernel : kernels) {
+            if (!TransformBatch::isSupported(kernel)) continue;
+            std::string name = TransformBatch::getKernelName(kernel);
+            batchSizes(benchmark::RegisterBenchmark(("Batch_TransformPoints/" + name).c_str(), Batch_TransformPoints, kernel));
+            batchSizes(benchmark::RegisterBenchmark(("Batch_RotateVectors/" + name).c_str(), Batch_RotateVectors, kernel));
+            batchSizes(benchmark::RegisterBenchmark(("Batch_ComposeTransforms/" + name).c_str(), Batch_ComposeTransforms, kernel));
+            batchSizes(benchmark::RegisterBenchmark(("Batch_ComposeScaledTransforms/" + name).c_str(), Batch_ComposeScaledTransforms, kernel));
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    registerBatchBenchmarks();
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::AddCustomContext("transform_kernel", TransformBatch::getKernelName(TransformBatch::getKernel()));
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
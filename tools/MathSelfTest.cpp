@@ -0,0 +1,351 @@
+// Math library self-test.
+// Checks the Matrix4 inverses (the SSE inverse, inverseAffine,
+// inverseRigid and normalMatrix) on random, near-singular, affine and
+// rigid matrices. Each result is compared with a double-precision
+// inverse and must land within a bound that grows with the matrix's
+// condition number, as any float inverse's error does; inverseScalar is
+// held to the same bound, and on well-conditioned input the SSE inverse
+// must also match it closely. The FastMath approximations are swept
+// against double-precision results and held to the limits FastMath.h
+// documents. Exits non-zero on any failure.
+//
+// Usage:
+//   math_selftest [--count N] [--seed S]
+#include "Math/FastMath.h"
+#include "Math/Matrix4.h"
+#include "Math/Vector3.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+
+namespace {
+    // Error relative to the largest element of the exact inverse. Float
+    // inverses are off by up to a small multiple of cond * FLT_EPSILON;
+    // both 4x4 paths stay well under this many over 10^6 samples.
+    constexpr double Tolerance = 1e-5;
+    constexpr double ConditionFactor = 64.0;
+
+    // The SSE inverse against inverseScalar, below this condition number
+    constexpr double WellConditioned = 100.0;
+
+    // Past this cond * FLT_EPSILON a float inverse has under two digits
+    // left and the error bound stops being linear; such cases are skipped
+    constexpr double MaxConditionError = 1e-2;
+
+    // FastMath's documented maximum errors (see FastMath.h)
+    constexpr double SinCosLimit = 1e-7;     // Absolute, |x| <= SinCosRange
+    constexpr double AtanLimit = 2e-7;       // Absolute
+    constexpr double AcosLimit = 5e-7;       // Absolute, on [-1, 1]
+    constexpr double RsqrtLimit = 3e-7;      // Relative, x > 0
+    constexpr float SinCosRange = 1000.0f;
+
+    // Evenly spaced FastMath inputs per sweep, on top of the random ones
+    constexpr int SweepSteps = 1000000;
+
+    struct Check {
+        std::string name;
+        int cases;
+        int failures;
+        double worstError;
+    };
+
+    // Gauss-Jordan with partial pivoting; false if singular in double too
+    bool inverseDouble(const Matrix4& matrix, double result[16]) {
+        double a[4][8];
+        for (int i = 0; i < 4; i++) {
+            for (int j = 0; j < 4; j++) {
+                a[i][j] = matrix(i, j);
+                a[i][j + 4] = i == j ? 1.0 : 0.0;
+            }
+        }
+
+        for (int column = 0; column < 4; column++) {
+            int pivot = column;
+            for (int i = column + 1; i < 4; i++) {
+                if (std::fabs(a[i][column]) > std::fabs(a[pivot][column])) pivot = i;
+            }
+            if (a[pivot][column] == 0.0) return false;
+            std::swap(a[pivot], a[column]);
+
+            double scale = 1.0 / a[column][column];
+            for (int j = 0; j < 8; j++) a[column][j] *= scale;
+            for (int i = 0; i < 4; i++) {
+                if (i == column) continue;
+                double factor = a[i][column];
+                for (int j = 0; j < 8; j++) a[i][j] -= factor * a[column][j];
+            }
+        }
+
+        for (int i = 0; i < 4; i++) {
+            for (int j = 0; j < 4; j++) {
+                result[i * 4 + j] = a[i][j + 4];
+            }
+        }
+        return true;
+    }
+
+    // Max element difference over the exact inverse's largest element.
+    // 'rows' and 'columns' limit the comparison to the upper-left block.
+    double relativeError(const Matrix4& actual, const double expected[16], int rows = 4, int columns = 4) {
+        double difference = 0.0;
+        double magnitude = 0.0;
+        for (int i = 0; i < rows; i++) {
+            for (int j = 0; j < columns; j++) {
+                difference = std::max(difference, std::fabs(actual(i, j) - expected[i * 4 + j]));
+                magnitude = std::max(magnitude, std::fabs(expected[i * 4 + j]));
+            }
+        }
+        if (std::isnan(difference)) return INFINITY;
+        return magnitude > 0.0 ? difference / magnitude : difference;
+    }
+
+    // 1-norm condition number, from the exact inverse
+    double conditionNumber(const Matrix4& matrix, const double inverse[16]) {
+        double matrixNorm = 0.0;
+        double inverseNorm = 0.0;
+        for (int j = 0; j < 4; j++) {
+            double matrixColumn = 0.0;
+            double inverseColumn = 0.0;
+            for (int i = 0; i < 4; i++) {
+                matrixColumn += std::fabs(matrix(i, j));
+                inverseColumn += std::fabs(inverse[i * 4 + j]);
+            }
+            matrixNorm = std::max(matrixNorm, matrixColumn);
+            inverseNorm = std::max(inverseNorm, inverseColumn);
+        }
+        return matrixNorm * inverseNorm;
+    }
+
+    double errorLimit(double condition) {
+        return std::max(Tolerance, ConditionFactor * condition * FLT_EPSILON);
+    }
+
+    void record(Check& check, double error, double limit) {
+        check.cases++;
+        check.worstError = std::max(check.worstError, error);
+        if (!(error <= limit)) {
+            check.failures++;
+        }
+    }
+
+    void report(const Check& check) {
+        std::cout << "  " << (check.failures == 0 ? "PASS  " : "FAIL  ") << check.name << ": "
+                  << check.cases << " cases, worst error " << check.worstError;
+        if (check.failures > 0) {
+            std::cout << ", " << check.failures << " over tolerance";
+        }
+        std::cout << std::endl;
+    }
+
+    // Positive floats spread evenly over exponents, 2^-100 to 2^100
+    float randomPositive(std::mt19937& random) {
+        std::uniform_real_distribution<float> exponent(-100.0f, 100.0f);
+        return std::exp2(exponent(random));
+    }
+
+    void checkSinCos(Check& sinCheck, Check& cosCheck, float x) {
+        float s, c;
+        FastMath::sinCos(x, s, c);
+        double exactSin = std::sin((double)x);
+        double exactCos = std::cos((double)x);
+        record(sinCheck, std::fabs(s - exactSin), SinCosLimit);
+        record(cosCheck, std::fabs(c - exactCos), SinCosLimit);
+        record(sinCheck, std::fabs(FastMath::sin(x) - exactSin), SinCosLimit);
+        record(cosCheck, std::fabs(FastMath::cos(x) - exactCos), SinCosLimit);
+    }
+
+    void checkRsqrt(Check& rsqrtCheck, Check& sqrtCheck, float x) {
+        double exact = std::sqrt((double)x);
+        record(rsqrtCheck, std::fabs(FastMath::rsqrt(x) * exact - 1.0), RsqrtLimit);
+        record(sqrtCheck, std::fabs(FastMath::sqrt(x) / exact - 1.0), RsqrtLimit);
+    }
+
+    Matrix4 randomMatrix(std::mt19937& random) {
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+        Matrix4 matrix;
+        for (int i = 0; i < 16; i++) {
+            matrix.m[i] = unit(random);
+        }
+        return matrix;
+    }
+
+    Vector3 randomVector(std::mt19937& random, float scale) {
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+        return Vector3(unit(random), unit(random), unit(random)) * scale;
+    }
+
+    Matrix4 randomRigid(std::mt19937& random) {
+        std::uniform_real_distribution<float> angle(-3.14159265f, 3.14159265f);
+        Vector3 axis = randomVector(random, 1.0f);
+        if (axis.length() < 1e-3f) axis = Vector3::up();
+        return Matrix4::translation(randomVector(random, 100.0f)) * Matrix4::rotation(axis, angle(random));
+    }
+
+    // Rotation, non-uniform scale and a little shear, then translation
+    Matrix4 randomAffine(std::mt19937& random) {
+        std::uniform_real_distribution<float> scale(0.1f, 10.0f);
+        std::uniform_real_distribution<float> shear(-0.5f, 0.5f);
+        Matrix4 shearing;
+        shearing(0, 1) = shear(random);
+        shearing(1, 2) = shear(random);
+        return randomRigid(random) * shearing * Matrix4::scale(Vector3(scale(random), scale(random), scale(random)));
+    }
+}
+
+int main(int argc, char** argv) {
+    int count = 10000;
+    uint32_t seed = 12345;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--count" && i + 1 < argc) {
+            count = std::stoi(argv[++i]);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = (uint32_t)std::stoul(argv[++i]);
+        } else {
+            std::cerr << "Usage: math_selftest [--count N] [--seed S]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::uniform_int_distribution<int> exponent(2, 4);
+    int skipped = 0;
+
+    Check general = { "inverse, random", 0, 0, 0.0 };
+    Check generalScalar = { "inverseScalar, random", 0, 0, 0.0 };
+    Check nearSingular = { "inverse, near-singular", 0, 0, 0.0 };
+    Check nearSingularScalar = { "inverseScalar, near-singular", 0, 0, 0.0 };
+    Check matchesScalar = { "inverse vs inverseScalar, well-conditioned", 0, 0, 0.0 };
+    Check singular = { "inverse, singular (identity)", 0, 0, 0.0 };
+    Check affine = { "inverseAffine", 0, 0, 0.0 };
+    Check affineGeneral = { "inverse, affine", 0, 0, 0.0 };
+    Check rigid = { "inverseRigid", 0, 0, 0.0 };
+    Check normal = { "normalMatrix", 0, 0, 0.0 };
+
+    double exact[16];
+    for (int n = 0; n < count; n++) {
+        Matrix4 matrix = randomMatrix(random);
+        double condition = 0.0;
+        if (!inverseDouble(matrix, exact) || (condition = conditionNumber(matrix, exact)) * FLT_EPSILON > MaxConditionError) {
+            skipped++;
+        } else {
+            double limit = errorLimit(condition);
+            Matrix4 reference = matrix.inverseScalar();
+            record(general, relativeError(matrix.inverse(), exact), limit);
+            record(generalScalar, relativeError(reference, exact), limit);
+
+            if (condition < WellConditioned) {
+                double referenceValues[16];
+                std::copy(reference.m, reference.m + 16, referenceValues);
+                record(matchesScalar, relativeError(matrix.inverse(), referenceValues), Tolerance);
+            }
+        }
+
+        // Last row a sum of two others plus a perturbation of 1e-2 to 1e-4
+        Matrix4 almost = randomMatrix(random);
+        float epsilon = std::pow(10.0f, (float)-exponent(random));
+        for (int j = 0; j < 4; j++) {
+            almost(3, j) = almost(0, j) + almost(1, j) + epsilon * unit(random);
+        }
+        if (!inverseDouble(almost, exact) || (condition = conditionNumber(almost, exact)) * FLT_EPSILON > MaxConditionError) {
+            skipped++;
+        } else {
+            double limit = errorLimit(condition);
+            record(nearSingular, relativeError(almost.inverse(), exact), limit);
+            record(nearSingularScalar, relativeError(almost.inverseScalar(), exact), limit);
+        }
+
+        // A zero row gives an exact zero determinant on every path
+        Matrix4 flat = randomMatrix(random);
+        for (int j = 0; j < 4; j++) {
+            flat(n % 4, j) = 0.0f;
+        }
+        double identity[16] = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
+        record(singular, relativeError(flat.inverse(), identity), 0.0);
+
+        Matrix4 model = randomAffine(random);
+        if (inverseDouble(model, exact)) {
+            double limit = errorLimit(conditionNumber(model, exact));
+            record(affine, relativeError(model.inverseAffine(), exact), limit);
+            record(affineGeneral, relativeError(model.inverse(), exact), limit);
+
+            // The normal matrix is the transposed upper 3x3 of the inverse
+            double transposed[16];
+            for (int i = 0; i < 4; i++) {
+                for (int j = 0; j < 4; j++) {
+                    transposed[i * 4 + j] = exact[j * 4 + i];
+                }
+            }
+            record(normal, relativeError(model.normalMatrix(), transposed, 3, 3), limit);
+        }
+
+        Matrix4 view = randomRigid(random);
+        if (inverseDouble(view, exact)) {
+            record(rigid, relativeError(view.inverseRigid(), exact), errorLimit(conditionNumber(view, exact)));
+        }
+    }
+
+    // FastMath: an even sweep over each input range, then random inputs
+    Check sinCheck = { "FastMath::sin", 0, 0, 0.0 };
+    Check cosCheck = { "FastMath::cos", 0, 0, 0.0 };
+    Check atanCheck = { "FastMath::atan", 0, 0, 0.0 };
+    Check acosCheck = { "FastMath::acos", 0, 0, 0.0 };
+    Check rsqrtCheck = { "FastMath::rsqrt", 0, 0, 0.0 };
+    Check sqrtCheck = { "FastMath::sqrt", 0, 0, 0.0 };
+
+    std::uniform_real_distribution<float> angle(-SinCosRange, SinCosRange);
+    std::uniform_real_distribution<float> slope(-100.0f, 100.0f);
+    for (int i = 0; i <= SweepSteps; i++) {
+        float t = (float)i / SweepSteps;
+        checkSinCos(sinCheck, cosCheck, -SinCosRange + 2.0f * SinCosRange * t);
+        checkSinCos(sinCheck, cosCheck, angle(random));
+
+        float x = -1.0f + 2.0f * t;
+        record(acosCheck, std::fabs(FastMath::acos(x) - std::acos((double)x)), AcosLimit);
+
+        // Dense where the kernel ranges meet, then out to large slopes
+        float tangent = -10.0f + 20.0f * t;
+        record(atanCheck, std::fabs(FastMath::atan(tangent) - std::atan((double)tangent)), AtanLimit);
+        tangent = slope(random) * randomPositive(random);
+        record(atanCheck, std::fabs(FastMath::atan(tangent) - std::atan((double)tangent)), AtanLimit);
+
+        // Evenly over [1, 4), which covers both exponent parities
+        checkRsqrt(rsqrtCheck, sqrtCheck, 1.0f + 3.0f * t);
+        checkRsqrt(rsqrtCheck, sqrtCheck, randomPositive(random));
+    }
+    record(sqrtCheck, FastMath::sqrt(0.0f), 0.0);
+
+    std::cout << "Matrix4 self-test (seed " << seed << "; errors relative to the exact inverse, limit max("
+              << Tolerance << ", " << ConditionFactor << " * cond * FLT_EPSILON))" << std::endl;
+    const Check* checks[] = {
+        &general, &generalScalar, &matchesScalar, &nearSingular, &nearSingularScalar,
+        &singular, &affine, &affineGeneral, &rigid, &normal
+    };
+    int failures = 0;
+    for (const Check* check : checks) {
+        report(*check);
+        failures += check->failures;
+    }
+    std::cout << "  Skipped " << skipped << " general matrices with cond * FLT_EPSILON over "
+              << MaxConditionError << std::endl;
+
+    std::cout << "FastMath self-test (absolute error for sin, cos, atan and acos, relative for rsqrt and sqrt)"
+              << std::endl;
+    const Check* fastChecks[] = { &sinCheck, &cosCheck, &atanCheck, &acosCheck, &rsqrtCheck, &sqrtCheck };
+    for (const Check* check : fastChecks) {
+        report(*check);
+        failures += check->failures;
+    }
+
+    if (failures > 0) {
+        std::cout << failures << " cases failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,139 @@
+// Offline track compiler.
+// Builds a track from control points (or a preset) and writes the binary
+// format that Track::loadBinary maps at startup.
+//
+// Usage:
+//   TrackBuilder <points.txt | --circle R | --figure-eight R> <output.trk>
+//                [--width W] [--resolution N] [--banking B]
+//
+// points.txt holds one "x y z" control point per line; '#' starts a comment.
+#include "World/Track.h"
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+    void printUsage() {
+        std::cerr << "Usage: TrackBuilder <points.txt | --circle R | --figure-eight R> <output.trk>" << std::endl;
+        std::cerr << "                    [--width W] [--resolution N] [--banking B]" << std::endl;
+    }
+
+    bool readControlPoints(const std::string& path, std::vector<Vector3>& points) {
+        std::ifstream file(path);
+        if (!file) return false;
+
+        std::string line;
+        while (std::getline(file, line)) {
+            line = line.substr(0, line.find('#'));
+
+            std::istringstream stream(line);
+            float x, y, z;
+            if (stream >> x >> y >> z) {
+                points.push_back(Vector3(x, y, z));
+            }
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        printUsage();
+        return 1;
+    }
+
+    std::string source;
+    std::string output;
+    float presetRadius = 0.0f;
+    float width = 10.0f;
+    float banking = 0.0f;
+    int resolution = 1000;
+
+    // std::stof and std::stoi throw on values that aren't numbers or don't fit
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            bool hasValue = i + 1 < argc;
+
+            if ((arg == "--circle" || arg == "--figure-eight") && hasValue) {
+                source = arg;
+                presetRadius = std::stof(argv[++i]);
+            } else if (arg == "--width" && hasValue) {
+                width = std::stof(argv[++i]);
+            } else if (arg == "--resolution" && hasValue) {
+                resolution = std::stoi(argv[++i]);
+            } else if (arg == "--banking" && hasValue) {
+                banking = std::stof(argv[++i]);
+            } else if (source.empty()) {
+                source = arg;
+            } else if (output.empty()) {
+                output = arg;
+            } else {
+                printUsage();
+                return 1;
+            }
+        }
+    } catch (const std::logic_error&) {
+        printUsage();
+        return 1;
+    }
+
+    if (source.empty() || output.empty() || resolution < 2) {
+        printUsage();
+        return 1;
+    }
+
+    auto buildStart = std::chrono::steady_clock::now();
+
+    Track track;
+    if (source == "--circle") {
+        track.generateCircularTrack(presetRadius, width, resolution);
+    } else if (source == "--figure-eight") {
+        track.generateFigureEightTrack(presetRadius, width, resolution);
+    } else {
+        std::vector<Vector3> points;
+        if (!readControlPoints(source, points) || points.size() < 4) {
+            std::cerr << "Need at least 4 control points in " << source << std::endl;
+            return 1;
+        }
+        track.generateCustomTrack(points, width, resolution);
+    }
+
+    if (banking != 0.0f) {
+        track.setBankingAmount(banking);
+    }
+
+    auto buildEnd = std::chrono::steady_clock::now();
+
+    if (!track.saveBinary(output)) {
+        std::cerr << "Failed to write " << output << std::endl;
+        return 1;
+    }
+
+    // Round-trip through the loader so a bad file never ships
+    auto loadStart = std::chrono::steady_clock::now();
+    Track loaded;
+    bool ok = loaded.loadBinary(output);
+    auto loadEnd = std::chrono::steady_clock::now();
+
+    if (!ok || loaded.getTrackPoints().size() != track.getTrackPoints().size()) {
+        std::cerr << "Verification of " << output << " failed" << std::endl;
+        return 1;
+    }
+
+    std::chrono::duration<double, std::milli> buildTime = buildEnd - buildStart;
+    std::chrono::duration<double, std::milli> loadTime = loadEnd - loadStart;
+
+    std::cout << "Wrote " << output << std::endl;
+    std::cout << "  Length:       " << track.getTrackLength() << std::endl;
+    std::cout << "  Track points: " << track.getTrackPoints().size() << std::endl;
+    std::cout << "  Vertices:     " << track.getTrackVertices().size() << std::endl;
+    std::cout << "  Build time:   " << buildTime.count() << " ms" << std::endl;
+    std::cout << "  Load time:    " << loadTime.count() << " ms" << std::endl;
+
+    return 0;
+}
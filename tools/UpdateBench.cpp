@@ -0,0 +1,96 @@
+// Per-tick update loop microbenchmarks (Google Benchmark).
+// Runs the car physics step (PhysicsEngine over N cars on a flat ground
+// plane, no car-to-car collisions) and the combat player update (movement
+// then Player::update for N players on a shared timer wheel) the way the
+// game does each tick. The larger counts no longer fit in cache, so these
+// show what the Car and Player layouts cost (see tools/LayoutReport.cpp).
+//
+// Usage:
+//   update_bench [Google Benchmark flags]
+#include "Combat/Player.h"
+#include "Math/Quaternion.h"
+#include "Math/Vector3.h"
+#include "Physics/Car.h"
+#include "Physics/PhysicsEngine.h"
+#include "Utils/TimerWheel.h"
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    constexpr float TickTime = 1.0f / 60.0f;
+
+    // 64 is a small grid, 1024 fits L2, 16384 spills to L3/memory
+    void updateCounts(benchmark::internal::Benchmark* benchmark) {
+        benchmark->Arg(64)->Arg(1024)->Arg(16384);
+    }
+
+    void Car_Update(benchmark::State& state) {
+        std::mt19937 random(12345);
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+        // Separately allocated, as Game owns them
+        PhysicsEngine physics;
+        physics.setEnableCollisions(false);
+        std::vector<std::unique_ptr<Car>> cars;
+        for (int64_t i = 0; i < state.range(0); i++) {
+            cars.push_back(std::make_unique<Car>(Vector3(unit(random) * 500.0f, 0.0f, unit(random) * 500.0f)));
+            Car& car = *cars.back();
+            car.setRotation(Quaternion::fromAxisAngle(Vector3::up(), unit(random) * 3.14159265f));
+            car.setThrottle(0.5f + 0.5f * unit(random));
+            car.setSteer(0.3f * unit(random));
+            car.setBoost(i % 4 == 0);
+            physics.addCar(&car);
+        }
+
+        for (auto _ : state) {
+            physics.update(TickTime);
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+    BENCHMARK(Car_Update)->Apply(updateCounts);
+
+    void Player_Update(benchmark::State& state) {
+        std::mt19937 random(12345);
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+        // Attached to one wheel, as CombatManager does
+        TimerWheel timers;
+        std::vector<TimerWheel::FiredTimer> fired;
+        std::vector<std::unique_ptr<Player>> players;
+        std::vector<Vector3> inputs;
+        for (int64_t i = 0; i < state.range(0); i++) {
+            Vector3 start(unit(random) * 500.0f, 0.0f, unit(random) * 500.0f);
+            players.push_back(std::make_unique<Player>((int)i, "Player " + std::to_string(i), start));
+            players.back()->setTimerWheel(&timers);
+            inputs.push_back(Vector3(unit(random), unit(random), 0.0f));
+        }
+
+        const Vector3 cameraForward = Vector3::forward();
+        const Vector3 cameraRight = Vector3::right();
+        for (auto _ : state) {
+            fired.clear();
+            timers.advance(TickTime, fired);
+            for (size_t i = 0; i < players.size(); i++) {
+                players[i]->updateMovement(TickTime, inputs[i], cameraForward, cameraRight);
+                players[i]->update(TickTime);
+            }
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+    }
+    BENCHMARK(Player_Update)->Apply(updateCounts);
+}
+
+int main(int argc, char** argv) {
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,83 @@
+#!/usr/bin/env python3
+"""Compare a Google Benchmark JSON run against a stored baseline.
+
+Usage:
+    bench_compare.py BASELINE.json CURRENT.json [--threshold 0.15]
+
+Benchmarks are matched by name. When the runs were repeated, the median
+aggregate is compared; otherwise the single iteration result. Exits with
+status 1 if any benchmark got slower than the baseline by more than the
+threshold (a fraction: 0.15 is 15%), so it can gate a build.
+
+To refresh the baseline after an intended change, copy the new JSON over
+the baseline file. Baselines are only comparable on the same machine.
+"""
+import argparse
+import json
+import sys
+
+UNIT_SCALE = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+def load(path):
+    with open(path) as f:
+        data = json.load(f)
+
+    medians = {}
+    singles = {}
+    for entry in data.get("benchmarks", []):
+        if entry.get("error_occurred"):
+            continue
+        nanoseconds = entry["real_time"] * UNIT_SCALE.get(entry.get("time_unit", "ns"), 1.0)
+        if entry.get("run_type") == "aggregate":
+            if entry.get("aggregate_name") == "median":
+                medians[entry["run_name"]] = nanoseconds
+        else:
+            singles.setdefault(entry.get("run_name", entry["name"]), nanoseconds)
+
+    # Repeated runs without aggregates-only still list every repetition;
+    # the median wins when it is there
+    singles.update(medians)
+    return singles
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare benchmark results against a baseline")
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=0.15,
+                        help="allowed slowdown as a fraction (default 0.15)")
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    current = load(args.current)
+
+    regressions = []
+    width = max((len(name) for name in current), default=20)
+    print(f"{'Benchmark':<{width}}  {'Baseline':>12}  {'Current':>12}  {'Change':>8}")
+    for name, time in current.items():
+        if name not in baseline:
+            print(f"{name:<{width}}  {'-':>12}  {time:>10.2f}ns  {'new':>8}")
+            continue
+
+        before = baseline[name]
+        change = (time - before) / before if before > 0 else 0.0
+        flag = ""
+        if change > args.threshold:
+            regressions.append(name)
+            flag = "  REGRESSION"
+        print(f"{name:<{width}}  {before:>10.2f}ns  {time:>10.2f}ns  {change:>+7.1%}{flag}")
+
+    missing = [name for name in baseline if name not in current]
+    for name in missing:
+        print(f"{name:<{width}}  missing from current run")
+
+    if regressions:
+        print(f"\n{len(regressions)} benchmark(s) slower than baseline by more than {args.threshold:.0%}")
+        return 1
+    print(f"\nNo regressions beyond {args.threshold:.0%}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())